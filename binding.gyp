@@ -1,8 +1,11 @@
 {
+  "variables": {
+    "nvs_stats%": "true"
+  },
   "targets": [
     {
       "target_name": "vector_store",
-      "sources": ["src/binding.cc", "src/vector_store.cpp", "src/vector_store_loader.cpp", "src/vector_store_loader_mmap.cpp", "src/vector_store_loader_adaptive.cpp", "deps/simdjson.cpp"],
+      "sources": ["src/binding.cc", "src/vector_store.cpp", "src/vector_store_snapshot.cpp", "src/simd_kernels.cpp", "src/scalar_quantizer.cpp", "src/product_quantizer.cpp", "src/hnsw_index.cpp", "src/ivf_index.cpp", "src/text_index.cpp", "src/vector_store_loader.cpp", "deps/simdjson.cpp"],
       "include_dirs": [
         "<!@(node -p \"require('node-addon-api').include\")",
         "src",
@@ -12,11 +15,13 @@
       "cflags_cc": [
         "-std=c++17",
         "-O3",
-        "-march=native",
         "-fno-exceptions"
       ],
       "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
       "conditions": [
+        ["nvs_stats=='false'", {
+          "defines": ["NVS_NO_STATS"]
+        }],
         ["OS=='mac'", {
           "include_dirs": [
             "/opt/homebrew/opt/libomp/include",
@@ -2,7 +2,7 @@ export interface Document {
   id: string;
   text: string;
   metadata: {
-    embedding?: number[];
+    embedding?: number[] | Float32Array;
     [key: string]: any;
   };
 }
@@ -11,11 +11,213 @@ export interface SearchResult {
   score: number;
   id: string;
   text: string;
+  /** Metadata object as JSON, without the embedding */
   metadata_json: string;
 }
 
+export interface LeanSearchResults {
+  scores: Float32Array;
+  /** Document indices for getId(), getText() and getMetadata() */
+  indices: Uint32Array;
+}
+
+export interface LoadOptions {
+  /** How files are read (default: 'adaptive' - mmap small files, pread large ones) */
+  method?: 'adaptive' | 'mmap' | 'standard';
+  /** Files read concurrently (default: 4) */
+  ioThreads?: number;
+  /** JSON parser threads (default: hardware concurrency) */
+  parseThreads?: number;
+  /** Bytes of file data buffered ahead of the parsers (default: 256MB) */
+  bufferBudget?: number;
+}
+
+export interface VectorStoreOptions {
+  /**
+   * Compact codes scanned by search() (default: 'none')
+   * 'int8' uses 4x less memory per scan, 'fp16' 2x less, 'pq' m (or m / 2) bytes per row
+   */
+  quantization?: 'none' | 'int8' | 'fp16' | 'pq';
+  
+  /**
+   * Product quantization parameters, used with quantization: 'pq'
+   * (defaults: m dim/8, or dim/4 with 4-bit codes; bits 8; trainIterations 10).
+   * 4-bit codes use the shuffle-based fast-scan; raise rerankOversample with PQ.
+   */
+  pq?: {
+    m?: number;
+    bits?: 4 | 8;
+    trainIterations?: number;
+  };
+  
+  /**
+   * Quantized searches re-rank k * rerankOversample candidates with exact
+   * float scores; 0 returns approximate scores directly (default: 4)
+   */
+  rerankOversample?: number;
+  
+  /**
+   * Approximate index built by finalize() (default: 'flat', brute-force only)
+   */
+  index?: 'flat' | 'hnsw' | 'ivf';
+  
+  /**
+   * HNSW graph parameters (defaults: M 16, efConstruction 200, efSearch 64)
+   */
+  hnsw?: {
+    M?: number;
+    efConstruction?: number;
+    efSearch?: number;
+  };
+  
+  /**
+   * IVF parameters (defaults: nlist ~4*sqrt(n), nprobe 8, trainIterations 10)
+   * Combine with quantization: 'int8' for IVF-SQ8, 'pq' for IVF-PQ
+   */
+  ivf?: {
+    nlist?: number;
+    nprobe?: number;
+    trainIterations?: number;
+  };
+  
+  /**
+   * Stores with fewer documents are always scanned (default: 1000)
+   */
+  minIndexSize?: number;
+  
+  /**
+   * Scans over fewer rows always run on the calling thread (default: 32768)
+   */
+  parallelScanMinRows?: number;
+  
+  /**
+   * Documents added after finalize() are merged into the main segment in the
+   * background once this many are pending (default: 10000, 0 = only compact())
+   */
+  deltaCompactRows?: number;
+  
+  /**
+   * ...or once this fraction of the main segment's documents are pending, if
+   * that is more (default: 0.1). Each compaction rebuilds the whole index.
+   */
+  deltaCompactFraction?: number;
+  
+  /**
+   * addDocument() throws beyond this many documents (default: 2^32 - 1).
+   * Entry storage grows on demand either way.
+   */
+  maxDocuments?: number;
+  
+  /**
+   * Metadata fields extracted into compact columns as documents are added,
+   * so search() can filter on them inside the scan
+   */
+  filterFields?: string[];
+  
+  /**
+   * Tokenize each document's text as it is added and build a BM25 inverted
+   * index beside the vector index, for textSearch() and hybridSearch()
+   * (default: false)
+   */
+  textIndex?: boolean;
+  
+  /** BM25 parameters (defaults: k1 = 1.2, b = 0.75) */
+  bm25?: { k1?: number; b?: number };
+  
+  /**
+   * Shard the embedding rows across NUMA nodes (Linux): each shard's pages
+   * live on its node and parallel scans read them from threads pinned there.
+   * `true` uses every node; `nodes` lists them, one shard per entry;
+   * `pinThreads: false` leaves thread placement to the OpenMP runtime
+   * (default: false)
+   */
+  numa?: boolean | { nodes?: number[]; pinThreads?: boolean };
+  
+  /**
+   * LRU cache of search()/searchRange() results keyed by the exact query
+   * vector and options, split into `shards` independently locked parts
+   * (default: off; shards 16). Any insert, removal or compaction invalidates it.
+   */
+  queryCache?: { maxBytes: number; shards?: number };
+}
+
+/** Scalar metadata value: strings match decoded, numbers by value, each only its own type */
+export type FilterValue = string | number | boolean;
+
+/**
+ * Every listed field (each one of filterFields) must hold the value, or one
+ * of the values of an array
+ */
+export type SearchFilter = Record<string, FilterValue | FilterValue[]>;
+
+export interface SearchOptions {
+  /** HNSW candidate list size (default: hnsw.efSearch) */
+  ef?: number;
+  /** IVF lists to scan (default: ivf.nprobe) */
+  nprobe?: number;
+  /** Bypass the index and scan every document */
+  exact?: boolean;
+  /**
+   * 'auto' (default) runs large scans on all cores when no other search is in
+   * flight, and everything else on the calling thread
+   */
+  mode?: 'auto' | 'sequential' | 'parallel';
+  /** L2 normalize the query (default: true) */
+  normalize?: boolean;
+  /** Only documents matching the filter are scored */
+  filter?: SearchFilter;
+  /** Drop hits scoring below this; scans skip them before any top-k work */
+  minScore?: number;
+}
+
+export type FinalizeStage = 'compact' | 'quantize' | 'index' | 'done';
+
+/**
+ * Counters gathered since the store was created. Phase times are summed over
+ * the threads that ran them; parseMs includes the addMs of loader threads.
+ */
+export interface StoreStats {
+  /** False when the addon was built with nvs_stats=false (everything reads 0) */
+  enabled: boolean;
+  load: {
+    readMs: number;
+    parseMs: number;
+    addMs: number;
+    finalizeMs: number;
+    bytesRead: number;
+    filesRead: number;
+    documentsAdded: number;
+    documentsRejected: number;
+    /** Rejected documents by simdjson error message */
+    rejectedByError: Record<string, number>;
+  };
+  memory: {
+    arenaReservedBytes: number;
+    arenaUsedBytes: number;
+    queryCacheBytes: number;
+    queryCacheEntries: number;
+  };
+  search: {
+    /** search(), searchBatch() and textSearch() calls */
+    count: number;
+    totalMs: number;
+    /** Bucket i counts calls that took under 2^i microseconds (and at least 2^(i-1)) */
+    latencyHistogram: number[];
+    rowsScanned: number;
+    graphSearches: number;
+    parallelScans: number;
+    /** Searches that waited for compact() to swap segments, and for how long */
+    lockWaits: number;
+    lockWaitMs: number;
+    /** search()/searchRange() calls answered by, and missing, the query cache */
+    cacheHits: number;
+    cacheMisses: number;
+    ompThreads: number;
+  };
+}
+
 export class VectorStore {
-  constructor(dimensions: number);
+  constructor(dimensions: number, options?: VectorStoreOptions);
   
   /**
    * Load all JSON documents from a directory
@@ -24,17 +226,91 @@ export class VectorStore {
   loadDir(path: string): void;
   
   /**
-   * Add a single document
+   * Load a directory on the libuv thread pool and finalize the store.
+   * Resolves with the document count. Other loads, addDocument, finalize,
+   * save and openSnapshot throw until the promise settles.
+   */
+  loadDirAsync(path: string, options?: LoadOptions): Promise<number>;
+  
+  /**
+   * Add a single document. After finalize() it goes to the delta segment
+   * and is searchable immediately.
    */
   addDocument(doc: Document): void;
   
+  /**
+   * Add documents from a JSON array or NDJSON (one document per line), parsed
+   * natively on parseThreads threads (default: all cores). Does not finalize.
+   */
+  addDocuments(input: Buffer | string, options?: { parseThreads?: number }): { added: number; rejected: number };
+  
+  /**
+   * Add documents without metadata; row i of embeddings (ids.length x dimensions)
+   * belongs to ids[i]. Returns the number added.
+   */
+  addDocumentsBinary(ids: string[], texts: string[], embeddings: Float32Array): number;
+  
   /**
    * Search for k most similar documents
    * @param query - Query embedding vector
    * @param k - Number of results to return
-   * @param normalizeQuery - Whether to L2 normalize the query (default: true)
+   * @param options - Whether to L2 normalize the query (default: true), or search options
+   */
+  search(query: Float32Array, k: number, options?: boolean | SearchOptions): SearchResult[];
+  
+  /**
+   * Search several queries at once
+   * @param queries - nq query vectors stored back to back (nq * dimensions floats)
+   * @param nq - Number of queries
+   * @param k - Number of results per query
+   * @returns One result list per query, in query order
+   */
+  searchBatch(queries: Float32Array, nq: number, k: number, options?: SearchOptions): SearchResult[][];
+  
+  /**
+   * Every document scoring at least minScore, best first. Always scores the
+   * float embeddings (no HNSW walk, no quantized codes); IVF stores scan the
+   * probed lists unless `exact` is set.
+   * @param maxResults - Cap on the number of hits (default: 0, no cap)
+   */
+  searchRange(query: Float32Array, minScore: number, maxResults?: number,
+              options?: SearchOptions): SearchResult[];
+  
+  /**
+   * Same as search(), but runs on the libuv thread pool so concurrent
+   * requests are scanned side by side instead of blocking the event loop
+   */
+  searchAsync(query: Float32Array, k: number, options?: boolean | SearchOptions): Promise<SearchResult[]>;
+  
+  /**
+   * Same as search(), but returns only scores and document indices, so no
+   * strings are copied. Look up the fields you need per hit.
+   */
+  searchLean(query: Float32Array, k: number, options?: boolean | SearchOptions): LeanSearchResults;
+  
+  /**
+   * Top k documents by BM25 score of `text` against their text (requires
+   * textIndex; returns [] otherwise). Only `filter` applies from the options.
+   */
+  textSearch(text: string, k: number, options?: Pick<SearchOptions, 'filter'>): SearchResult[];
+  
+  /**
+   * Vector and BM25 search fused by reciprocal rank: score =
+   * alpha / (60 + vector rank) + (1 - alpha) / (60 + text rank), over the
+   * best max(4k, 100) hits of each
+   * @param alpha - Weight of the vector ranking, 0 to 1 (default: 0.5)
    */
-  search(query: Float32Array, k: number, normalizeQuery?: boolean): SearchResult[];
+  hybridSearch(query: Float32Array, text: string, k: number, alpha?: number,
+               options?: SearchOptions): SearchResult[];
+  
+  /** Id of the document at `index` (from searchLean) */
+  getId(index: number): string;
+  
+  /** Text of the document at `index` */
+  getText(index: number): string;
+  
+  /** Metadata JSON of the document at `index`, without the embedding */
+  getMetadata(index: number): string;
   
   /**
    * Normalize all stored embeddings
@@ -43,10 +319,71 @@ export class VectorStore {
   normalize(): void;
   
   /**
-   * Finalize the store: normalize embeddings and switch to serving mode
-   * After calling this, no more documents can be added
+   * Finalize the store: build the search matrix, codes and index on all
+   * cores and switch to serving mode. Documents added afterwards go to the
+   * delta segment. `progress` is called synchronously with each stage
+   * ('compact', 'quantize', 'index', then 'done').
    */
-  finalize(): void;
+  finalize(progress?: (stage: FinalizeStage, done: number, total: number) => void): void;
+  
+  /**
+   * Merge the delta segment into the main segment and rebuild its index on
+   * the thread pool. Searches keep running meanwhile.
+   */
+  compact(): Promise<void>;
+  
+  /**
+   * Documents added after finalize() and not yet compacted
+   */
+  deltaSize(): number;
+  
+  /**
+   * Remove the document with this id (finalized stores). Returns false if
+   * there is no such document.
+   */
+  remove(id: string): boolean;
+  
+  /**
+   * Add a document to a finalized store, replacing any document with the same id
+   */
+  upsert(doc: Document): void;
+  
+  /**
+   * O(1) lookup by id; null if there is no such document
+   */
+  getById(id: string): (Omit<SearchResult, 'score'> & { index: number }) | null;
+  
+  /**
+   * Write the finalized store to a binary snapshot file
+   * Embeddings are stored already normalized, so reopening skips parsing entirely
+   */
+  save(path: string): void;
+  
+  /**
+   * Open a snapshot written by save() into an empty store
+   * The file is memory-mapped and the store is finalized immediately
+   */
+  openSnapshot(path: string): void;
+  
+  /**
+   * Publish the finalized store under a name for other processes to attach()
+   * Backed by a snapshot in /dev/shm (or the temp directory); compact() first
+   * if documents were added or removed since finalize()
+   */
+  publish(name: string): void;
+  
+  /**
+   * Attach an empty store to a store published under this name
+   * The mapping is shared with every other attached process; throws if nothing
+   * is published or the published store lacks the index or codes these options need
+   */
+  attach(name: string): void;
+  
+  /**
+   * Delete a published store; already attached stores keep working
+   * Returns false if nothing was published under the name
+   */
+  static unpublish(name: string): boolean;
   
   /**
    * Check if the store has been finalized
@@ -54,7 +391,11 @@ export class VectorStore {
   isFinalized(): boolean;
   
   /**
-   * Get the number of documents in the store
+   * Get the number of documents in the store (removed ones included until
+   * the store is saved and reopened)
    */
   size(): number;
+  
+  /** Load, memory and search counters (see StoreStats) */
+  stats(): StoreStats;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <type_traits>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Owning, over-aligned array of trivially-copyable elements.
+// Allocation failure is reported by allocate() returning false (no exceptions).
+template <typename T>
+class AlignedArray {
+    static_assert(std::is_trivially_copyable<T>::value, "AlignedArray holds POD data only");
+
+public:
+    AlignedArray() = default;
+    ~AlignedArray() { reset(); }
+
+    // Disable copy, enable move
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+    AlignedArray(AlignedArray&& other) noexcept { *this = static_cast<AlignedArray&&>(other); }
+    AlignedArray& operator=(AlignedArray&& other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    // Allocate uninitialized storage for `count` elements, replacing any previous contents
+    bool allocate(size_t count, size_t align = 64) {
+        reset();
+        if (count == 0) {
+            return true;
+        }
+        if (count > SIZE_MAX / sizeof(T) - align) {
+            return false;  // Size overflow
+        }
+        size_t bytes = (count * sizeof(T) + align - 1) & ~(align - 1);
+
+        #ifdef _WIN32
+        data_ = static_cast<T*>(_aligned_malloc(bytes, align));
+        #else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, align, bytes) != 0) {
+            ptr = nullptr;
+        }
+        data_ = static_cast<T*>(ptr);
+        #endif
+
+        if (!data_) {
+            return false;
+        }
+        size_ = count;
+        return true;
+    }
+
+    void reset() {
+        if (data_) {
+            #ifdef _WIN32
+            _aligned_free(data_);
+            #else
+            std::free(data_);
+            #endif
+            data_ = nullptr;
+        }
+        size_ = 0;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,375 @@
+// Native benchmark suite: load throughput per loader, finalize time,
+// single-query and batched search latency / QPS across thread counts and k,
+// and recall@k of approximate configurations against brute force.
+//
+// Corpora are synthetic and fully determined by --n, --dim, --files and
+// --seed, so two runs on the same flags measure the same work. Results are
+// JSON Lines on stdout (one object per measurement, see README); progress
+// goes to stderr. Diff two runs with e.g. `jq -s` or a spreadsheet.
+//
+//   make bench && ./bench_vector_store --n 100000 --dim 384 --configs flat,hnsw,ivf-int8 > run.jsonl
+
+#include "vector_store.h"
+#include "vector_store_loader.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct BenchOptions {
+    size_t n = 20000;
+    size_t dim = 128;
+    size_t files = 8;              // Corpus JSON files (documents are sharded round robin)
+    size_t queries = 200;
+    size_t clusters = 0;           // 0 = sqrt(n)
+    uint32_t seed = 42;
+    size_t batch = 32;             // Queries per search_batch() call
+    std::vector<size_t> ks = {1, 10, 100};
+    std::vector<int> threads;      // Default: 1, 2, 4, ... up to the OpenMP maximum
+    std::vector<std::string> loaders = {"read", "mmap", "adaptive"};
+    std::vector<std::string> configs = {"flat", "hnsw", "ivf"};
+    std::string dir;               // Corpus directory; default under the temp directory
+    bool keep = false;             // Keep the corpus directory afterwards
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// One JSON object per line; fields are appended in order
+class Record {
+public:
+    explicit Record(const std::string& bench) { out_ << "{\"bench\":\"" << bench << '"'; }
+    Record& str(const char* key, const std::string& value) {
+        out_ << ",\"" << key << "\":\"" << value << '"';
+        return *this;
+    }
+    Record& num(const char* key, double value) {
+        out_ << ",\"" << key << "\":";
+        if (value == std::floor(value) && std::abs(value) < 1e15) {
+            out_ << static_cast<long long>(value);  // Counts and sizes stay exact
+        } else {
+            out_ << std::setprecision(6) << value;
+        }
+        return *this;
+    }
+    void emit() {
+        out_ << "}\n";
+        std::fputs(out_.str().c_str(), stdout);
+        std::fflush(stdout);
+    }
+
+private:
+    std::ostringstream out_;
+};
+
+// Gaussian clusters around random unit centers, normalized: approximate
+// indexes then face data with structure, like real embeddings
+class Corpus {
+public:
+    Corpus(const BenchOptions& options) : dim_(options.dim) {
+        std::mt19937 rng(options.seed);
+        std::normal_distribution<float> normal(0.0f, 1.0f);
+        const size_t clusters = options.clusters ? options.clusters
+                                                 : std::max<size_t>(1, size_t(std::sqrt(double(options.n))));
+        std::vector<float> centers(clusters * dim_);
+        for (float& c : centers) c = normal(rng);
+        for (size_t c = 0; c < clusters; ++c) kernels::normalize(centers.data() + c * dim_, dim_);
+
+        auto sample = [&](float* out) {
+            const float* center = centers.data() + (rng() % clusters) * dim_;
+            for (size_t d = 0; d < dim_; ++d) out[d] = center[d] + 0.35f * normal(rng) / std::sqrt(float(dim_));
+            kernels::normalize(out, dim_);
+        };
+        vectors_.resize(options.n * dim_);
+        for (size_t i = 0; i < options.n; ++i) sample(vectors_.data() + i * dim_);
+        queries_.resize(options.queries * dim_);
+        for (size_t q = 0; q < options.queries; ++q) sample(queries_.data() + q * dim_);
+    }
+
+    size_t size() const { return vectors_.size() / dim_; }
+    size_t num_queries() const { return queries_.size() / dim_; }
+    const float* vector(size_t i) const { return vectors_.data() + i * dim_; }
+    const float* query(size_t q) const { return queries_.data() + q * dim_; }
+
+    // Shard documents round robin into `files` JSON arrays under `dir`; returns total bytes
+    size_t write(const std::filesystem::path& dir, size_t files) const {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        files = std::max<size_t>(1, std::min(files, size()));
+        size_t bytes = 0;
+        char number[32];
+        for (size_t f = 0; f < files; ++f) {
+            const auto path = dir / ("shard-" + std::to_string(f) + ".json");
+            std::string json = "[";
+            for (size_t i = f; i < size(); i += files) {
+                if (json.size() > 1) json += ",\n";
+                json += "{\"id\":\"doc-" + std::to_string(i) + "\",\"text\":\"Synthetic document " +
+                        std::to_string(i) + "\",\"metadata\":{\"shard\":" + std::to_string(f) + ",\"embedding\":[";
+                for (size_t d = 0; d < dim_; ++d) {
+                    std::snprintf(number, sizeof(number), d ? ",%.6f" : "%.6f", vector(i)[d]);
+                    json += number;
+                }
+                json += "]}}";
+            }
+            json += "]";
+            std::ofstream(path, std::ios::binary).write(json.data(), json.size());
+            bytes += json.size();
+        }
+        return bytes;
+    }
+
+    // Exact top-k document numbers per query
+    std::vector<std::vector<size_t>> ground_truth(size_t k) const {
+        std::vector<std::vector<size_t>> truth(num_queries());
+        const kernels::DotFn dot = kernels::dot_for_dim(dim_);
+        #pragma omp parallel for schedule(dynamic)
+        for (int64_t q = 0; q < static_cast<int64_t>(num_queries()); ++q) {
+            TopK heap(k);
+            for (size_t i = 0; i < size(); ++i) heap.push(dot(vector(i), query(q), dim_), i);
+            std::sort(heap.heap.begin(), heap.heap.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+            for (const auto& hit : heap.heap) truth[q].push_back(hit.second);
+        }
+        return truth;
+    }
+
+private:
+    size_t dim_;
+    std::vector<float> vectors_;
+    std::vector<float> queries_;
+};
+
+bool parse_config(const std::string& name, VectorStoreOptions& options) {
+    // <index>[-<quantization>], e.g. flat, hnsw, ivf-int8, flat-fp16, ivf-pq, flat-pq4
+    std::string index = name.substr(0, name.find('-'));
+    std::string quantization = name.find('-') == std::string::npos ? "" : name.substr(name.find('-') + 1);
+    if (index == "flat") options.index = IndexType::Flat;
+    else if (index == "hnsw") options.index = IndexType::HNSW;
+    else if (index == "ivf") options.index = IndexType::IVF;
+    else return false;
+    if (quantization.empty() || quantization == "none") options.quantization = Quantization::None;
+    else if (quantization == "int8") options.quantization = Quantization::Int8;
+    else if (quantization == "fp16") options.quantization = Quantization::Fp16;
+    else if (quantization == "pq" || quantization == "pq4") {
+        options.quantization = Quantization::PQ;
+        options.pq.bits = quantization == "pq4" ? 4 : 8;
+    }
+    else return false;
+    return true;
+}
+
+size_t doc_number(const VectorStore& store, size_t idx) {
+    return std::strtoul(std::string(store.get_entry(idx).doc.id.substr(4)).c_str(), nullptr, 10);
+}
+
+void bench_loaders(const BenchOptions& options, const std::string& dir, size_t bytes) {
+    for (const std::string& loader : options.loaders) {
+        LoaderOptions loader_options;
+        if (loader == "read") loader_options.io = LoaderOptions::Io::Read;
+        else if (loader == "mmap") loader_options.io = LoaderOptions::Io::MMap;
+        else if (loader == "adaptive") loader_options.io = LoaderOptions::Io::Adaptive;
+        else {
+            std::fprintf(stderr, "Unknown loader %s\n", loader.c_str());
+            continue;
+        }
+        VectorStore store(options.dim);
+        auto start = std::chrono::steady_clock::now();
+        VectorStoreLoader::load(&store, dir, loader_options);
+        const double total = seconds_since(start);
+        const StoreStats stats = store.stats();
+        const double finalize = stats.finalize_ns / 1e9;
+        Record("load").str("loader", loader).num("n", store.size()).num("files", options.files)
+            .num("bytes", bytes).num("seconds", total).num("finalize_seconds", finalize)
+            .num("docs_per_second", store.size() / std::max(total - finalize, 1e-9))
+            .num("mb_per_second", bytes / 1e6 / std::max(total - finalize, 1e-9))
+            .num("rejected", stats.documents_rejected).emit();
+        std::fprintf(stderr, "load %-8s %.3fs (finalize %.3fs)\n", loader.c_str(), total, finalize);
+    }
+}
+
+void bench_config(const BenchOptions& options, const std::string& config, const Corpus& corpus,
+                  const std::string& dir) {
+    VectorStoreOptions store_options;
+    if (!parse_config(config, store_options)) {
+        std::fprintf(stderr, "Unknown config %s (want <flat|hnsw|ivf>[-<none|int8|fp16|pq|pq4>])\n", config.c_str());
+        return;
+    }
+    VectorStore store(options.dim, store_options);
+    VectorStoreLoader::load(&store, dir);
+    if (!store.is_finalized() || store.size() != corpus.size()) {
+        std::fprintf(stderr, "%s: load failed\n", config.c_str());
+        return;
+    }
+    Record("finalize").str("config", config).num("n", store.size())
+        .num("seconds", store.stats().finalize_ns / 1e9).emit();
+    const size_t nq = corpus.num_queries();
+
+    for (size_t k : options.ks) {
+        // Recall@k against the exact answer for the generated vectors
+        const auto truth = corpus.ground_truth(k);
+        double found = 0, wanted = 0;
+        for (size_t q = 0; q < nq; ++q) {
+            for (const auto& hit : store.search(corpus.query(q), k)) {
+                found += std::find(truth[q].begin(), truth[q].end(), doc_number(store, hit.second)) != truth[q].end();
+            }
+            wanted += truth[q].size();
+        }
+        Record("recall").str("config", config).num("k", k).num("recall", found / wanted).emit();
+
+        for (int threads : options.threads) {
+            omp_set_num_threads(threads);
+
+            // Single queries on an otherwise idle store: the scan may use a `threads` team
+            std::vector<double> latencies;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t q = 0; q < nq; ++q) {
+                auto query_start = std::chrono::steady_clock::now();
+                store.search(corpus.query(q), k);
+                latencies.push_back(seconds_since(query_start) * 1e6);
+            }
+            const double elapsed = seconds_since(start);
+            std::sort(latencies.begin(), latencies.end());
+            auto percentile = [&](double p) { return latencies[std::min(latencies.size() - 1, size_t(p * latencies.size()))]; };
+            Record("search").str("config", config).num("k", k).num("threads", threads)
+                .num("qps", nq / elapsed).num("p50_us", percentile(0.5)).num("p99_us", percentile(0.99)).emit();
+
+            // `threads` clients issuing queries concurrently, each on its own core
+            std::atomic<size_t> next{0};
+            start = std::chrono::steady_clock::now();
+            std::vector<std::thread> clients;
+            SearchOptions sequential;
+            sequential.mode = SearchMode::Sequential;
+            for (int t = 0; t < threads; ++t) {
+                clients.emplace_back([&]() {
+                    for (size_t q; (q = next.fetch_add(1)) < nq;) store.search(corpus.query(q), k, sequential);
+                });
+            }
+            for (auto& client : clients) client.join();
+            Record("concurrent").str("config", config).num("k", k).num("threads", threads)
+                .num("qps", nq / seconds_since(start)).emit();
+
+            // Batched queries
+            start = std::chrono::steady_clock::now();
+            for (size_t q = 0; q < nq; q += options.batch) {
+                store.search_batch(corpus.query(q), std::min(options.batch, nq - q), k);
+            }
+            Record("batch").str("config", config).num("k", k).num("threads", threads).num("batch", options.batch)
+                .num("qps", nq / seconds_since(start)).emit();
+        }
+        std::fprintf(stderr, "%-10s k=%-4zu recall %.3f\n", config.c_str(), k, found / wanted);
+    }
+    omp_set_num_threads(options.threads.back());
+}
+
+void usage() {
+    std::fprintf(stderr,
+        "Usage: bench_vector_store [options]\n"
+        "  --n N            documents (default 20000)\n"
+        "  --dim D          dimensions (default 128)\n"
+        "  --files F        corpus JSON files (default 8)\n"
+        "  --queries Q      queries per measurement (default 200)\n"
+        "  --clusters C     corpus clusters (default sqrt(n))\n"
+        "  --seed S         corpus seed (default 42)\n"
+        "  --k LIST         k values (default 1,10,100)\n"
+        "  --threads LIST   OpenMP / client thread counts (default 1,2,4,... up to the maximum)\n"
+        "  --batch B        queries per searchBatch call (default 32)\n"
+        "  --loaders LIST   read,mmap,adaptive (default all; empty to skip)\n"
+        "  --configs LIST   <flat|hnsw|ivf>[-<int8|fp16|pq|pq4>] (default flat,hnsw,ivf)\n"
+        "  --dir PATH       corpus directory (default: temp directory)\n"
+        "  --keep           keep the corpus directory\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                usage();
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        auto sizes = [&](const std::string& list) {
+            std::vector<size_t> out;
+            for (const auto& item : split(list)) out.push_back(std::strtoul(item.c_str(), nullptr, 10));
+            return out;
+        };
+        if (arg == "--n") options.n = std::strtoul(value().c_str(), nullptr, 10);
+        else if (arg == "--dim") options.dim = std::strtoul(value().c_str(), nullptr, 10);
+        else if (arg == "--files") options.files = std::strtoul(value().c_str(), nullptr, 10);
+        else if (arg == "--queries") options.queries = std::strtoul(value().c_str(), nullptr, 10);
+        else if (arg == "--clusters") options.clusters = std::strtoul(value().c_str(), nullptr, 10);
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::strtoul(value().c_str(), nullptr, 10));
+        else if (arg == "--batch") options.batch = std::max<size_t>(1, std::strtoul(value().c_str(), nullptr, 10));
+        else if (arg == "--k") options.ks = sizes(value());
+        else if (arg == "--threads") {
+            options.threads.clear();
+            for (size_t t : sizes(value())) options.threads.push_back(std::max(1, int(t)));
+        }
+        else if (arg == "--loaders") options.loaders = split(value());
+        else if (arg == "--configs") options.configs = split(value());
+        else if (arg == "--dir") options.dir = value();
+        else if (arg == "--keep") options.keep = true;
+        else {
+            usage();
+            return arg == "--help" ? 0 : 2;
+        }
+    }
+    if (options.n == 0 || options.dim == 0 || options.queries == 0 || options.ks.empty()) {
+        usage();
+        return 2;
+    }
+    if (options.threads.empty()) {
+        for (int t = 1; t < omp_get_max_threads(); t *= 2) options.threads.push_back(t);
+        options.threads.push_back(omp_get_max_threads());
+    }
+    const std::string dir = options.dir.empty()
+        ? (std::filesystem::temp_directory_path() / ("nvs_bench_" + std::to_string(options.n) + "x" +
+                                                      std::to_string(options.dim))).string()
+        : options.dir;
+
+    // Everything that identifies the run, for comparing outputs later
+    Record("run").num("n", options.n).num("dim", options.dim).num("files", options.files)
+        .num("queries", options.queries).num("seed", options.seed)
+        .num("max_threads", omp_get_max_threads()).num("hardware_threads", std::thread::hardware_concurrency())
+        .str("isa", kernels::isa_name(kernels::active_isa())).num("stats", STATS_ENABLED).emit();
+
+    auto start = std::chrono::steady_clock::now();
+    Corpus corpus(options);
+    const size_t bytes = corpus.write(dir, options.files);
+    std::fprintf(stderr, "corpus: %zu x %zu in %zu files (%.1f MB) in %.2fs\n", options.n, options.dim,
+                 options.files, bytes / 1e6, seconds_since(start));
+
+    bench_loaders(options, dir, bytes);
+    for (const std::string& config : options.configs) {
+        bench_config(options, config, corpus, dir);
+    }
+
+    if (!options.keep) {
+        std::filesystem::remove_all(dir);
+    }
+    return 0;
+}
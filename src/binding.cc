@@ -6,6 +6,16 @@
 class VectorStoreWrapper : public Napi::ObjectWrap<VectorStoreWrapper> {
     std::unique_ptr<VectorStore> store_;
     size_t dim_;
+    bool loading_ = false;  // loadDirAsync() in flight; only touched on the JS thread
+    
+    // Methods that add documents or change phase must not race a background load
+    bool ThrowIfLoading(const Napi::CallbackInfo& info) {
+        if (loading_) {
+            Napi::Error::New(info.Env(), "A directory load is in progress")
+                .ThrowAsJavaScriptException();
+        }
+        return loading_;
+    }
     
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports) {
@@ -13,12 +23,35 @@ public:
             InstanceMethod("loadDir", &VectorStoreWrapper::LoadDir),
             InstanceMethod("loadDirMMap", &VectorStoreWrapper::LoadDirMMap),
             InstanceMethod("loadDirAdaptive", &VectorStoreWrapper::LoadDirAdaptive),
+            InstanceMethod("loadDirAsync", &VectorStoreWrapper::LoadDirAsync),
             InstanceMethod("addDocument", &VectorStoreWrapper::AddDocument),
+            InstanceMethod("addDocuments", &VectorStoreWrapper::AddDocuments),
+            InstanceMethod("addDocumentsBinary", &VectorStoreWrapper::AddDocumentsBinary),
+            InstanceMethod("upsert", &VectorStoreWrapper::Upsert),
+            InstanceMethod("remove", &VectorStoreWrapper::Remove),
+            InstanceMethod("getById", &VectorStoreWrapper::GetById),
             InstanceMethod("search", &VectorStoreWrapper::Search),
+            InstanceMethod("searchAsync", &VectorStoreWrapper::SearchAsync),
+            InstanceMethod("searchBatch", &VectorStoreWrapper::SearchBatch),
+            InstanceMethod("searchLean", &VectorStoreWrapper::SearchLean),
+            InstanceMethod("searchRange", &VectorStoreWrapper::SearchRange),
+            InstanceMethod("textSearch", &VectorStoreWrapper::TextSearch),
+            InstanceMethod("hybridSearch", &VectorStoreWrapper::HybridSearch),
+            InstanceMethod("getId", &VectorStoreWrapper::GetId),
+            InstanceMethod("getText", &VectorStoreWrapper::GetText),
+            InstanceMethod("getMetadata", &VectorStoreWrapper::GetMetadata),
             InstanceMethod("normalize", &VectorStoreWrapper::Normalize),
             InstanceMethod("finalize", &VectorStoreWrapper::FinalizeStore),
+            InstanceMethod("compact", &VectorStoreWrapper::Compact),
+            InstanceMethod("deltaSize", &VectorStoreWrapper::DeltaSize),
             InstanceMethod("isFinalized", &VectorStoreWrapper::IsFinalized),
-            InstanceMethod("size", &VectorStoreWrapper::Size)
+            InstanceMethod("save", &VectorStoreWrapper::Save),
+            InstanceMethod("openSnapshot", &VectorStoreWrapper::OpenSnapshot),
+            InstanceMethod("publish", &VectorStoreWrapper::Publish),
+            InstanceMethod("attach", &VectorStoreWrapper::Attach),
+            StaticMethod("unpublish", &VectorStoreWrapper::Unpublish),
+            InstanceMethod("size", &VectorStoreWrapper::Size),
+            InstanceMethod("stats", &VectorStoreWrapper::Stats)
         });
         
         exports.Set("VectorStore", func);
@@ -28,111 +61,971 @@ public:
     VectorStoreWrapper(const Napi::CallbackInfo& info) 
         : Napi::ObjectWrap<VectorStoreWrapper>(info) {
         dim_ = info[0].As<Napi::Number>().Uint32Value();
-        store_ = std::make_unique<VectorStore>(dim_);
+        
+        // Optional second argument: { quantization, pq, rerankOversample, index, hnsw, ivf, minIndexSize,
+        // parallelScanMinRows, deltaCompactRows, deltaCompactFraction, maxDocuments, filterFields, textIndex,
+        // bm25, numa, queryCache }
+        VectorStoreOptions options;
+        if (info.Length() > 1 && info[1].IsObject()) {
+            Napi::Object opts = info[1].As<Napi::Object>();
+            
+            if (opts.Has("quantization")) {
+                std::string quantization = opts.Get("quantization").ToString().Utf8Value();
+                if (quantization == "none") {
+                    options.quantization = Quantization::None;
+                } else if (quantization == "int8") {
+                    options.quantization = Quantization::Int8;
+                } else if (quantization == "fp16") {
+                    options.quantization = Quantization::Fp16;
+                } else if (quantization == "pq") {
+                    options.quantization = Quantization::PQ;
+                } else {
+                    Napi::TypeError::New(info.Env(), "quantization must be 'none', 'int8', 'fp16' or 'pq'")
+                        .ThrowAsJavaScriptException();
+                    return;
+                }
+            }
+            
+            if (opts.Has("pq") && opts.Get("pq").IsObject()) {
+                Napi::Object pq = opts.Get("pq").As<Napi::Object>();
+                if (pq.Has("m")) {
+                    options.pq.m = pq.Get("m").ToNumber().Uint32Value();
+                }
+                if (pq.Has("bits")) {
+                    options.pq.bits = pq.Get("bits").ToNumber().Uint32Value();
+                    if (options.pq.bits != 4 && options.pq.bits != 8) {
+                        Napi::TypeError::New(info.Env(), "pq.bits must be 4 or 8")
+                            .ThrowAsJavaScriptException();
+                        return;
+                    }
+                }
+                if (pq.Has("trainIterations")) {
+                    options.pq.train_iterations = pq.Get("trainIterations").ToNumber().Uint32Value();
+                }
+            }
+            
+            if (opts.Has("index")) {
+                std::string index = opts.Get("index").ToString().Utf8Value();
+                if (index == "flat") {
+                    options.index = IndexType::Flat;
+                } else if (index == "hnsw") {
+                    options.index = IndexType::HNSW;
+                } else if (index == "ivf") {
+                    options.index = IndexType::IVF;
+                } else {
+                    Napi::TypeError::New(info.Env(), "index must be 'flat', 'hnsw' or 'ivf'")
+                        .ThrowAsJavaScriptException();
+                    return;
+                }
+            }
+            
+            if (opts.Has("hnsw") && opts.Get("hnsw").IsObject()) {
+                Napi::Object hnsw = opts.Get("hnsw").As<Napi::Object>();
+                if (hnsw.Has("M")) {
+                    options.hnsw.M = hnsw.Get("M").ToNumber().Uint32Value();
+                }
+                if (hnsw.Has("efConstruction")) {
+                    options.hnsw.ef_construction = hnsw.Get("efConstruction").ToNumber().Uint32Value();
+                }
+                if (hnsw.Has("efSearch")) {
+                    options.hnsw.ef_search = hnsw.Get("efSearch").ToNumber().Uint32Value();
+                }
+            }
+            
+            if (opts.Has("ivf") && opts.Get("ivf").IsObject()) {
+                Napi::Object ivf = opts.Get("ivf").As<Napi::Object>();
+                if (ivf.Has("nlist")) {
+                    options.ivf.nlist = ivf.Get("nlist").ToNumber().Uint32Value();
+                }
+                if (ivf.Has("nprobe")) {
+                    options.ivf.nprobe = ivf.Get("nprobe").ToNumber().Uint32Value();
+                }
+                if (ivf.Has("trainIterations")) {
+                    options.ivf.train_iterations = ivf.Get("trainIterations").ToNumber().Uint32Value();
+                }
+            }
+            
+            if (opts.Has("minIndexSize")) {
+                options.min_index_size = opts.Get("minIndexSize").ToNumber().Uint32Value();
+            }
+            
+            if (opts.Has("parallelScanMinRows")) {
+                options.parallel_scan_min_rows = opts.Get("parallelScanMinRows").ToNumber().Uint32Value();
+            }
+            
+            if (opts.Has("deltaCompactRows")) {
+                options.delta_compact_rows = opts.Get("deltaCompactRows").ToNumber().Uint32Value();
+            }
+            if (opts.Has("deltaCompactFraction")) {
+                options.delta_compact_fraction = opts.Get("deltaCompactFraction").ToNumber().DoubleValue();
+            }
+            
+            if (opts.Has("maxDocuments")) {
+                options.max_documents = static_cast<size_t>(opts.Get("maxDocuments").ToNumber().DoubleValue());
+            }
+            
+            if (opts.Has("filterFields")) {
+                Napi::Value value = opts.Get("filterFields");
+                if (!value.IsArray()) {
+                    Napi::TypeError::New(info.Env(), "filterFields must be an array of field names")
+                        .ThrowAsJavaScriptException();
+                    return;
+                }
+                Napi::Array fields = value.As<Napi::Array>();
+                for (uint32_t i = 0; i < fields.Length(); ++i) {
+                    options.filter_fields.push_back(fields.Get(i).ToString().Utf8Value());
+                }
+            }
+            
+            if (opts.Has("textIndex")) {
+                options.text_index = opts.Get("textIndex").ToBoolean();
+            }
+            
+            if (opts.Has("bm25") && opts.Get("bm25").IsObject()) {
+                Napi::Object bm25 = opts.Get("bm25").As<Napi::Object>();
+                if (bm25.Has("k1")) {
+                    options.bm25.k1 = bm25.Get("k1").ToNumber().FloatValue();
+                }
+                if (bm25.Has("b")) {
+                    options.bm25.b = bm25.Get("b").ToNumber().FloatValue();
+                }
+            }
+            
+            // numa: true shards across every node; { nodes, pinThreads } picks them
+            if (opts.Has("numa")) {
+                Napi::Value value = opts.Get("numa");
+                if (value.IsObject()) {
+                    Napi::Object numa = value.As<Napi::Object>();
+                    options.numa.shard = true;
+                    if (numa.Has("nodes")) {
+                        Napi::Value nodes = numa.Get("nodes");
+                        if (!nodes.IsArray()) {
+                            Napi::TypeError::New(info.Env(), "numa.nodes must be an array of node ids")
+                                .ThrowAsJavaScriptException();
+                            return;
+                        }
+                        Napi::Array list = nodes.As<Napi::Array>();
+                        for (uint32_t i = 0; i < list.Length(); ++i) {
+                            options.numa.nodes.push_back(list.Get(i).ToNumber().Int32Value());
+                        }
+                    }
+                    if (numa.Has("pinThreads")) {
+                        options.numa.pin_threads = numa.Get("pinThreads").ToBoolean();
+                    }
+                } else {
+                    options.numa.shard = value.ToBoolean();
+                }
+            }
+            
+            // queryCache: { maxBytes, shards }
+            if (opts.Has("queryCache")) {
+                Napi::Value value = opts.Get("queryCache");
+                if (!value.IsObject()) {
+                    Napi::TypeError::New(info.Env(), "queryCache must be an object")
+                        .ThrowAsJavaScriptException();
+                    return;
+                }
+                Napi::Object cache = value.As<Napi::Object>();
+                if (cache.Has("maxBytes")) {
+                    options.query_cache.max_bytes = static_cast<size_t>(cache.Get("maxBytes").ToNumber().Int64Value());
+                }
+                if (cache.Has("shards")) {
+                    options.query_cache.shards = cache.Get("shards").ToNumber().Uint32Value();
+                }
+            }
+            
+            if (opts.Has("rerankOversample")) {
+                Napi::Value value = opts.Get("rerankOversample");
+                if (!value.IsNumber() || value.As<Napi::Number>().DoubleValue() < 0) {
+                    Napi::TypeError::New(info.Env(), "rerankOversample must be a non-negative number")
+                        .ThrowAsJavaScriptException();
+                    return;
+                }
+                options.rerank_oversample = value.As<Napi::Number>().Uint32Value();
+            }
+        }
+        
+        store_ = std::make_unique<VectorStore>(dim_, options);
     }
     
     void LoadDir(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
         std::string path = info[0].As<Napi::String>();
         // Use adaptive loader as default for best performance
         VectorStoreLoader::loadDirectoryAdaptive(store_.get(), path);
     }
     
     void LoadDirMMap(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
         std::string path = info[0].As<Napi::String>();
         VectorStoreLoader::loadDirectoryMMap(store_.get(), path);
     }
     
     void LoadDirAdaptive(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
         std::string path = info[0].As<Napi::String>();
         VectorStoreLoader::loadDirectoryAdaptive(store_.get(), path);
     }
     
-    void AddDocument(const Napi::CallbackInfo& info) {
-        Napi::Object doc = info[0].As<Napi::Object>();
+    // Runs the directory loader (which finalizes the store) on the libuv thread pool
+    class LoadWorker : public Napi::AsyncWorker {
+    public:
+        LoadWorker(Napi::Env env, VectorStoreWrapper* wrapper, Napi::Object owner,
+                   std::string path, const LoaderOptions& options)
+            : Napi::AsyncWorker(env),
+              deferred_(Napi::Promise::Deferred::New(env)),
+              owner_(Napi::Persistent(owner)),
+              wrapper_(wrapper),
+              store_(wrapper->store_.get()),
+              path_(std::move(path)),
+              options_(options) {}
+        
+        Napi::Promise Promise() const { return deferred_.Promise(); }
+        
+        void Execute() override {
+            VectorStoreLoader::load(store_, path_, options_);
+        }
+        
+        void OnOK() override {
+            wrapper_->loading_ = false;
+            if (!store_->is_finalized()) {
+                deferred_.Reject(Napi::Error::New(Env(), "Load error: store was not finalized").Value());
+                return;
+            }
+            deferred_.Resolve(Napi::Number::New(Env(), store_->size()));
+        }
+        
+        void OnError(const Napi::Error& error) override {
+            wrapper_->loading_ = false;
+            deferred_.Reject(error.Value());
+        }
+        
+    private:
+        Napi::Promise::Deferred deferred_;
+        Napi::ObjectReference owner_;  // Keeps the wrapper alive until the worker finishes
+        VectorStoreWrapper* wrapper_;
+        VectorStore* store_;
+        std::string path_;
+        LoaderOptions options_;
+    };
+    
+    // loadDirAsync(path, { method, ioThreads, parseThreads, bufferBudget }) -> Promise<number>
+    Napi::Value LoadDirAsync(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (ThrowIfLoading(info)) return env.Undefined();
+        std::string path = info[0].As<Napi::String>();
         
-        // Convert JS object to JSON string
-        std::string json_str = "{";
-        json_str += "\"id\":\"" + doc.Get("id").As<Napi::String>().Utf8Value() + "\",";
-        json_str += "\"text\":\"" + doc.Get("text").As<Napi::String>().Utf8Value() + "\",";
-        json_str += "\"metadata\":{\"embedding\":[";
+        LoaderOptions options;
+        if (info.Length() > 1 && info[1].IsObject()) {
+            Napi::Object opts = info[1].As<Napi::Object>();
+            if (opts.Has("method")) {
+                std::string name = opts.Get("method").ToString().Utf8Value();
+                if (name == "adaptive") {
+                    options.io = LoaderOptions::Io::Adaptive;
+                } else if (name == "mmap") {
+                    options.io = LoaderOptions::Io::MMap;
+                } else if (name == "standard") {
+                    options.io = LoaderOptions::Io::Read;
+                } else {
+                    Napi::TypeError::New(env, "method must be 'adaptive', 'mmap' or 'standard'")
+                        .ThrowAsJavaScriptException();
+                    return env.Undefined();
+                }
+            }
+            if (opts.Has("ioThreads")) {
+                options.io_threads = opts.Get("ioThreads").As<Napi::Number>().Uint32Value();
+            }
+            if (opts.Has("parseThreads")) {
+                options.parse_threads = opts.Get("parseThreads").As<Napi::Number>().Uint32Value();
+            }
+            if (opts.Has("bufferBudget")) {
+                options.buffer_budget = static_cast<size_t>(opts.Get("bufferBudget").As<Napi::Number>().Int64Value());
+            }
+        }
         
-        // Get embedding from metadata
+        loading_ = true;
+        auto* worker = new LoadWorker(env, this, info.This().As<Napi::Object>(), std::move(path), options);
+        Napi::Promise promise = worker->Promise();
+        worker->Queue();  // Worker deletes itself after OnOK/OnError
+        return promise;
+    }
+    
+    void AddDocument(const Napi::CallbackInfo& info) {
+        InsertDocument(info, false);
+    }
+    
+    // upsert(doc): replaces the document with the same id (finalized stores only)
+    void Upsert(const Napi::CallbackInfo& info) {
+        InsertDocument(info, true);
+    }
+    
+    void InsertDocument(const Napi::CallbackInfo& info, bool replace) {
+        if (ThrowIfLoading(info)) return;
+        Napi::Env env = info.Env();
+        Napi::Object doc = info[0].As<Napi::Object>();
         Napi::Object metadata = doc.Get("metadata").As<Napi::Object>();
-        Napi::Array embedding = metadata.Get("embedding").As<Napi::Array>();
         
-        for (uint32_t i = 0; i < embedding.Length(); ++i) {
-            if (i > 0) json_str += ",";
-            json_str += std::to_string(embedding.Get(i).As<Napi::Number>().DoubleValue());
+        // The embedding is read as numbers (or straight from a Float32Array)
+        // instead of going through JSON text, which keeps full float precision
+        Napi::Value embedding_value = metadata.Get("embedding");
+        std::vector<float> embedding;
+        if (embedding_value.IsTypedArray() &&
+            embedding_value.As<Napi::TypedArray>().TypedArrayType() == napi_float32_array) {
+            Napi::Float32Array array = embedding_value.As<Napi::Float32Array>();
+            embedding.assign(array.Data(), array.Data() + array.ElementLength());
+        } else if (embedding_value.IsArray()) {
+            Napi::Array array = embedding_value.As<Napi::Array>();
+            embedding.resize(array.Length());
+            for (uint32_t i = 0; i < array.Length(); ++i) {
+                embedding[i] = array.Get(i).As<Napi::Number>().FloatValue();
+            }
+        }
+        if (embedding.size() != dim_) {
+            Napi::Error::New(env, std::string("Document add error: ") +
+                                  simdjson::error_message(simdjson::INCORRECT_TYPE))
+                .ThrowAsJavaScriptException();
+            return;
         }
-        json_str += "]}}";
+        
+        // Everything else is serialized by JSON.stringify, so strings are escaped
+        // and the other metadata fields are kept
+        Napi::Object rest = Napi::Object::New(env);
+        rest.Set("id", doc.Get("id"));
+        rest.Set("text", doc.Get("text"));
+        Napi::Object rest_metadata = Napi::Object::New(env);
+        Napi::Array keys = metadata.GetPropertyNames();
+        for (uint32_t i = 0; i < keys.Length(); ++i) {
+            std::string key = keys.Get(i).ToString().Utf8Value();
+            if (key != "embedding") rest_metadata.Set(key, metadata.Get(key));
+        }
+        rest.Set("metadata", rest_metadata);
+        Napi::Object json = env.Global().Get("JSON").As<Napi::Object>();
+        std::string json_str = json.Get("stringify").As<Napi::Function>().Call(json, {rest})
+                                   .As<Napi::String>().Utf8Value();
         
         // Parse and add
         simdjson::ondemand::parser parser;
         simdjson::padded_string padded(json_str);
         simdjson::ondemand::document json_doc;
+        simdjson::ondemand::object json_obj;
         auto parse_error = parser.iterate(padded).get(json_doc);
+        if (!parse_error) {
+            parse_error = json_doc.get_object().get(json_obj);
+        }
         if (parse_error) {
-            Napi::Error::New(info.Env(), 
+            Napi::Error::New(env, 
                 std::string("JSON parse error: ") + simdjson::error_message(parse_error))
                 .ThrowAsJavaScriptException();
             return;
         }
         
-        auto add_error = store_->add_document(json_doc);
+        auto add_error = replace ? store_->upsert(json_obj, embedding.data())
+                                 : store_->add_document(json_obj, embedding.data());
         if (add_error) {
-            Napi::Error::New(info.Env(), 
+            Napi::Error::New(env, 
                 std::string("Document add error: ") + simdjson::error_message(add_error))
                 .ThrowAsJavaScriptException();
             return;
         }
     }
     
-    Napi::Value Search(const Napi::CallbackInfo& info) {
+    // addDocuments(buffer: Buffer | string, { parseThreads }?) -> { added, rejected }
+    // A JSON array of documents or NDJSON, parsed natively on several threads
+    Napi::Value AddDocuments(const Napi::CallbackInfo& info) {
         Napi::Env env = info.Env();
-        Napi::Float32Array query_array = info[0].As<Napi::Float32Array>();
-        size_t k = info[1].As<Napi::Number>().Uint32Value();
+        if (ThrowIfLoading(info)) return env.Undefined();
         
-        // Normalize query if requested
-        bool normalize_query = info.Length() > 2 ? info[2].As<Napi::Boolean>() : true;
+        LoaderOptions options;
+        if (info.Length() > 1 && info[1].IsObject()) {
+            Napi::Object opts = info[1].As<Napi::Object>();
+            if (opts.Has("parseThreads")) {
+                options.parse_threads = opts.Get("parseThreads").As<Napi::Number>().Uint32Value();
+            }
+        }
         
-        std::vector<float> query(query_array.Data(), 
-                                 query_array.Data() + query_array.ElementLength());
+        BufferLoadResult result;
+        if (info[0].IsBuffer()) {
+            Napi::Buffer<char> buffer = info[0].As<Napi::Buffer<char>>();
+            result = VectorStoreLoader::addBuffer(store_.get(), buffer.Data(), buffer.Length(), options);
+        } else if (info[0].IsString()) {
+            std::string text = info[0].As<Napi::String>().Utf8Value();
+            result = VectorStoreLoader::addBuffer(store_.get(), text.data(), text.size(), options);
+        } else {
+            Napi::TypeError::New(env, "addDocuments expects a Buffer or a string")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
         
-        if (normalize_query) {
-            float sum = 0.0f;
-            for (float v : query) sum += v * v;
-            if (sum > 1e-10f) {
-                float inv_norm = 1.0f / std::sqrt(sum);
-                for (float& v : query) v *= inv_norm;
+        Napi::Object counts = Napi::Object::New(env);
+        counts.Set("added", Napi::Number::New(env, static_cast<double>(result.added)));
+        counts.Set("rejected", Napi::Number::New(env, static_cast<double>(result.rejected)));
+        return counts;
+    }
+    
+    // addDocumentsBinary(ids: string[], texts: string[], embeddings: Float32Array (n x dim)) -> number
+    Napi::Value AddDocumentsBinary(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (ThrowIfLoading(info)) return env.Undefined();
+        Napi::Array id_array = info[0].As<Napi::Array>();
+        Napi::Array text_array = info[1].As<Napi::Array>();
+        Napi::Float32Array embeddings = info[2].As<Napi::Float32Array>();
+        
+        const size_t n = id_array.Length();
+        if (text_array.Length() != n || embeddings.ElementLength() != n * dim_) {
+            Napi::RangeError::New(env, "addDocumentsBinary needs one text and dimensions floats per id")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        
+        // Strings are copied out of V8 here; the embedding block is read in place
+        std::vector<std::string> id_strings(n), text_strings(n);
+        std::vector<std::string_view> ids(n), texts(n);
+        for (size_t i = 0; i < n; ++i) {
+            id_strings[i] = id_array.Get(static_cast<uint32_t>(i)).ToString().Utf8Value();
+            text_strings[i] = text_array.Get(static_cast<uint32_t>(i)).ToString().Utf8Value();
+            ids[i] = id_strings[i];
+            texts[i] = text_strings[i];
+        }
+        
+        size_t added = store_->add_documents(ids.data(), texts.data(), embeddings.Data(), n);
+        return Napi::Number::New(env, static_cast<double>(added));
+    }
+    
+    // filter: { field: value | value[] }, values being strings, numbers or booleans
+    static bool ParseFilter(Napi::Env env, Napi::Value value, const VectorStore& store, SearchFilter& filter) {
+        if (!value.IsObject() || value.IsArray()) {
+            Napi::TypeError::New(env, "filter must be an object of { field: value | value[] }")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+        Napi::Object object = value.As<Napi::Object>();
+        Napi::Array fields = object.GetPropertyNames();
+        for (uint32_t i = 0; i < fields.Length(); ++i) {
+            SearchFilter::Clause clause;
+            clause.field = fields.Get(i).ToString().Utf8Value();
+            if (!store.is_filter_field(clause.field)) {
+                Napi::TypeError::New(env, "filter field '" + clause.field + "' is not in filterFields")
+                    .ThrowAsJavaScriptException();
+                return false;
             }
+            Napi::Value values = object.Get(clause.field);
+            auto add = [&](Napi::Value v) {
+                // Keyed by type, the way the store keys the decoded metadata values
+                if (v.IsString()) {
+                    clause.values.emplace_back(v.As<Napi::String>().Utf8Value());
+                } else if (v.IsNumber()) {
+                    clause.values.emplace_back(v.As<Napi::Number>().DoubleValue());
+                } else if (v.IsBoolean()) {
+                    clause.values.emplace_back(v.As<Napi::Boolean>().Value());
+                } else {
+                    Napi::TypeError::New(env, "filter values must be strings, numbers or booleans")
+                        .ThrowAsJavaScriptException();
+                    return false;
+                }
+                return true;
+            };
+            if (values.IsArray()) {
+                Napi::Array array = values.As<Napi::Array>();
+                for (uint32_t j = 0; j < array.Length(); ++j) {
+                    if (!add(array.Get(j))) return false;
+                }
+            } else if (!add(values)) {
+                return false;
+            }
+            filter.clauses.push_back(std::move(clause));
+        }
+        return true;
+    }
+    
+    // Search options object: { ef, nprobe, exact, mode, normalize, filter, minScore }
+    static bool ParseSearchOptions(Napi::Env env, Napi::Object opts, const VectorStore& store,
+                                   SearchOptions& search_options, bool& normalize_query) {
+        if (opts.Has("normalize")) {
+            normalize_query = opts.Get("normalize").ToBoolean();
+        }
+        if (opts.Has("ef")) {
+            search_options.ef = opts.Get("ef").ToNumber().Uint32Value();
+        }
+        if (opts.Has("nprobe")) {
+            search_options.nprobe = opts.Get("nprobe").ToNumber().Uint32Value();
         }
+        if (opts.Has("exact")) {
+            search_options.exact = opts.Get("exact").ToBoolean();
+        }
+        if (opts.Has("filter") && !ParseFilter(env, opts.Get("filter"), store, search_options.filter)) {
+            return false;
+        }
+        if (opts.Has("minScore")) {
+            Napi::Value value = opts.Get("minScore");
+            if (!value.IsNumber()) {
+                Napi::TypeError::New(env, "minScore must be a number").ThrowAsJavaScriptException();
+                return false;
+            }
+            search_options.min_score = value.As<Napi::Number>().FloatValue();
+        }
+        if (opts.Has("mode")) {
+            std::string mode = opts.Get("mode").ToString().Utf8Value();
+            if (mode == "auto") {
+                search_options.mode = SearchMode::Auto;
+            } else if (mode == "sequential") {
+                search_options.mode = SearchMode::Sequential;
+            } else if (mode == "parallel") {
+                search_options.mode = SearchMode::Parallel;
+            } else {
+                Napi::TypeError::New(env, "mode must be 'auto', 'sequential' or 'parallel'")
+                    .ThrowAsJavaScriptException();
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Shared by search() and searchAsync(): query, k and the optional third
+    // argument (normalizeQuery boolean, or a search options object)
+    static bool ParseSearchArgs(const Napi::CallbackInfo& info, const VectorStore& store,
+                                std::vector<float>& query, size_t& k, SearchOptions& search_options) {
+        Napi::Float32Array query_array = info[0].As<Napi::Float32Array>();
+        k = info[1].As<Napi::Number>().Uint32Value();
         
-        auto results = store_->search(query.data(), k);
+        bool normalize_query = true;
+        if (info.Length() > 2 && info[2].IsObject()) {
+            if (!ParseSearchOptions(info.Env(), info[2].As<Napi::Object>(), store, search_options,
+                                    normalize_query)) {
+                return false;
+            }
+        } else if (info.Length() > 2) {
+            normalize_query = info[2].ToBoolean();
+        }
         
+        query.assign(query_array.Data(), query_array.Data() + query_array.ElementLength());
+        
+        if (normalize_query) {
+            kernels::normalize(query.data(), query.size());
+        }
+        return true;
+    }
+    
+    // Copy straight from the arena view into V8, without an intermediate std::string
+    static Napi::String ToJsString(Napi::Env env, std::string_view value) {
+        return Napi::String::New(env, value.data(), value.size());
+    }
+    
+    static Napi::Array ToJsResults(Napi::Env env, const VectorStore& store,
+                                   const std::vector<std::pair<float, size_t>>& results) {
         Napi::Array output = Napi::Array::New(env, results.size());
         for (size_t i = 0; i < results.size(); ++i) {
-            const auto& entry = store_->get_entry(results[i].second);
+            const auto& entry = store.get_entry(results[i].second);
             
             Napi::Object result = Napi::Object::New(env);
             result.Set("score", results[i].first);
-            result.Set("id", std::string(entry.doc.id));
-            result.Set("text", std::string(entry.doc.text));
-            
-            // For now, return metadata as JSON string
-            result.Set("metadata_json", std::string(entry.doc.metadata_json));
+            result.Set("id", ToJsString(env, entry.doc.id));
+            result.Set("text", ToJsString(env, entry.doc.text));
+            result.Set("metadata_json", ToJsString(env, entry.doc.metadata_json));
             
             output[i] = result;
         }
+        return output;
+    }
+    
+    Napi::Value Search(const Napi::CallbackInfo& info) {
+        std::vector<float> query;
+        size_t k = 0;
+        SearchOptions search_options;
+        if (!ParseSearchArgs(info, *store_, query, k, search_options)) {
+            return info.Env().Undefined();
+        }
+        
+        auto results = store_->search(query.data(), k, search_options);
+        return ToJsResults(info.Env(), *store_, results);
+    }
+    
+    // textSearch(text, k, { filter }?) -> SearchResult[] scored by BM25
+    Napi::Value TextSearch(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string text = info[0].ToString().Utf8Value();
+        size_t k = info[1].As<Napi::Number>().Uint32Value();
+        
+        SearchOptions search_options;
+        bool normalize_query = true;
+        if (info.Length() > 2 && info[2].IsObject() &&
+            !ParseSearchOptions(env, info[2].As<Napi::Object>(), *store_, search_options, normalize_query)) {
+            return env.Undefined();
+        }
+        
+        auto results = store_->text_search(text, k, search_options);
+        return ToJsResults(env, *store_, results);
+    }
+    
+    // hybridSearch(query, text, k, alpha = 0.5, options?) -> SearchResult[] scored by
+    // reciprocal rank fusion of the vector and BM25 rankings
+    Napi::Value HybridSearch(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        Napi::Float32Array query_array = info[0].As<Napi::Float32Array>();
+        std::string text = info[1].ToString().Utf8Value();
+        size_t k = info[2].As<Napi::Number>().Uint32Value();
+        
+        float alpha = 0.5f;
+        if (info.Length() > 3 && !info[3].IsUndefined()) {
+            if (!info[3].IsNumber() || info[3].As<Napi::Number>().FloatValue() < 0 ||
+                info[3].As<Napi::Number>().FloatValue() > 1) {
+                Napi::RangeError::New(env, "alpha must be a number between 0 and 1")
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            alpha = info[3].As<Napi::Number>().FloatValue();
+        }
+        
+        SearchOptions search_options;
+        bool normalize_query = true;
+        if (info.Length() > 4 && info[4].IsObject() &&
+            !ParseSearchOptions(env, info[4].As<Napi::Object>(), *store_, search_options, normalize_query)) {
+            return env.Undefined();
+        }
+        
+        std::vector<float> query(query_array.Data(), query_array.Data() + query_array.ElementLength());
+        if (normalize_query) {
+            kernels::normalize(query.data(), query.size());
+        }
+        
+        auto results = store_->hybrid_search(query.data(), text, k, alpha, search_options);
+        return ToJsResults(env, *store_, results);
+    }
+    
+    // searchLean(query, k, options?) -> { scores: Float32Array, indices: Uint32Array }
+    // No strings are marshalled; fetch them per hit with getId/getText/getMetadata.
+    Napi::Value SearchLean(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::vector<float> query;
+        size_t k = 0;
+        SearchOptions search_options;
+        if (!ParseSearchArgs(info, *store_, query, k, search_options)) {
+            return env.Undefined();
+        }
+        
+        auto results = store_->search(query.data(), k, search_options);
+        Napi::Float32Array scores = Napi::Float32Array::New(env, results.size());
+        Napi::Uint32Array indices = Napi::Uint32Array::New(env, results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            scores[i] = results[i].first;
+            indices[i] = static_cast<uint32_t>(results[i].second);
+        }
+        
+        Napi::Object output = Napi::Object::New(env);
+        output.Set("scores", scores);
+        output.Set("indices", indices);
+        return output;
+    }
+    
+    // searchRange(query, minScore, maxResults = 0, options?) -> SearchResult[]
+    // with every document scoring at least minScore, best first
+    Napi::Value SearchRange(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        Napi::Float32Array query_array = info[0].As<Napi::Float32Array>();
+        if (info.Length() < 2 || !info[1].IsNumber()) {
+            Napi::TypeError::New(env, "minScore must be a number").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        float min_score = info[1].As<Napi::Number>().FloatValue();
+        
+        size_t max_results = 0;
+        if (info.Length() > 2 && !info[2].IsUndefined()) {
+            if (!info[2].IsNumber() || info[2].As<Napi::Number>().DoubleValue() < 0) {
+                Napi::RangeError::New(env, "maxResults must be a non-negative number")
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            max_results = info[2].As<Napi::Number>().Uint32Value();
+        }
+        
+        SearchOptions search_options;
+        bool normalize_query = true;
+        if (info.Length() > 3 && info[3].IsObject() &&
+            !ParseSearchOptions(env, info[3].As<Napi::Object>(), *store_, search_options, normalize_query)) {
+            return env.Undefined();
+        }
+        
+        std::vector<float> query(query_array.Data(), query_array.Data() + query_array.ElementLength());
+        if (normalize_query) {
+            kernels::normalize(query.data(), query.size());
+        }
         
+        auto results = store_->search_range(query.data(), min_score, max_results, search_options);
+        return ToJsResults(env, *store_, results);
+    }
+    
+    // Validates a document index argument from searchLean()
+    bool ParseEntryIndex(const Napi::CallbackInfo& info, size_t& idx) {
+        if (info.Length() < 1 || !info[0].IsNumber()) {
+            Napi::TypeError::New(info.Env(), "Expected a document index").ThrowAsJavaScriptException();
+            return false;
+        }
+        int64_t value = info[0].As<Napi::Number>().Int64Value();
+        if (!store_->is_finalized() || value < 0 || static_cast<size_t>(value) >= store_->size()) {
+            Napi::RangeError::New(info.Env(), "Document index out of range").ThrowAsJavaScriptException();
+            return false;
+        }
+        idx = static_cast<size_t>(value);
+        return true;
+    }
+    
+    Napi::Value GetId(const Napi::CallbackInfo& info) {
+        size_t idx;
+        if (!ParseEntryIndex(info, idx)) return info.Env().Undefined();
+        return ToJsString(info.Env(), store_->get_entry(idx).doc.id);
+    }
+    
+    Napi::Value GetText(const Napi::CallbackInfo& info) {
+        size_t idx;
+        if (!ParseEntryIndex(info, idx)) return info.Env().Undefined();
+        return ToJsString(info.Env(), store_->get_entry(idx).doc.text);
+    }
+    
+    // Metadata as a JSON string (the embedding is not included)
+    Napi::Value GetMetadata(const Napi::CallbackInfo& info) {
+        size_t idx;
+        if (!ParseEntryIndex(info, idx)) return info.Env().Undefined();
+        return ToJsString(info.Env(), store_->get_entry(idx).doc.metadata_json);
+    }
+    
+    // getById(id) -> { index, id, text, metadata_json } | null
+    Napi::Value GetById(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        std::string id = info[0].As<Napi::String>();
+        size_t idx = store_->index_of(id);
+        if (idx == SIZE_MAX) return env.Null();
+        
+        const auto& entry = store_->get_entry(idx);
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("index", Napi::Number::New(env, static_cast<double>(idx)));
+        result.Set("id", ToJsString(env, entry.doc.id));
+        result.Set("text", ToJsString(env, entry.doc.text));
+        result.Set("metadata_json", ToJsString(env, entry.doc.metadata_json));
+        return result;
+    }
+    
+    // remove(id) -> whether a live document was removed
+    Napi::Value Remove(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (ThrowIfLoading(info)) return env.Undefined();
+        std::string id = info[0].As<Napi::String>();
+        return Napi::Boolean::New(env, store_->remove(id));
+    }
+    
+    // searchBatch(queries: Float32Array (nq x dim), nq, k, options?) -> SearchResult[][]
+    Napi::Value SearchBatch(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        Napi::Float32Array query_array = info[0].As<Napi::Float32Array>();
+        size_t nq = info[1].As<Napi::Number>().Uint32Value();
+        size_t k = info[2].As<Napi::Number>().Uint32Value();
+        
+        if (query_array.ElementLength() != nq * dim_) {
+            Napi::RangeError::New(env, "queries must hold nq * dimensions floats")
+                .ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        
+        bool normalize_query = true;
+        SearchOptions search_options;
+        if (info.Length() > 3 && info[3].IsObject() &&
+            !ParseSearchOptions(env, info[3].As<Napi::Object>(), *store_, search_options, normalize_query)) {
+            return env.Undefined();
+        }
+        
+        std::vector<float> queries(query_array.Data(), query_array.Data() + nq * dim_);
+        if (normalize_query) {
+            for (size_t q = 0; q < nq; ++q) {
+                kernels::normalize(queries.data() + q * dim_, dim_);
+            }
+        }
+        
+        auto batches = store_->search_batch(queries.data(), nq, k, search_options);
+        
+        Napi::Array output = Napi::Array::New(env, batches.size());
+        for (size_t q = 0; q < batches.size(); ++q) {
+            output[q] = ToJsResults(env, *store_, batches[q]);
+        }
         return output;
     }
     
+    // Runs the search on the libuv thread pool so concurrent requests scan in
+    // parallel instead of queueing on the JS thread
+    class SearchWorker : public Napi::AsyncWorker {
+    public:
+        SearchWorker(Napi::Env env, Napi::Object owner, const VectorStore& store,
+                     std::vector<float> query, size_t k, const SearchOptions& search_options)
+            : Napi::AsyncWorker(env),
+              deferred_(Napi::Promise::Deferred::New(env)),
+              owner_(Napi::Persistent(owner)),
+              store_(store),
+              query_(std::move(query)),
+              k_(k),
+              search_options_(search_options) {}
+        
+        Napi::Promise Promise() const { return deferred_.Promise(); }
+        
+        void Execute() override {
+            results_ = store_.search(query_.data(), k_, search_options_);
+        }
+        
+        void OnOK() override {
+            deferred_.Resolve(ToJsResults(Env(), store_, results_));
+        }
+        
+        void OnError(const Napi::Error& error) override {
+            deferred_.Reject(error.Value());
+        }
+        
+    private:
+        Napi::Promise::Deferred deferred_;
+        Napi::ObjectReference owner_;  // Keeps the store alive until the worker finishes
+        const VectorStore& store_;
+        std::vector<float> query_;
+        size_t k_;
+        SearchOptions search_options_;
+        std::vector<std::pair<float, size_t>> results_;
+    };
+    
+    Napi::Value SearchAsync(const Napi::CallbackInfo& info) {
+        std::vector<float> query;
+        size_t k = 0;
+        SearchOptions search_options;
+        if (!ParseSearchArgs(info, *store_, query, k, search_options)) {
+            return info.Env().Undefined();
+        }
+        
+        auto* worker = new SearchWorker(info.Env(), info.This().As<Napi::Object>(), *store_,
+                                        std::move(query), k, search_options);
+        Napi::Promise promise = worker->Promise();
+        worker->Queue();  // Worker deletes itself after OnOK/OnError
+        return promise;
+    }
+    
     void Normalize(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
         store_->normalize_all();
     }
     
+    // finalize(progress?): progress(stage, done, total) runs synchronously on this thread
     void FinalizeStore(const Napi::CallbackInfo& info) {
-        store_->finalize();
+        if (ThrowIfLoading(info)) return;
+        Napi::Env env = info.Env();
+        FinalizeProgress progress;
+        if (info.Length() > 0 && info[0].IsFunction()) {
+            Napi::Function callback = info[0].As<Napi::Function>();
+            progress = [env, callback](FinalizeStage stage, size_t done, size_t total) {
+                if (env.IsExceptionPending()) return;  // The callback threw: stop reporting
+                static const char* const names[] = {"compact", "quantize", "index", "done"};
+                callback.Call({Napi::String::New(env, names[static_cast<int>(stage)]),
+                               Napi::Number::New(env, static_cast<double>(done)),
+                               Napi::Number::New(env, static_cast<double>(total))});
+            };
+        }
+        auto error = store_->finalize(progress);
+        if (env.IsExceptionPending()) return;  // Rethrown from the callback
+        if (error) {
+            Napi::Error::New(info.Env(), 
+                std::string("Finalize error: ") + simdjson::error_message(error))
+                .ThrowAsJavaScriptException();
+        }
+    }
+    
+    void Save(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
+        std::string path = info[0].As<Napi::String>();
+        auto error = store_->save(path);
+        if (error) {
+            Napi::Error::New(info.Env(), 
+                std::string("Snapshot save error: ") + simdjson::error_message(error))
+                .ThrowAsJavaScriptException();
+        }
+    }
+    
+    void OpenSnapshot(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
+        std::string path = info[0].As<Napi::String>();
+        auto error = store_->open_snapshot(path);
+        if (error) {
+            Napi::Error::New(info.Env(), 
+                std::string("Snapshot open error: ") + simdjson::error_message(error))
+                .ThrowAsJavaScriptException();
+        }
+    }
+    
+    void Publish(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
+        std::string name = info[0].As<Napi::String>();
+        auto error = store_->publish(name);
+        if (error) {
+            Napi::Error::New(info.Env(), 
+                std::string("Publish error: ") + simdjson::error_message(error))
+                .ThrowAsJavaScriptException();
+        }
+    }
+    
+    void Attach(const Napi::CallbackInfo& info) {
+        if (ThrowIfLoading(info)) return;
+        std::string name = info[0].As<Napi::String>();
+        auto error = store_->attach(name);
+        if (error) {
+            Napi::Error::New(info.Env(), 
+                std::string("Attach error: ") + simdjson::error_message(error))
+                .ThrowAsJavaScriptException();
+        }
+    }
+    
+    // Returns false if nothing was published under the name
+    static Napi::Value Unpublish(const Napi::CallbackInfo& info) {
+        std::string name = info[0].As<Napi::String>();
+        return Napi::Boolean::New(info.Env(), !VectorStore::unpublish(name));
+    }
+    
+    // Merges the delta segment on a worker thread; searches and inserts keep running
+    class CompactWorker : public Napi::AsyncWorker {
+    public:
+        CompactWorker(Napi::Env env, VectorStore* store, Napi::Object owner)
+            : Napi::AsyncWorker(env),
+              deferred_(Napi::Promise::Deferred::New(env)),
+              owner_(Napi::Persistent(owner)),
+              store_(store) {}
+        
+        Napi::Promise Promise() const { return deferred_.Promise(); }
+        
+        void Execute() override {
+            error_ = store_->compact();
+        }
+        
+        void OnOK() override {
+            if (error_) {
+                deferred_.Reject(Napi::Error::New(Env(),
+                    std::string("Compact error: ") + simdjson::error_message(error_)).Value());
+                return;
+            }
+            deferred_.Resolve(Env().Undefined());
+        }
+        
+        void OnError(const Napi::Error& error) override {
+            deferred_.Reject(error.Value());
+        }
+        
+    private:
+        Napi::Promise::Deferred deferred_;
+        Napi::ObjectReference owner_;  // Keeps the wrapper alive until the worker finishes
+        VectorStore* store_;
+        simdjson::error_code error_ = simdjson::SUCCESS;
+    };
+    
+    // compact() -> Promise<void>
+    Napi::Value Compact(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (ThrowIfLoading(info)) return env.Undefined();
+        auto* worker = new CompactWorker(env, store_.get(), info.This().As<Napi::Object>());
+        Napi::Promise promise = worker->Promise();
+        worker->Queue();
+        return promise;
+    }
+    
+    Napi::Value DeltaSize(const Napi::CallbackInfo& info) {
+        return Napi::Number::New(info.Env(), store_->delta_size());
     }
     
     Napi::Value IsFinalized(const Napi::CallbackInfo& info) {
@@ -142,6 +1035,62 @@ public:
     Napi::Value Size(const Napi::CallbackInfo& info) {
         return Napi::Number::New(info.Env(), store_->size());
     }
+    
+    // stats() -> { load, memory, search, enabled }; times in milliseconds
+    Napi::Value Stats(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        const StoreStats stats = store_->stats();
+        auto ms = [&](uint64_t ns) { return Napi::Number::New(env, double(ns) / 1e6); };
+        auto count = [&](uint64_t value) { return Napi::Number::New(env, double(value)); };
+        
+        Napi::Object load = Napi::Object::New(env);
+        load.Set("readMs", ms(stats.read_ns));
+        load.Set("parseMs", ms(stats.parse_ns));
+        load.Set("addMs", ms(stats.add_ns));
+        load.Set("finalizeMs", ms(stats.finalize_ns));
+        load.Set("bytesRead", count(stats.bytes_read));
+        load.Set("filesRead", count(stats.files_read));
+        load.Set("documentsAdded", count(stats.documents_added));
+        load.Set("documentsRejected", count(stats.documents_rejected));
+        Napi::Object rejected = Napi::Object::New(env);
+        for (size_t e = 0; e < simdjson::NUM_ERROR_CODES; ++e) {
+            if (stats.rejected_by_error[e]) {
+                rejected.Set(simdjson::error_message(static_cast<simdjson::error_code>(e)),
+                             count(stats.rejected_by_error[e]));
+            }
+        }
+        load.Set("rejectedByError", rejected);
+        
+        Napi::Object memory = Napi::Object::New(env);
+        memory.Set("arenaReservedBytes", count(stats.arena_reserved_bytes));
+        memory.Set("arenaUsedBytes", count(stats.arena_used_bytes));
+        memory.Set("queryCacheBytes", count(stats.query_cache_bytes));
+        memory.Set("queryCacheEntries", count(stats.query_cache_entries));
+        
+        Napi::Object search = Napi::Object::New(env);
+        search.Set("count", count(stats.searches));
+        search.Set("totalMs", ms(stats.search_ns));
+        Napi::Array histogram = Napi::Array::New(env, LATENCY_BUCKETS);
+        for (size_t b = 0; b < LATENCY_BUCKETS; ++b) {
+            histogram[b] = count(stats.latency_histogram[b]);
+        }
+        search.Set("latencyHistogram", histogram);
+        search.Set("rowsScanned", count(stats.rows_scanned));
+        search.Set("graphSearches", count(stats.graph_searches));
+        search.Set("parallelScans", count(stats.parallel_scans));
+        search.Set("lockWaits", count(stats.lock_waits));
+        search.Set("lockWaitMs", ms(stats.lock_wait_ns));
+        search.Set("cacheHits", count(stats.cache_hits));
+        search.Set("cacheMisses", count(stats.cache_misses));
+        search.Set("ompThreads", Napi::Number::New(env, stats.omp_threads));
+        
+        Napi::Object output = Napi::Object::New(env);
+        output.Set("enabled", Napi::Boolean::New(env, stats.enabled));
+        output.Set("load", load);
+        output.Set("memory", memory);
+        output.Set("search", search);
+        return output;
+    }
 };
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
@@ -0,0 +1,134 @@
+#pragma once
+#include "mmap_file.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+// Memory-mapped binary embeddings paired with a document JSON file.
+//
+// `docs.json` may come with `docs.npy` (NumPy, '<f4', C order, shape (n, dim))
+// or `docs.f32` (raw little-endian float32, n * dim values). Row i holds the
+// embedding of the i-th document in the JSON file, and the documents then
+// need no `metadata.embedding`.
+class EmbeddingFile {
+public:
+    // Path of the sidecar next to `json_path`, or empty if there is none
+    static std::filesystem::path find_sidecar(const std::filesystem::path& json_path) {
+        for (const char* ext : {".npy", ".f32"}) {
+            std::filesystem::path candidate = json_path;
+            candidate.replace_extension(ext);
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(candidate, ec)) {
+                return candidate;
+            }
+        }
+        return {};
+    }
+    
+    // Map and validate `path` for `dim`-wide rows; on failure `error()` says why
+    bool open(const std::filesystem::path& path, size_t dim) {
+        rows_ = 0;
+        dim_ = dim;
+        offset_ = 0;
+        if (!file_.open(path.string())) {
+            error_ = "cannot map file";
+            return false;
+        }
+        if (path.extension() == ".npy" && !parse_npy_header()) {
+            return false;
+        }
+        
+        size_t row_bytes = dim * sizeof(float);
+        size_t payload = file_.size() - offset_;
+        if (row_bytes == 0 || payload % row_bytes != 0) {
+            error_ = "size is not a whole number of rows";
+            return false;
+        }
+        if (rows_ == 0) {
+            rows_ = payload / row_bytes;
+        } else if (rows_ * row_bytes != payload) {
+            error_ = "shape does not match file size";
+            return false;
+        }
+        return true;
+    }
+    
+    size_t rows() const { return rows_; }
+    const char* error() const { return error_; }
+    
+    // Row data may be unaligned; the store copies each row into its own storage
+    const float* row(size_t i) const {
+        return reinterpret_cast<const float*>(file_.data() + offset_ + i * dim_ * sizeof(float));
+    }
+    
+private:
+    // NumPy format: magic, version, header length, then a Python dict literal
+    bool parse_npy_header() {
+        const char* data = file_.data();
+        size_t size = file_.size();
+        if (size < 10 || std::memcmp(data, "\x93NUMPY", 6) != 0) {
+            error_ = "not a .npy file";
+            return false;
+        }
+        
+        uint8_t major = static_cast<uint8_t>(data[6]);
+        size_t header_len, prefix;
+        if (major == 1) {
+            header_len = uint8_t(data[8]) | (size_t(uint8_t(data[9])) << 8);
+            prefix = 10;
+        } else if (size >= 12) {
+            header_len = uint8_t(data[8]) | (size_t(uint8_t(data[9])) << 8) |
+                         (size_t(uint8_t(data[10])) << 16) | (size_t(uint8_t(data[11])) << 24);
+            prefix = 12;
+        } else {
+            error_ = "truncated .npy header";
+            return false;
+        }
+        if (prefix + header_len > size) {
+            error_ = "truncated .npy header";
+            return false;
+        }
+        
+        std::string header(data + prefix, header_len);
+        if (header.find("'descr': '<f4'") == std::string::npos) {
+            error_ = "dtype must be little-endian float32 ('<f4')";
+            return false;
+        }
+        if (header.find("'fortran_order': False") == std::string::npos) {
+            error_ = "array must be in C order";
+            return false;
+        }
+        
+        // 'shape': (n, dim) - a 1-D shape is accepted only for a single row
+        size_t shape = header.find("'shape': (");
+        if (shape == std::string::npos) {
+            error_ = "missing shape";
+            return false;
+        }
+        const char* p = header.c_str() + shape + 10;
+        char* end = nullptr;
+        unsigned long long first = std::strtoull(p, &end, 10);
+        p = end;
+        while (*p == ' ' || *p == ',') ++p;
+        if (*p == ')') {
+            rows_ = first == dim_ ? 1 : 0;
+        } else {
+            unsigned long long second = std::strtoull(p, &end, 10);
+            rows_ = second == dim_ ? first : 0;
+        }
+        if (rows_ == 0) {
+            error_ = "shape does not match the store dimension";
+            return false;
+        }
+        
+        offset_ = prefix + header_len;
+        return true;
+    }
+    
+    MMapFile file_;
+    size_t rows_ = 0;
+    size_t dim_ = 0;
+    size_t offset_ = 0;
+    const char* error_ = "";
+};
@@ -0,0 +1,384 @@
+#include "hnsw_index.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <random>
+
+namespace {
+
+// Max-heap on score: best candidate on top
+struct BestFirst {
+    bool operator()(const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) const {
+        return a.first < b.first;
+    }
+};
+
+// Min-heap on score: worst kept result on top
+struct WorstFirst {
+    bool operator()(const std::pair<float, uint32_t>& a, const std::pair<float, uint32_t>& b) const {
+        return a.first > b.first;
+    }
+};
+
+}  // namespace
+
+void HnswIndex::VisitedList::next() {
+    if (++tag == 0) {
+        // Tag wrapped: clear stale marks once every 2^32 searches
+        std::fill(marks.begin(), marks.end(), 0);
+        tag = 1;
+    }
+}
+
+HnswIndex::HnswIndex() : dot_(kernels::dot) {}
+
+HnswIndex::~HnswIndex() = default;
+
+bool HnswIndex::allocate(size_t n, const HnswParams& params) {
+    n_ = 0;
+    M_ = std::max<size_t>(params.M, 2);
+    ef_construction_ = std::max(params.ef_construction, M_);
+    if (n == 0 || n > UINT32_MAX) {
+        return false;
+    }
+
+    // Level ~ floor(-ln(U) / ln(M)), drawn from a fixed seed so builds are reproducible
+    std::mt19937 rng(100);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double level_mult = 1.0 / std::log(double(M_));
+
+    if (!upper_offsets_storage_.allocate(n + 1)) {
+        return false;
+    }
+    uint64_t* offsets = upper_offsets_storage_.data();
+    offsets[0] = 0;
+    max_level_ = 0;
+    entry_point_ = 0;
+    for (size_t i = 0; i < n; ++i) {
+        double u = std::max(uniform(rng), 1e-12);
+        uint32_t level = static_cast<uint32_t>(-std::log(u) * level_mult);
+        offsets[i + 1] = offsets[i] + level * upper_stride();
+        if (level > max_level_) {
+            max_level_ = level;
+            entry_point_ = static_cast<uint32_t>(i);
+        }
+    }
+
+    if (!level0_storage_.allocate(n * level0_stride()) ||
+        !upper_storage_.allocate(offsets[n])) {
+        return false;
+    }
+    std::fill(level0_storage_.data(), level0_storage_.data() + n * level0_stride(), 0u);
+    std::fill(upper_storage_.data(), upper_storage_.data() + offsets[n], 0u);
+
+    level0_ = level0_storage_.data();
+    upper_offsets_ = offsets;
+    upper_ = upper_storage_.data();
+    n_ = n;
+    return true;
+}
+
+size_t HnswIndex::node_levels(uint32_t node) const {
+    return 1 + (upper_offsets_[node + 1] - upper_offsets_[node]) / upper_stride();
+}
+
+uint32_t* HnswIndex::links(uint32_t node, size_t level) const {
+    // Only owned storage is ever written through this pointer (during build)
+    if (level == 0) {
+        return const_cast<uint32_t*>(level0_ + size_t(node) * level0_stride());
+    }
+    return const_cast<uint32_t*>(upper_ + upper_offsets_[node] + (level - 1) * upper_stride());
+}
+
+uint32_t HnswIndex::greedy_closest(const float* query, uint32_t entry, size_t level, bool locked) const {
+    uint32_t current = entry;
+    float best = score(query, current);
+    std::vector<uint32_t> neighbors;
+
+    for (bool improved = true; improved;) {
+        improved = false;
+        {
+            std::unique_lock<std::mutex> lock;
+            if (locked) lock = std::unique_lock<std::mutex>(link_locks_[current % LOCK_STRIPES]);
+            const uint32_t* block = links(current, level);
+            neighbors.assign(block + 1, block + 1 + block[0]);
+        }
+        for (uint32_t neighbor : neighbors) {
+            float s = score(query, neighbor);
+            if (s > best) {
+                best = s;
+                current = neighbor;
+                improved = true;
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<HnswIndex::Candidate>
+HnswIndex::search_layer(const float* query, uint32_t entry, size_t ef, size_t level,
+                        VisitedList& visited, bool locked, const std::atomic<uint64_t>* skip) const {
+    visited.next();
+    std::priority_queue<Candidate, std::vector<Candidate>, BestFirst> candidates;
+    std::priority_queue<Candidate, std::vector<Candidate>, WorstFirst> results;
+    auto skipped = [skip](uint32_t node) {
+        return skip && ((skip[node >> 6].load(std::memory_order_relaxed) >> (node & 63)) & 1);
+    };
+
+    float entry_score = score(query, entry);
+    candidates.emplace(entry_score, entry);
+    if (!skipped(entry)) results.emplace(entry_score, entry);
+    visited.marks[entry] = visited.tag;
+
+    std::vector<uint32_t> neighbors;
+    while (!candidates.empty()) {
+        Candidate current = candidates.top();
+        if (results.size() >= ef && current.first < results.top().first) {
+            break;  // Nothing left that can improve the result set
+        }
+        candidates.pop();
+
+        {
+            std::unique_lock<std::mutex> lock;
+            if (locked) lock = std::unique_lock<std::mutex>(link_locks_[current.second % LOCK_STRIPES]);
+            const uint32_t* block = links(current.second, level);
+            neighbors.assign(block + 1, block + 1 + block[0]);
+        }
+
+        for (uint32_t neighbor : neighbors) {
+            if (visited.marks[neighbor] == visited.tag) continue;
+            visited.marks[neighbor] = visited.tag;
+
+            // Skipped nodes still extend the frontier, so matching rows behind them are reached
+            float s = score(query, neighbor);
+            if (results.size() < ef || s > results.top().first) {
+                candidates.emplace(s, neighbor);
+                if (skipped(neighbor)) continue;
+                results.emplace(s, neighbor);
+                if (results.size() > ef) results.pop();
+            }
+        }
+    }
+
+    std::vector<Candidate> out(results.size());
+    for (size_t i = out.size(); i-- > 0;) {
+        out[i] = results.top();
+        results.pop();
+    }
+    return out;
+}
+
+void HnswIndex::select_neighbors(std::vector<Candidate>& candidates, size_t max_links) const {
+    if (candidates.size() <= max_links) return;
+
+    std::vector<Candidate> selected;
+    selected.reserve(max_links);
+    for (const Candidate& candidate : candidates) {
+        const float* vec = matrix_ + size_t(candidate.second) * stride_;
+        bool diverse = true;
+        for (const Candidate& kept : selected) {
+            if (score(vec, kept.second) > candidate.first) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) {
+            selected.push_back(candidate);
+            if (selected.size() == max_links) break;
+        }
+    }
+    candidates = std::move(selected);
+}
+
+void HnswIndex::connect(uint32_t from, uint32_t to, float similarity, size_t level) {
+    const size_t max_links = level == 0 ? 2 * M_ : M_;
+    std::lock_guard<std::mutex> lock(link_locks_[from % LOCK_STRIPES]);
+    uint32_t* block = links(from, level);
+
+    if (block[0] < max_links) {
+        block[1 + block[0]] = to;
+        ++block[0];
+        return;
+    }
+
+    // Full: re-select among existing links plus the new one
+    const float* base = matrix_ + size_t(from) * stride_;
+    std::vector<Candidate> candidates;
+    candidates.reserve(max_links + 1);
+    candidates.emplace_back(similarity, to);
+    for (uint32_t i = 0; i < block[0]; ++i) {
+        candidates.emplace_back(score(base, block[1 + i]), block[1 + i]);
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.first > b.first; });
+    select_neighbors(candidates, max_links);
+
+    block[0] = static_cast<uint32_t>(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        block[1 + i] = candidates[i].second;
+    }
+}
+
+void HnswIndex::insert(uint32_t node, VisitedList& visited) {
+    const float* query = matrix_ + size_t(node) * stride_;
+    const size_t top = node_levels(node) - 1;
+
+    // The node holding the top level was made the entry point by allocate();
+    // nodes below it descend from there
+    uint32_t entry = entry_point_;
+    if (entry == node) return;
+
+    for (size_t level = max_level_; level > top; --level) {
+        entry = greedy_closest(query, entry, level, true);
+    }
+
+    for (size_t level = top + 1; level-- > 0;) {
+        std::vector<Candidate> candidates = search_layer(query, entry, ef_construction_, level,
+                                                         visited, true);
+        entry = candidates.front().second;
+        select_neighbors(candidates, M_);
+
+        {
+            std::lock_guard<std::mutex> lock(link_locks_[node % LOCK_STRIPES]);
+            uint32_t* block = links(node, level);
+            block[0] = static_cast<uint32_t>(candidates.size());
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                block[1 + i] = candidates[i].second;
+            }
+        }
+        for (const Candidate& neighbor : candidates) {
+            connect(neighbor.second, node, neighbor.first, level);
+        }
+    }
+}
+
+void HnswIndex::build(const float* matrix, size_t dim, size_t stride, kernels::DotFn dot, bool parallel) {
+    matrix_ = matrix;
+    dim_ = dim;
+    stride_ = stride;
+    dot_ = dot;
+    link_locks_.reset(new std::mutex[LOCK_STRIPES]);
+
+    // The entry point already spans every layer; everything else links into it.
+    // Seed the graph serially so the first parallel inserts have neighbors to find.
+    const size_t seed = std::min<size_t>(n_, 2 * M_);
+    {
+        VisitedList visited(n_);
+        for (size_t i = 0; i < seed; ++i) {
+            insert(static_cast<uint32_t>(i), visited);
+        }
+    }
+
+    #pragma omp parallel if(parallel)
+    {
+        VisitedList visited(n_);
+
+        #pragma omp for schedule(dynamic, 64)
+        for (int64_t i = static_cast<int64_t>(seed); i < static_cast<int64_t>(n_); ++i) {
+            insert(static_cast<uint32_t>(i), visited);
+        }
+    }
+
+    link_locks_.reset();
+}
+
+bool HnswIndex::validate(size_t n, size_t M, uint64_t entry_point, uint64_t max_level,
+                         const uint32_t* level0, const uint64_t* upper_offsets,
+                         const uint32_t* upper, size_t upper_size) {
+    const size_t level0_stride = 1 + 2 * M, upper_stride = 1 + M;
+    if (n == 0 || entry_point >= n || upper_offsets[0] != 0 || upper_offsets[n] != upper_size) {
+        return false;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (upper_offsets[i] > upper_offsets[i + 1] ||
+            (upper_offsets[i + 1] - upper_offsets[i]) % upper_stride != 0) {
+            return false;
+        }
+    }
+
+    // Layers above 0 that `node` has links on
+    auto upper_levels = [&](size_t node) {
+        return (upper_offsets[node + 1] - upper_offsets[node]) / upper_stride;
+    };
+    if (upper_levels(entry_point) != max_level) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t* block = level0 + i * level0_stride;
+        if (block[0] > 2 * M) return false;
+        for (uint32_t j = 1; j <= block[0]; ++j) {
+            if (block[j] >= n) return false;
+        }
+
+        const size_t levels = upper_levels(i);
+        if (levels > max_level) return false;
+        for (size_t level = 1; level <= levels; ++level) {
+            block = upper + upper_offsets[i] + (level - 1) * upper_stride;
+            if (block[0] > M) return false;
+            for (uint32_t j = 1; j <= block[0]; ++j) {
+                if (block[j] >= n || upper_levels(block[j]) < level) return false;
+            }
+        }
+    }
+    return true;
+}
+
+void HnswIndex::attach(const float* matrix, size_t n, size_t dim, size_t stride, kernels::DotFn dot,
+                       size_t M, uint32_t entry_point, uint32_t max_level,
+                       const uint32_t* level0, const uint64_t* upper_offsets, const uint32_t* upper) {
+    level0_storage_.reset();
+    upper_offsets_storage_.reset();
+    upper_storage_.reset();
+    matrix_ = matrix;
+    n_ = n;
+    dim_ = dim;
+    stride_ = stride;
+    dot_ = dot;
+    M_ = M;
+    entry_point_ = entry_point;
+    max_level_ = max_level;
+    level0_ = level0;
+    upper_offsets_ = upper_offsets;
+    upper_ = upper;
+}
+
+std::unique_ptr<HnswIndex::VisitedList> HnswIndex::acquire_visited() const {
+    {
+        std::lock_guard<std::mutex> lock(visited_mutex_);
+        if (!visited_pool_.empty()) {
+            auto visited = std::move(visited_pool_.back());
+            visited_pool_.pop_back();
+            return visited;
+        }
+    }
+    return std::make_unique<VisitedList>(n_);
+}
+
+void HnswIndex::release_visited(std::unique_ptr<VisitedList> visited) const {
+    std::lock_guard<std::mutex> lock(visited_mutex_);
+    visited_pool_.push_back(std::move(visited));
+}
+
+std::vector<std::pair<float, size_t>>
+HnswIndex::search(const float* query, size_t k, size_t ef, const std::atomic<uint64_t>* skip) const {
+    if (n_ == 0 || k == 0) return {};
+
+    uint32_t entry = entry_point_;
+    for (size_t level = max_level_; level > 0; --level) {
+        entry = greedy_closest(query, entry, level, false);
+    }
+
+    auto visited = acquire_visited();
+    std::vector<Candidate> candidates = search_layer(query, entry, std::max(ef, k), 0,
+                                                     *visited, false, skip);
+    release_visited(std::move(visited));
+
+    std::vector<std::pair<float, size_t>> results;
+    results.reserve(std::min(k, candidates.size()));
+    for (size_t i = 0; i < candidates.size() && i < k; ++i) {
+        results.emplace_back(candidates[i].first, candidates[i].second);
+    }
+    return results;
+}
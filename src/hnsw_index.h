@@ -0,0 +1,139 @@
+#pragma once
+#include "aligned_array.h"
+#include "simd_kernels.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// HNSW graph tuning knobs
+struct HnswParams {
+    size_t M = 16;                 // Links per node on upper layers (2 * M on layer 0)
+    size_t ef_construction = 200;  // Candidate list size while inserting
+    size_t ef_search = 64;         // Default candidate list size while searching
+};
+
+// Hierarchical navigable small world graph over a finalized embedding matrix
+// (Malkov & Yashunin). Similarity is the dot product of normalized rows.
+//
+// Links are stored in flat arrays so they can be written to and mapped back
+// from a snapshot as-is:
+//   level0:        n blocks of (1 + 2M) uint32 - [count, neighbors...]
+//   upper_offsets: n + 1 prefix offsets into `upper`; node i has
+//                  (upper_offsets[i+1] - upper_offsets[i]) / (1 + M) upper layers
+//   upper:         one (1 + M) uint32 block per node per layer above 0
+//
+// Node levels are drawn before building, so every array is allocated up
+// front and insertion only fills in links.
+class HnswIndex {
+public:
+    HnswIndex();
+    ~HnswIndex();
+
+    // Draw node levels and reserve link storage for n rows; returns false on
+    // allocation failure
+    bool allocate(size_t n, const HnswParams& params);
+
+    // Insert every row of `matrix` (n x stride, normalized), in parallel unless
+    // `parallel` is false; requires allocate()
+    void build(const float* matrix, size_t dim, size_t stride, kernels::DotFn dot, bool parallel = true);
+
+    // Use graph arrays owned elsewhere, e.g. by a snapshot mapping
+    void attach(const float* matrix, size_t n, size_t dim, size_t stride, kernels::DotFn dot,
+                size_t M, uint32_t entry_point, uint32_t max_level,
+                const uint32_t* level0, const uint64_t* upper_offsets, const uint32_t* upper);
+
+    // Check graph arrays from outside (e.g. a snapshot) before attach(), so a
+    // search can never follow a link out of bounds: link counts fit their
+    // blocks, neighbors are < n, upper offsets are monotonic whole blocks
+    // ending at upper_size (in uint32), the entry point spans exactly
+    // max_level upper layers and every upper-layer neighbor has that layer
+    static bool validate(size_t n, size_t M, uint64_t entry_point, uint64_t max_level,
+                         const uint32_t* level0, const uint64_t* upper_offsets,
+                         const uint32_t* upper, size_t upper_size);
+
+    bool empty() const { return n_ == 0; }
+
+    // Approximate top-k (score, row) sorted by descending score. Rows whose
+    // bit is set in `skip` (one bit per row) are traversed but never
+    // returned. Safe to call concurrently once built.
+    std::vector<std::pair<float, size_t>> search(const float* query, size_t k, size_t ef,
+                                                 const std::atomic<uint64_t>* skip = nullptr) const;
+
+    size_t M() const { return M_; }
+    uint32_t entry_point() const { return entry_point_; }
+    uint32_t max_level() const { return max_level_; }
+    const uint32_t* level0() const { return level0_; }
+    size_t level0_size() const { return n_ * level0_stride(); }  // In uint32
+    const uint64_t* upper_offsets() const { return upper_offsets_; }
+    const uint32_t* upper() const { return upper_; }
+    size_t upper_size() const { return n_ ? upper_offsets_[n_] : 0; }  // In uint32
+
+private:
+    using Candidate = std::pair<float, uint32_t>;  // (score, node)
+
+    // Per-search visited marks, reused across queries via a generation tag
+    struct VisitedList {
+        std::vector<uint32_t> marks;
+        uint32_t tag = 0;
+        explicit VisitedList(size_t n) : marks(n, 0) {}
+        void next();
+    };
+
+    size_t level0_stride() const { return 1 + 2 * M_; }
+    size_t upper_stride() const { return 1 + M_; }
+    size_t node_levels(uint32_t node) const;
+    uint32_t* links(uint32_t node, size_t level) const;
+
+    float score(const float* query, uint32_t node) const {
+        return dot_(query, matrix_ + size_t(node) * stride_, dim_);
+    }
+
+    // Greedy walk on one upper layer towards the query
+    uint32_t greedy_closest(const float* query, uint32_t entry, size_t level, bool locked) const;
+
+    // Best-first search of one layer; returns up to ef candidates not in
+    // `skip`, best first
+    std::vector<Candidate> search_layer(const float* query, uint32_t entry, size_t ef,
+                                        size_t level, VisitedList& visited, bool locked,
+                                        const std::atomic<uint64_t>* skip = nullptr) const;
+
+    // Diversity heuristic: keep a candidate only if it is closer to the base
+    // than to every neighbor already kept. `candidates` must be best first.
+    void select_neighbors(std::vector<Candidate>& candidates, size_t max_links) const;
+
+    void insert(uint32_t node, VisitedList& visited);
+
+    // Link `from` -> `to` on `level`, pruning with the heuristic when full
+    void connect(uint32_t from, uint32_t to, float similarity, size_t level);
+
+    std::unique_ptr<VisitedList> acquire_visited() const;
+    void release_visited(std::unique_ptr<VisitedList> visited) const;
+
+    size_t n_ = 0;
+    size_t dim_ = 0;
+    size_t stride_ = 0;
+    size_t M_ = 0;
+    size_t ef_construction_ = 0;
+    const float* matrix_ = nullptr;
+    kernels::DotFn dot_;
+
+    uint32_t entry_point_ = 0;
+    uint32_t max_level_ = 0;
+
+    AlignedArray<uint32_t> level0_storage_;
+    AlignedArray<uint64_t> upper_offsets_storage_;
+    AlignedArray<uint32_t> upper_storage_;
+    const uint32_t* level0_ = nullptr;
+    const uint64_t* upper_offsets_ = nullptr;
+    const uint32_t* upper_ = nullptr;
+
+    // Build-time striped link locks; at most one is held at a time
+    static constexpr size_t LOCK_STRIPES = 1 << 12;
+    std::unique_ptr<std::mutex[]> link_locks_;
+
+    mutable std::mutex visited_mutex_;
+    mutable std::vector<std::unique_ptr<VisitedList>> visited_pool_;
+};
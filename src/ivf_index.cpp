@@ -0,0 +1,161 @@
+#include "ivf_index.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+IvfIndex::IvfIndex() : dot_(kernels::dot) {}
+
+bool IvfIndex::allocate(size_t n, size_t dim, size_t stride, const IvfParams& params) {
+    nlist_ = 0;
+    if (n == 0 || n > UINT32_MAX) {
+        return false;
+    }
+
+    size_t nlist = params.nlist ? params.nlist
+                                : static_cast<size_t>(4.0 * std::sqrt(double(n)));
+    nlist = std::max<size_t>(1, std::min(nlist, n));
+
+    if (!centroid_storage_.allocate(nlist * stride) ||
+        !offset_storage_.allocate(nlist + 1) ||
+        !assignment_storage_.allocate(n)) {
+        return false;
+    }
+
+    n_ = n;
+    dim_ = dim;
+    stride_ = stride;
+    params_ = params;
+    nlist_ = nlist;
+    centroids_ = centroid_storage_.data();
+    list_offsets_ = offset_storage_.data();
+    return true;
+}
+
+uint32_t IvfIndex::closest(const float* vec) const {
+    uint32_t best = 0;
+    float best_score = -INFINITY;
+    for (size_t c = 0; c < nlist_; ++c) {
+        float s = dot_(vec, centroids_ + c * stride_, dim_);
+        if (s > best_score) {
+            best_score = s;
+            best = static_cast<uint32_t>(c);
+        }
+    }
+    return best;
+}
+
+void IvfIndex::train(const float* matrix, kernels::DotFn dot, uint32_t* order, bool parallel) {
+    dot_ = dot;
+    float* centroids = centroid_storage_.data();
+    uint32_t* assignment = assignment_storage_.data();
+    std::mt19937 rng(42);
+
+    // Training sample: a random subset of rows, fixed seed for reproducible lists
+    std::vector<uint32_t> sample(n_);
+    std::iota(sample.begin(), sample.end(), 0u);
+    size_t sample_size = std::min(n_, nlist_ * std::max<size_t>(params_.train_points_per_list, 1));
+    for (size_t i = 0; i < sample_size; ++i) {
+        std::swap(sample[i], sample[i + rng() % (n_ - i)]);
+    }
+    sample.resize(sample_size);
+
+    // Seed centroids with distinct sample rows (padding stays zero)
+    std::memset(centroids, 0, nlist_ * stride_ * sizeof(float));
+    for (size_t c = 0; c < nlist_; ++c) {
+        std::memcpy(centroids + c * stride_, matrix + size_t(sample[c]) * stride_, dim_ * sizeof(float));
+    }
+
+    std::vector<uint32_t> sample_assignment(sample_size);
+    std::vector<uint32_t> members(sample_size);
+    std::vector<size_t> member_offsets(nlist_ + 1);
+
+    // Spherical k-means: assign by max dot product, centroid = normalized mean
+    for (size_t iter = 0; iter < params_.train_iterations; ++iter) {
+        #pragma omp parallel for if(parallel)
+        for (int64_t i = 0; i < static_cast<int64_t>(sample_size); ++i) {
+            sample_assignment[i] = closest(matrix + size_t(sample[i]) * stride_);
+        }
+
+        // Group sample points by centroid so each centroid is summed by one thread
+        std::fill(member_offsets.begin(), member_offsets.end(), 0);
+        for (uint32_t c : sample_assignment) ++member_offsets[c + 1];
+        std::partial_sum(member_offsets.begin(), member_offsets.end(), member_offsets.begin());
+        {
+            std::vector<size_t> cursor(member_offsets.begin(), member_offsets.end() - 1);
+            for (size_t i = 0; i < sample_size; ++i) {
+                members[cursor[sample_assignment[i]]++] = sample[i];
+            }
+        }
+
+        #pragma omp parallel for schedule(dynamic) if(parallel)
+        for (int64_t c = 0; c < static_cast<int64_t>(nlist_); ++c) {
+            float* centroid = centroids + c * stride_;
+            size_t begin = member_offsets[c], end = member_offsets[c + 1];
+            if (begin == end) continue;  // Reseeded below
+            std::memset(centroid, 0, dim_ * sizeof(float));
+            for (size_t m = begin; m < end; ++m) {
+                const float* row = matrix + size_t(members[m]) * stride_;
+                for (size_t d = 0; d < dim_; ++d) centroid[d] += row[d];
+            }
+            kernels::normalize(centroid, dim_);
+        }
+
+        // Empty lists restart from a random sample point
+        for (size_t c = 0; c < nlist_; ++c) {
+            if (member_offsets[c] == member_offsets[c + 1]) {
+                uint32_t row = sample[rng() % sample_size];
+                std::memcpy(centroids + c * stride_, matrix + size_t(row) * stride_, dim_ * sizeof(float));
+            }
+        }
+    }
+
+    // Assign every row, then counting-sort rows into list order
+    #pragma omp parallel for if(parallel)
+    for (int64_t i = 0; i < static_cast<int64_t>(n_); ++i) {
+        assignment[i] = closest(matrix + size_t(i) * stride_);
+    }
+
+    uint64_t* offsets = offset_storage_.data();
+    std::fill(offsets, offsets + nlist_ + 1, 0);
+    for (size_t i = 0; i < n_; ++i) ++offsets[assignment[i] + 1];
+    std::partial_sum(offsets, offsets + nlist_ + 1, offsets);
+
+    std::vector<uint64_t> cursor(offsets, offsets + nlist_);
+    for (size_t i = 0; i < n_; ++i) {
+        order[cursor[assignment[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    assignment_storage_.reset();
+}
+
+void IvfIndex::attach(const float* centroids, const uint64_t* list_offsets, size_t nlist,
+                      size_t dim, size_t stride, kernels::DotFn dot) {
+    centroid_storage_.reset();
+    offset_storage_.reset();
+    assignment_storage_.reset();
+    n_ = nlist ? list_offsets[nlist] : 0;
+    dim_ = dim;
+    stride_ = stride;
+    dot_ = dot;
+    nlist_ = nlist;
+    centroids_ = centroids;
+    list_offsets_ = list_offsets;
+}
+
+std::vector<uint32_t> IvfIndex::probe(const float* query, size_t nprobe) const {
+    nprobe = std::max<size_t>(1, std::min(nprobe, nlist_));
+
+    std::vector<std::pair<float, uint32_t>> scored(nlist_);
+    for (size_t c = 0; c < nlist_; ++c) {
+        scored[c] = {dot_(query, centroids_ + c * stride_, dim_), static_cast<uint32_t>(c)};
+    }
+    std::partial_sort(scored.begin(), scored.begin() + nprobe, scored.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<uint32_t> lists(nprobe);
+    for (size_t i = 0; i < nprobe; ++i) lists[i] = scored[i].second;
+    return lists;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "aligned_array.h"
+#include "simd_kernels.h"
+#include <cstdint>
+#include <vector>
+
+// IVF tuning knobs
+struct IvfParams {
+    size_t nlist = 0;               // Number of inverted lists; 0 picks ~4 * sqrt(n)
+    size_t nprobe = 8;              // Default lists scanned per query
+    size_t train_iterations = 10;   // k-means iterations
+    size_t train_points_per_list = 64;  // Training sample size, per list
+};
+
+// Inverted file coarse quantizer: spherical k-means centroids over the
+// normalized embeddings, with every row assigned to its closest centroid.
+//
+// The index does not own vectors. train() produces a row order that groups
+// rows by list; the store permutes its matrix (and quantized codes) into that
+// order, so list l is the contiguous row range [list_begin(l), list_end(l)).
+class IvfIndex {
+public:
+    IvfIndex();
+
+    // Reserve centroid and list storage for n rows; returns false on allocation failure
+    bool allocate(size_t n, size_t dim, size_t stride, const IvfParams& params);
+
+    // Train centroids on a sample of `matrix` (n x stride, normalized), assign
+    // every row and write the list-ordered row permutation to `order` (n entries):
+    // order[r] is the current row that moves to row r. Requires allocate().
+    // Runs on an OpenMP team unless `parallel` is false.
+    void train(const float* matrix, kernels::DotFn dot, uint32_t* order, bool parallel = true);
+
+    // Use centroids and list offsets owned elsewhere, e.g. by a snapshot mapping
+    void attach(const float* centroids, const uint64_t* list_offsets, size_t nlist,
+                size_t dim, size_t stride, kernels::DotFn dot);
+
+    bool empty() const { return nlist_ == 0; }
+
+    // The `nprobe` lists whose centroids score highest against `query`
+    std::vector<uint32_t> probe(const float* query, size_t nprobe) const;
+
+    size_t nlist() const { return nlist_; }
+    size_t list_begin(uint32_t list) const { return list_offsets_[list]; }
+    size_t list_end(uint32_t list) const { return list_offsets_[list + 1]; }
+
+    const float* centroids() const { return centroids_; }  // nlist x stride floats
+    const uint64_t* list_offsets() const { return list_offsets_; }  // nlist + 1 row offsets
+
+private:
+    uint32_t closest(const float* vec) const;
+
+    size_t n_ = 0;
+    size_t dim_ = 0;
+    size_t stride_ = 0;
+    size_t nlist_ = 0;
+    IvfParams params_;
+    kernels::DotFn dot_;
+
+    AlignedArray<float> centroid_storage_;
+    AlignedArray<uint64_t> offset_storage_;
+    AlignedArray<uint32_t> assignment_storage_;  // Per-row list, released by train()
+    const float* centroids_ = nullptr;
+    const uint64_t* list_offsets_ = nullptr;
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Intra-file parallelism for large `[ {...}, {...} ]` files and NDJSON
+// buffers: one thread pre-scans for top-level document boundaries, and the
+// loader cuts the documents into chunks that any idle parser thread can take.
+
+// Byte range [first, second) of each top-level array element. Returns false
+// if `data` is not a well-nested array (the caller then parses it serially).
+inline bool split_json_array(const char* data, size_t size,
+                             std::vector<std::pair<size_t, size_t>>& elements) {
+    elements.clear();
+    size_t i = 0;
+    auto skip_space = [&]() {
+        while (i < size && (data[i] == ' ' || data[i] == '\n' || data[i] == '\r' || data[i] == '\t')) ++i;
+    };
+
+    skip_space();
+    if (i == size || data[i] != '[') return false;
+    ++i;
+
+    size_t depth = 0;
+    size_t start = SIZE_MAX;
+    for (; i < size; ++i) {
+        char c = data[i];
+        if (start == SIZE_MAX) {
+            // Between elements: only whitespace, commas or the closing bracket
+            if (c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',') continue;
+            if (c == ']') return true;
+            start = i;
+        }
+
+        if (c == '"') {
+            // Jump over the string, honouring escapes
+            for (++i; i < size && data[i] != '"'; ++i) {
+                if (data[i] == '\\') ++i;
+            }
+            if (i >= size) return false;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                // The array closes right after a scalar element
+                elements.emplace_back(start, i);
+                return c == ']';
+            }
+            --depth;
+        } else if (c == ',' && depth == 0) {
+            size_t end = i;
+            while (end > start && (data[end - 1] == ' ' || data[end - 1] == '\n' ||
+                                   data[end - 1] == '\r' || data[end - 1] == '\t')) --end;
+            elements.emplace_back(start, end);
+            start = SIZE_MAX;
+            continue;
+        }
+
+        if (depth == 0 && (c == '}' || c == ']' || c == '"')) {
+            // An object, array or string element just closed
+            elements.emplace_back(start, i + 1);
+            start = SIZE_MAX;
+        }
+    }
+    return false;  // Unterminated array
+}
+
+// Byte range [first, second) of each non-blank line of NDJSON, without the
+// line break. Lines are documents, so no scanning inside them is needed.
+inline void split_json_lines(const char* data, size_t size,
+                             std::vector<std::pair<size_t, size_t>>& lines) {
+    lines.clear();
+    size_t start = 0;
+    while (start < size) {
+        const void* newline = std::memchr(data + start, '\n', size - start);
+        size_t end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : size;
+        size_t next = end + 1;
+        while (start < end && (data[start] == ' ' || data[start] == '\t' || data[start] == '\r')) ++start;
+        while (end > start && (data[end - 1] == ' ' || data[end - 1] == '\t' || data[end - 1] == '\r')) --end;
+        if (end > start) lines.emplace_back(start, end);
+        start = next;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -41,11 +42,15 @@ public:
         return *this;
     }
     
-    bool open(const std::string& filepath) {
+    // With `shared`, the mapping is MAP_SHARED: it is meant to stay mapped by
+    // many processes. Either way it is advised for sequential scans; see
+    // advise_random() for the parts that are probed instead.
+    bool open(const std::string& filepath, bool shared = false) {
         close();
         
         #ifdef _WIN32
-        // Windows implementation
+        // Windows implementation (views of one file mapping are always shared)
+        (void)shared;
         file_handle_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
         if (file_handle_ == INVALID_HANDLE_VALUE) {
@@ -98,7 +103,7 @@ public:
             return true; // Empty file, nothing to map
         }
         
-        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        data_ = mmap(nullptr, size_, PROT_READ, shared ? MAP_SHARED : MAP_PRIVATE, fd_, 0);
         if (data_ == MAP_FAILED) {
             ::close(fd_);
             fd_ = -1;
@@ -113,6 +118,23 @@ public:
         return true;
     }
     
+    // Advise random access (no readahead) for bytes [offset, offset + size),
+    // widened to whole pages, e.g. for sections followed link by link
+    void advise_random(size_t offset, size_t size) const {
+        #ifndef _WIN32
+        if (!data_ || size == 0 || offset >= size_) {
+            return;
+        }
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t begin = offset / page * page;
+        const size_t end = std::min(offset + size, size_);
+        madvise(static_cast<char*>(data_) + begin, end - begin, MADV_RANDOM);
+        #else
+        (void)offset;
+        (void)size;
+        #endif
+    }
+    
     void close() {
         if (data_) {
             #ifdef _WIN32
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// NUMA topology and thread placement (Linux, read from sysfs; no libnuma
+// needed). Elsewhere the topology is empty and pinning is a no-op.
+namespace numa {
+
+struct Node {
+    int id = 0;
+    std::vector<int> cpus;  // Online CPUs of the node
+};
+
+// Parse a sysfs list such as "0-3,8,10-11"
+inline std::vector<int> parse_list(const std::string& text) {
+    std::vector<int> values;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) end = text.size();
+        int first = 0, last = 0;
+        int fields = std::sscanf(text.c_str() + pos, "%d-%d", &first, &last);
+        if (fields == 1) last = first;
+        if (fields >= 1 && first >= 0) {
+            for (int v = first; v <= last; ++v) values.push_back(v);
+        }
+        pos = end + 1;
+    }
+    return values;
+}
+
+inline std::string read_line(const std::string& path) {
+    std::string line;
+    if (FILE* file = std::fopen(path.c_str(), "r")) {
+        char buffer[4096];
+        if (std::fgets(buffer, sizeof(buffer), file)) line = buffer;
+        std::fclose(file);
+    }
+    return line;
+}
+
+// Online nodes that have CPUs, in id order (read once)
+inline const std::vector<Node>& topology() {
+    static const std::vector<Node> nodes = [] {
+        std::vector<Node> found;
+        #ifdef __linux__
+        const std::string root = "/sys/devices/system/node/";
+        for (int id : parse_list(read_line(root + "online"))) {
+            Node node;
+            node.id = id;
+            node.cpus = parse_list(read_line(root + "node" + std::to_string(id) + "/cpulist"));
+            if (!node.cpus.empty()) found.push_back(std::move(node));
+        }
+        #endif
+        return found;
+    }();
+    return nodes;
+}
+
+// Node `id` of the topology, or nullptr
+inline const Node* find_node(int id) {
+    for (const Node& node : topology()) {
+        if (node.id == id) return &node;
+    }
+    return nullptr;
+}
+
+// Restricts the calling thread to `cpus` until destroyed, then restores its
+// previous affinity. An empty list (or a failed call) leaves the thread as is.
+class ThreadPin {
+public:
+    explicit ThreadPin(const std::vector<int>& cpus) {
+        #ifdef __linux__
+        if (cpus.empty() || sched_getaffinity(0, sizeof(previous_), &previous_) != 0) return;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        for (int cpu : cpus) {
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+        }
+        pinned_ = sched_setaffinity(0, sizeof(mask), &mask) == 0;
+        #else
+        (void)cpus;
+        #endif
+    }
+    ~ThreadPin() {
+        #ifdef __linux__
+        if (pinned_) sched_setaffinity(0, sizeof(previous_), &previous_);
+        #endif
+    }
+    ThreadPin(const ThreadPin&) = delete;
+    ThreadPin& operator=(const ThreadPin&) = delete;
+
+    bool pinned() const { return pinned_; }
+
+private:
+    bool pinned_ = false;
+    #ifdef __linux__
+    cpu_set_t previous_;
+    #endif
+};
+
+// Members [first, last) of a `count`-thread team serve shard `s` of
+// `shards`: threads are split evenly, and with fewer threads than shards
+// thread s % count takes the shard alone
+inline void shard_threads(size_t s, size_t shards, size_t count, size_t& first, size_t& last) {
+    if (count < shards) {
+        first = s % count;
+        last = first + 1;
+    } else {
+        first = s * count / shards;
+        last = (s + 1) * count / shards;
+    }
+}
+
+// Matrix rows [begin, end) placed on `node`
+struct Shard {
+    size_t begin = 0;
+    size_t end = 0;
+    const Node* node = nullptr;
+};
+
+}  // namespace numa
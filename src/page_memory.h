@@ -0,0 +1,116 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+// Anonymous page mappings for large, long-lived buffers. Pages are zero-filled
+// on first touch, so reserved but unused space costs no RSS.
+namespace page_memory {
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+inline size_t page_size() {
+    #ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+    #else
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+    #endif
+}
+
+inline size_t round_up(size_t bytes, size_t granule) {
+    return (bytes + granule - 1) / granule * granule;
+}
+
+// Ask for transparent huge pages over [ptr, ptr + bytes) (Linux; a no-op elsewhere)
+inline void advise_huge(void* ptr, size_t bytes) {
+    #ifdef MADV_HUGEPAGE
+    madvise(ptr, bytes, MADV_HUGEPAGE);
+    #else
+    (void)ptr;
+    (void)bytes;
+    #endif
+}
+
+// Prefer NUMA node `node` for [ptr, ptr + bytes) (Linux; best effort, no libnuma needed)
+inline void prefer_node(void* ptr, size_t bytes, int node) {
+    #if defined(__linux__) && defined(SYS_mbind)
+    if (node < 0 || node >= 63) return;
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    unsigned long mask = 1UL << node;
+    syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED_MODE, &mask, sizeof(mask) * 8, 0);
+    #else
+    (void)ptr;
+    (void)bytes;
+    (void)node;
+    #endif
+}
+
+// Map at least `bytes` of zeroed memory; the mapped length is stored in
+// `mapped`. With `huge`, mappings of 2MB and up are 2MB-aligned and backed by
+// huge pages where the OS allows. Returns nullptr on failure.
+inline void* map(size_t bytes, bool huge, int numa_node, size_t& mapped) {
+    huge = huge && bytes >= HUGE_PAGE_SIZE;
+    mapped = round_up(bytes, huge ? HUGE_PAGE_SIZE : page_size());
+
+    #ifdef _WIN32
+    (void)numa_node;
+    void* ptr = VirtualAlloc(nullptr, mapped, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    return ptr;
+    #else
+    // Over-map by one huge page and trim, so the region starts on a 2MB boundary
+    size_t request = huge ? mapped + HUGE_PAGE_SIZE : mapped;
+    void* raw = mmap(nullptr, request, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    char* ptr = static_cast<char*>(raw);
+    if (huge) {
+        char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(ptr), HUGE_PAGE_SIZE));
+        if (aligned > ptr) munmap(ptr, aligned - ptr);
+        size_t tail = (ptr + request) - (aligned + mapped);
+        if (tail) munmap(aligned + mapped, tail);
+        ptr = aligned;
+        advise_huge(ptr, mapped);
+    }
+    prefer_node(ptr, mapped, numa_node);
+    return ptr;
+    #endif
+}
+
+inline void unmap(void* ptr, size_t mapped) {
+    if (!ptr) return;
+    #ifdef _WIN32
+    (void)mapped;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+    #else
+    munmap(ptr, mapped);
+    #endif
+}
+
+// Return the pages of [ptr + keep, ptr + mapped) to the OS; returns the new mapped length
+inline size_t trim(void* ptr, size_t mapped, size_t keep) {
+    keep = round_up(keep, page_size());
+    if (keep >= mapped) return mapped;
+    char* tail = static_cast<char*>(ptr) + keep;
+    #ifdef _WIN32
+    VirtualFree(tail, mapped - keep, MEM_DECOMMIT);
+    return mapped;  // Still reserved; unmap() releases the whole region
+    #else
+    munmap(tail, mapped - keep);
+    return keep;
+    #endif
+}
+
+}  // namespace page_memory
@@ -0,0 +1,258 @@
+#include "product_quantizer.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Squared L2 distance between two subvectors
+float l2_sq(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t d = 0; d < n; ++d) {
+        float diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+// Index of the centroid (of `count`, `stride` floats apart) closest to `vec`
+uint32_t nearest(const float* vec, const float* centroids, size_t count, size_t stride, size_t n) {
+    uint32_t best = 0;
+    float best_dist = INFINITY;
+    for (size_t c = 0; c < count; ++c) {
+        float dist = l2_sq(vec, centroids + c * stride, n);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = static_cast<uint32_t>(c);
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+ProductQuantizer::ProductQuantizer()
+    : adc_(kernels::pq_adc_for(kernels::active_isa())),
+      scan4_(kernels::pq_scan4_for(kernels::active_isa())) {}
+
+size_t ProductQuantizer::resolve_bits(const PqParams& params) {
+    return params.bits == 4 ? 4 : 8;
+}
+
+size_t ProductQuantizer::resolve_m(size_t dim, const PqParams& params) {
+    size_t m = params.m ? params.m : dim / resolve_bits(params);
+    return std::max<size_t>(1, std::min(m, dim));
+}
+
+size_t ProductQuantizer::codebook_bytes(size_t m, size_t bits, size_t dim) {
+    return m ? m * (size_t(1) << bits) * ((dim + m - 1) / m) * sizeof(float) : 0;
+}
+
+size_t ProductQuantizer::code_bytes(size_t m, size_t bits, size_t n) {
+    if (bits == 4) {
+        return (n + BLOCK_ROWS - 1) / BLOCK_ROWS * m * 16;
+    }
+    return n * m;
+}
+
+bool ProductQuantizer::allocate(size_t n, size_t dim, const PqParams& params) {
+    m_ = 0;
+    codebooks_ = nullptr;
+    codes_ = nullptr;
+    if (dim == 0) {
+        return false;
+    }
+
+    n_ = n;
+    dim_ = dim;
+    m_ = resolve_m(dim, params);
+    bits_ = resolve_bits(params);
+    dsub_ = (dim + m_ - 1) / m_;
+    params_ = params;
+    if (!codebook_storage_.allocate(m_ * centroids() * dsub_) ||
+        !code_storage_.allocate(code_bytes())) {
+        m_ = 0;
+        return false;
+    }
+    codebooks_ = codebook_storage_.data();
+    codes_ = code_storage_.data();
+    return true;
+}
+
+void ProductQuantizer::train(const float* matrix, size_t stride, bool parallel) {
+    float* codebooks = codebook_storage_.data();
+    const size_t ksub = centroids();
+    std::memset(codebooks, 0, codebook_bytes());
+    if (n_ == 0) {
+        return;
+    }
+
+    // Training sample: a random subset of rows, fixed seed for reproducible codebooks
+    std::mt19937 rng(42);
+    std::vector<uint32_t> sample(n_);
+    std::iota(sample.begin(), sample.end(), 0u);
+    const size_t sample_size = std::min(n_, ksub * std::max<size_t>(params_.train_points_per_centroid, 1));
+    for (size_t i = 0; i < sample_size; ++i) {
+        std::swap(sample[i], sample[i + rng() % (n_ - i)]);
+    }
+    sample.resize(sample_size);
+
+    // Subspaces are independent: one L2 k-means per thread at a time
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for (int64_t j = 0; j < static_cast<int64_t>(m_); ++j) {
+        const size_t begin = sub_begin(j), dsub = sub_begin(j + 1) - begin;
+        float* codebook = codebooks + j * ksub * dsub_;
+        std::mt19937 sub_rng(static_cast<uint32_t>(42 + j));
+
+        // Contiguous copy of the sampled subvectors
+        std::vector<float> points(sample_size * dsub);
+        for (size_t i = 0; i < sample_size; ++i) {
+            std::memcpy(&points[i * dsub], matrix + size_t(sample[i]) * stride + begin, dsub * sizeof(float));
+        }
+
+        // Seed with sample points (repeating them when there are fewer than ksub)
+        for (size_t c = 0; c < ksub; ++c) {
+            std::memcpy(codebook + c * dsub_, &points[(c % sample_size) * dsub], dsub * sizeof(float));
+        }
+
+        std::vector<uint32_t> assignment(sample_size);
+        std::vector<uint32_t> counts(ksub);
+        for (size_t iter = 0; iter < params_.train_iterations; ++iter) {
+            for (size_t i = 0; i < sample_size; ++i) {
+                assignment[i] = nearest(&points[i * dsub], codebook, ksub, dsub_, dsub);
+            }
+
+            std::fill(counts.begin(), counts.end(), 0u);
+            std::fill(codebook, codebook + ksub * dsub_, 0.0f);
+            for (size_t i = 0; i < sample_size; ++i) {
+                float* centroid = codebook + size_t(assignment[i]) * dsub_;
+                for (size_t d = 0; d < dsub; ++d) centroid[d] += points[i * dsub + d];
+                ++counts[assignment[i]];
+            }
+            for (size_t c = 0; c < ksub; ++c) {
+                float* centroid = codebook + c * dsub_;
+                if (counts[c] == 0) {
+                    // Empty clusters restart from a random sample point
+                    std::memcpy(centroid, &points[(sub_rng() % sample_size) * dsub], dsub * sizeof(float));
+                    continue;
+                }
+                const float inv = 1.0f / counts[c];
+                for (size_t d = 0; d < dsub; ++d) centroid[d] *= inv;
+            }
+        }
+    }
+
+    encode(matrix, stride, parallel);
+}
+
+void ProductQuantizer::encode(const float* matrix, size_t stride, bool parallel) {
+    uint8_t* out = code_storage_.data();
+    const size_t ksub = centroids();
+
+    if (bits_ == 8) {
+        #pragma omp parallel for if(parallel)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_); ++i) {
+            const float* row = matrix + size_t(i) * stride;
+            for (size_t j = 0; j < m_; ++j) {
+                const size_t begin = sub_begin(j);
+                out[size_t(i) * m_ + j] = static_cast<uint8_t>(
+                    nearest(row + begin, codebooks_ + j * ksub * dsub_, ksub, dsub_, sub_begin(j + 1) - begin));
+            }
+        }
+        return;
+    }
+
+    // 4-bit: rows r and r + 16 of a block share bytes, so each block is one thread's
+    const size_t blocks = (n_ + BLOCK_ROWS - 1) / BLOCK_ROWS;
+    #pragma omp parallel for if(parallel)
+    for (int64_t b = 0; b < static_cast<int64_t>(blocks); ++b) {
+        uint8_t* block = out + size_t(b) * m_ * 16;
+        std::memset(block, 0, m_ * 16);  // Rows past n stay code 0
+        const size_t first = size_t(b) * BLOCK_ROWS;
+        for (size_t r = 0; r < BLOCK_ROWS && first + r < n_; ++r) {
+            const float* row = matrix + (first + r) * stride;
+            for (size_t j = 0; j < m_; ++j) {
+                const size_t begin = sub_begin(j);
+                uint32_t code = nearest(row + begin, codebooks_ + j * ksub * dsub_, ksub, dsub_,
+                                        sub_begin(j + 1) - begin);
+                block[j * 16 + (r & 15)] |= static_cast<uint8_t>(r < 16 ? code : code << 4);
+            }
+        }
+    }
+}
+
+void ProductQuantizer::attach(size_t m, size_t bits, const float* codebooks, const uint8_t* codes,
+                              size_t n, size_t dim) {
+    codebook_storage_.reset();
+    code_storage_.reset();
+    n_ = n;
+    dim_ = dim;
+    m_ = m;
+    bits_ = bits;
+    dsub_ = m ? (dim + m - 1) / m : 0;
+    codebooks_ = codebooks;
+    codes_ = codes;
+}
+
+void ProductQuantizer::prepare_query(const float* query, Table& table) const {
+    const size_t ksub = centroids();
+    table.lut.resize(m_ * ksub);
+    for (size_t j = 0; j < m_; ++j) {
+        const size_t begin = sub_begin(j), dsub = sub_begin(j + 1) - begin;
+        const float* codebook = codebooks_ + j * ksub * dsub_;
+        for (size_t c = 0; c < ksub; ++c) {
+            table.lut[j * ksub + c] = kernels::dot(query + begin, codebook + c * dsub_, dsub);
+        }
+    }
+    if (bits_ != 4) {
+        return;
+    }
+
+    // Quantize each subspace's table to bytes above its minimum, with one
+    // shared step chosen so no entry exceeds 255 and no row sum exceeds 65535
+    float bias = 0.0f, total_range = 0.0f, max_range = 0.0f;
+    for (size_t j = 0; j < m_; ++j) {
+        const float* lut = &table.lut[j * 16];
+        const auto [lo, hi] = std::minmax_element(lut, lut + 16);
+        bias += *lo;
+        total_range += *hi - *lo;
+        max_range = std::max(max_range, *hi - *lo);
+    }
+    float step = 1.0f;
+    if (max_range > 0.0f) {
+        step = std::min(255.0f / max_range, (65535.0f - 0.5f * m_) / total_range);
+    }
+    table.lut8.resize(m_ * 16);
+    for (size_t j = 0; j < m_; ++j) {
+        const float* lut = &table.lut[j * 16];
+        const float lo = *std::min_element(lut, lut + 16);
+        for (size_t c = 0; c < 16; ++c) {
+            table.lut8[j * 16 + c] = static_cast<uint8_t>(std::min(255.0f, std::nearbyint((lut[c] - lo) * step)));
+        }
+    }
+    table.bias = bias;
+    table.scale = 1.0f / step;
+}
+
+void ProductQuantizer::score_rows(const Table& table, size_t begin, size_t end, float* out) const {
+    if (bits_ == 8) {
+        for (size_t i = begin; i < end; ++i) {
+            out[i - begin] = adc_(table.lut.data(), codes_ + i * m_, m_);
+        }
+        return;
+    }
+
+    // Fast-scan whole blocks, keeping the rows inside [begin, end)
+    uint16_t sums[BLOCK_ROWS];
+    for (size_t block = begin / BLOCK_ROWS; block * BLOCK_ROWS < end; ++block) {
+        scan4_(codes_ + block * m_ * 16, table.lut8.data(), m_, sums);
+        const size_t first = std::max(begin, block * BLOCK_ROWS);
+        const size_t last = std::min(end, (block + 1) * BLOCK_ROWS);
+        for (size_t i = first; i < last; ++i) {
+            out[i - begin] = table.bias + table.scale * sums[i - block * BLOCK_ROWS];
+        }
+    }
+}
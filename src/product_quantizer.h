@@ -0,0 +1,100 @@
+#pragma once
+#include "aligned_array.h"
+#include "simd_kernels.h"
+#include <cstdint>
+#include <vector>
+
+// PQ tuning knobs
+struct PqParams {
+    size_t m = 0;                   // Subspaces; 0 picks dim / 8 (8-bit) or dim / 4 (4-bit)
+    size_t bits = 8;                // Bits per subspace code: 8 (256 centroids) or 4 (16, fast-scan)
+    size_t train_iterations = 10;   // k-means iterations per subspace
+    size_t train_points_per_centroid = 64;  // Training sample size, per centroid
+};
+
+// Product quantizer over the finalized embedding matrix: each row is split
+// into m subvectors (subspace j covers dims [j * dim / m, (j + 1) * dim / m))
+// and every subvector is replaced by the index of its nearest centroid in
+// that subspace's codebook, learned by k-means during finalize().
+//
+// A search builds one lookup table per query holding the dot product of each
+// query subvector with every centroid, so a row scores as m table lookups
+// (asymmetric distance computation). 4-bit codes are scanned 32 rows at a time
+// with byte shuffles over a table quantized to 8 bits ("fast-scan"); their
+// scores are coarser still, which the store's exact re-rank absorbs.
+//
+// Code layout: 8-bit codes are n x m bytes, row-major. 4-bit codes come in
+// blocks of 32 rows, each m x 16 bytes: byte j * 16 + b of a block holds row b
+// in its low nibble and row b + 16 in its high one.
+class ProductQuantizer {
+public:
+    // Per-query lookup tables
+    struct Table {
+        std::vector<float> lut;      // m x centroids() dot products
+        std::vector<uint8_t> lut8;   // 4-bit only: lut quantized to m x 16 bytes
+        float bias = 0.0f;           // 4-bit score = bias + scale * sum of lut8 entries
+        float scale = 1.0f;
+    };
+
+    ProductQuantizer();
+
+    // Reserve codebook and code storage for n rows; returns false on allocation failure
+    bool allocate(size_t n, size_t dim, const PqParams& params);
+
+    // Train every subspace's codebook on a sample of `matrix` (n x stride), in
+    // parallel across subspaces unless `parallel` is false, then encode all
+    // rows; requires allocate()
+    void train(const float* matrix, size_t stride, bool parallel = true);
+
+    // Use codebooks and codes owned elsewhere, e.g. by a snapshot mapping
+    void attach(size_t m, size_t bits, const float* codebooks, const uint8_t* codes,
+                size_t n, size_t dim);
+
+    bool empty() const { return m_ == 0; }
+    size_t m() const { return m_; }
+    size_t bits() const { return bits_; }
+    size_t centroids() const { return size_t(1) << bits_; }
+
+    // Build the lookup tables for `query` (dim floats)
+    void prepare_query(const float* query, Table& table) const;
+
+    // Approximate scores of rows [begin, end) into out[0, end - begin)
+    void score_rows(const Table& table, size_t begin, size_t end, float* out) const;
+
+    // m x centroids() x ceil(dim / m) floats, zero padded past each subspace's width
+    const float* codebooks() const { return codebooks_; }
+    size_t codebook_bytes() const { return codebook_bytes(m_, bits_, dim_); }
+    const uint8_t* codes() const { return codes_; }
+    size_t code_bytes() const { return code_bytes(m_, bits_, n_); }
+
+    // The same sizes for m subspaces of `bits` over dim dimensions and n rows,
+    // e.g. to check sections before attach()
+    static size_t codebook_bytes(size_t m, size_t bits, size_t dim);
+    static size_t code_bytes(size_t m, size_t bits, size_t n);
+
+    // Code width and subspace count used for `params` over dim dimensions:
+    // bits other than 4 mean 8, and m is clamped to [1, dim]
+    static size_t resolve_bits(const PqParams& params);
+    static size_t resolve_m(size_t dim, const PqParams& params);
+
+private:
+    static constexpr size_t BLOCK_ROWS = 32;  // 4-bit fast-scan block
+
+    size_t sub_begin(size_t j) const { return j * dim_ / m_; }
+    void encode(const float* matrix, size_t stride, bool parallel);
+
+    size_t n_ = 0;
+    size_t dim_ = 0;
+    size_t m_ = 0;
+    size_t bits_ = 8;
+    size_t dsub_ = 0;  // Largest subspace width; codebook entries are padded to it
+    PqParams params_;
+
+    AlignedArray<float> codebook_storage_;
+    AlignedArray<uint8_t> code_storage_;
+    const float* codebooks_ = nullptr;
+    const uint8_t* codes_ = nullptr;
+
+    kernels::PqAdcFn adc_;
+    kernels::PqScan4Fn scan4_;
+};
@@ -0,0 +1,167 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Bounded LRU cache of search results for workloads that repeat the same
+// query vectors. A key is the exact query bytes followed by an encoding of
+// the knobs that change the results (k, filter, ef, ...); lookups compare the
+// whole key, so a hash collision is only a miss. Entries are spread over
+// independently locked shards by key hash, so concurrent searches rarely
+// meet on a lock, and each shard evicts its least recently used entries to
+// stay within its share of the byte budget.
+//
+// Every entry records the generation it was computed in. invalidate() starts
+// a new generation, turning all earlier entries into misses (they are dropped
+// as lookups find them or evicted with the rest). A search must read
+// generation() before it reads any store state and insert its results under
+// that value, so results computed across a change are never served.
+class QueryCache {
+public:
+    using Results = std::vector<std::pair<float, size_t>>;
+
+    struct Key {
+        uint64_t hash = 0;
+        std::string bytes;  // Query floats, then the encoded options
+    };
+
+    QueryCache(size_t max_bytes, size_t shards)
+        : shard_count_(shards ? shards : 1),
+          shard_bytes_(max_bytes / shard_count_),
+          shards_(new Shard[shard_count_]) {}
+
+    static Key make_key(const float* query, size_t dim, const std::string& params) {
+        Key key;
+        key.bytes.resize(dim * sizeof(float) + params.size());
+        std::memcpy(&key.bytes[0], query, dim * sizeof(float));
+        std::memcpy(&key.bytes[dim * sizeof(float)], params.data(), params.size());
+
+        // FNV-1a over 8-byte words, then a final avalanche (splitmix64)
+        uint64_t h = 14695981039346656037ULL;
+        size_t i = 0;
+        for (; i + 8 <= key.bytes.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, key.bytes.data() + i, sizeof(word));
+            h = (h ^ word) * 1099511628211ULL;
+        }
+        for (; i < key.bytes.size(); ++i) {
+            h = (h ^ static_cast<unsigned char>(key.bytes[i])) * 1099511628211ULL;
+        }
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+        key.hash = h ^ (h >> 31);
+        return key;
+    }
+
+    uint64_t generation() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    void invalidate() {
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Copies the cached results for `key` into `results`; false on a miss
+    bool lookup(const Key& key, Results& results) {
+        Shard& shard = shard_for(key.hash);
+        const uint64_t current = generation();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key.hash);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        Entry& entry = *it->second;
+        if (entry.generation != current) {
+            shard.erase(it);
+            return false;
+        }
+        if (entry.key.bytes != key.bytes) {
+            return false;
+        }
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        results = entry.results;
+        return true;
+    }
+
+    // Cache `results` computed at `generation`; entries larger than a shard's
+    // budget, and results already outdated, are not kept
+    void insert(Key key, uint64_t generation, const Results& results) {
+        const size_t bytes = ENTRY_OVERHEAD + key.bytes.size() + results.size() * sizeof(results[0]);
+        if (bytes > shard_bytes_ || generation != this->generation()) {
+            return;
+        }
+        Shard& shard = shard_for(key.hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key.hash);
+        if (it != shard.index.end()) {
+            shard.erase(it);
+        }
+        while (shard.bytes + bytes > shard_bytes_) {
+            shard.erase(shard.index.find(shard.lru.back().key.hash));
+        }
+        const uint64_t hash = key.hash;
+        shard.lru.push_front(Entry{std::move(key), generation, results, bytes});
+        shard.index.emplace(hash, shard.lru.begin());
+        shard.bytes += bytes;
+    }
+
+    // Bytes and entries held, stale entries included
+    size_t bytes() const {
+        size_t total = 0;
+        for (size_t s = 0; s < shard_count_; ++s) {
+            std::lock_guard<std::mutex> lock(shards_[s].mutex);
+            total += shards_[s].bytes;
+        }
+        return total;
+    }
+
+    size_t entries() const {
+        size_t total = 0;
+        for (size_t s = 0; s < shard_count_; ++s) {
+            std::lock_guard<std::mutex> lock(shards_[s].mutex);
+            total += shards_[s].lru.size();
+        }
+        return total;
+    }
+
+private:
+    // Charged per entry on top of its key and results: list node, map node, vectors
+    static constexpr size_t ENTRY_OVERHEAD = 128;
+
+    struct Entry {
+        Key key;
+        uint64_t generation;
+        Results results;
+        size_t bytes;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // Most recently used first
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;  // By key hash
+        size_t bytes = 0;
+
+        void erase(std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator it) {
+            bytes -= it->second->bytes;
+            lru.erase(it->second);
+            index.erase(it);
+        }
+    };
+
+    Shard& shard_for(uint64_t hash) {
+        return shards_[hash % shard_count_];
+    }
+
+    const size_t shard_count_;
+    const size_t shard_bytes_;
+    std::unique_ptr<Shard[]> shards_;
+    std::atomic<uint64_t> generation_{0};
+};
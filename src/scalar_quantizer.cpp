@@ -0,0 +1,131 @@
+#include "scalar_quantizer.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+const char* quantization_name(Quantization type) {
+    switch (type) {
+        case Quantization::None: return "none";
+        case Quantization::Int8: return "int8";
+        case Quantization::Fp16: return "fp16";
+        case Quantization::PQ: return "pq";
+    }
+    return "unknown";
+}
+
+ScalarQuantizer::ScalarQuantizer()
+    : dot_i8_(kernels::dot_i8_for(kernels::active_isa())),
+      dot_f16_(kernels::dot_f16_for(kernels::active_isa())) {}
+
+size_t ScalarQuantizer::element_size(Quantization type) {
+    switch (type) {
+        case Quantization::Int8: return sizeof(int8_t);
+        case Quantization::Fp16: return sizeof(uint16_t);
+        default: return 0;
+    }
+}
+
+size_t ScalarQuantizer::code_bytes() const {
+    return n_ * stride_ * element_size(type_);
+}
+
+bool ScalarQuantizer::allocate(Quantization type, size_t n, size_t dim, size_t stride) {
+    type_ = type;
+    n_ = n;
+    dim_ = dim;
+    stride_ = stride;
+    codes_ = nullptr;
+    scales_ = nullptr;
+
+    if (!code_storage_.allocate(n * stride * element_size(type))) {
+        return false;
+    }
+    if (type == Quantization::Int8 && !scale_storage_.allocate(dim)) {
+        return false;
+    }
+    codes_ = code_storage_.data();
+    scales_ = scale_storage_.data();
+    return true;
+}
+
+void ScalarQuantizer::encode(const float* matrix, bool parallel) {
+    uint8_t* out = code_storage_.data();
+    const size_t row_bytes = stride_ * element_size(type_);
+
+    if (type_ == Quantization::Fp16) {
+        #pragma omp parallel for if(parallel)
+        for (int64_t i = 0; i < static_cast<int64_t>(n_); ++i) {
+            uint16_t* row = reinterpret_cast<uint16_t*>(out + i * row_bytes);
+            kernels::float_to_half(matrix + i * stride_, row, dim_);
+            std::memset(row + dim_, 0, (stride_ - dim_) * sizeof(uint16_t));
+        }
+        return;
+    }
+
+    // Int8: per-dimension max |x| over all rows, reduced across threads
+    float* scales = scale_storage_.data();
+    std::fill(scales, scales + dim_, 0.0f);
+
+    #pragma omp parallel if(parallel)
+    {
+        std::vector<float> local_max(dim_, 0.0f);
+
+        #pragma omp for nowait
+        for (int64_t i = 0; i < static_cast<int64_t>(n_); ++i) {
+            const float* row = matrix + i * stride_;
+            for (size_t d = 0; d < dim_; ++d) {
+                local_max[d] = std::max(local_max[d], std::fabs(row[d]));
+            }
+        }
+
+        #pragma omp critical
+        for (size_t d = 0; d < dim_; ++d) {
+            scales[d] = std::max(scales[d], local_max[d]);
+        }
+    }
+
+    std::vector<float> inv_scales(dim_);
+    for (size_t d = 0; d < dim_; ++d) {
+        if (scales[d] > 0.0f) {
+            scales[d] /= 127.0f;
+            inv_scales[d] = 1.0f / scales[d];
+        } else {
+            inv_scales[d] = 0.0f;  // Dimension is zero everywhere
+        }
+    }
+
+    #pragma omp parallel for if(parallel)
+    for (int64_t i = 0; i < static_cast<int64_t>(n_); ++i) {
+        const float* row = matrix + i * stride_;
+        int8_t* codes = reinterpret_cast<int8_t*>(out + i * row_bytes);
+        for (size_t d = 0; d < dim_; ++d) {
+            float q = std::nearbyint(row[d] * inv_scales[d]);
+            codes[d] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, q)));
+        }
+        std::memset(codes + dim_, 0, stride_ - dim_);
+    }
+}
+
+void ScalarQuantizer::attach(Quantization type, const void* codes, const float* scales,
+                             size_t n, size_t dim, size_t stride) {
+    code_storage_.reset();
+    scale_storage_.reset();
+    type_ = type;
+    n_ = n;
+    dim_ = dim;
+    stride_ = stride;
+    codes_ = codes;
+    scales_ = scales;
+}
+
+void ScalarQuantizer::prepare_query(const float* query, float* out) const {
+    if (type_ == Quantization::Int8) {
+        for (size_t d = 0; d < dim_; ++d) {
+            out[d] = query[d] * scales_[d];
+        }
+    } else {
+        std::memcpy(out, query, dim_ * sizeof(float));
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "aligned_array.h"
+#include "simd_kernels.h"
+#include <cstdint>
+
+// Compact code type scanned by search()
+enum class Quantization {
+    None,  // Scan the float matrix directly
+    Int8,  // Per-dimension scaled int8 (4x smaller)
+    Fp16,  // IEEE half precision (2x smaller)
+    PQ     // Product quantization, m bytes or nibbles per row (see product_quantizer.h)
+};
+
+const char* quantization_name(Quantization type);
+
+// Scalar quantizer over the finalized embedding matrix.
+//
+//   Int8: symmetric per-dimension scale, x[d] ~= scale[d] * code[d] with
+//         code in [-127, 127]. The scales are folded into the query once per
+//         search, so the scan is a plain float x int8 dot product.
+//   Fp16: IEEE binary16, widened in registers during the scan.
+//
+// Codes use the same row stride (in elements) as the float matrix.
+class ScalarQuantizer {
+public:
+    ScalarQuantizer();
+
+    // Reserve code storage for n rows; returns false on allocation failure
+    bool allocate(Quantization type, size_t n, size_t dim, size_t stride);
+
+    // Train scales (int8) and encode all rows of `matrix`, on an OpenMP team
+    // if `parallel`; requires allocate()
+    void encode(const float* matrix, bool parallel = true);
+
+    // Use codes and scales owned elsewhere, e.g. by a snapshot mapping
+    void attach(Quantization type, const void* codes, const float* scales,
+                size_t n, size_t dim, size_t stride);
+
+    Quantization type() const { return type_; }
+
+    // Transform the query once per search (`out` holds dim floats)
+    void prepare_query(const float* query, float* out) const;
+
+    // Approximate score of row `i` against a prepared query
+    float score(const float* prepared, size_t i) const {
+        if (type_ == Quantization::Int8) {
+            return dot_i8_(prepared, static_cast<const int8_t*>(codes_) + i * stride_, dim_);
+        }
+        return dot_f16_(prepared, static_cast<const uint16_t*>(codes_) + i * stride_, dim_);
+    }
+
+    const void* codes() const { return codes_; }
+    size_t code_bytes() const;
+    const float* scales() const { return scales_; }  // Int8 only, dim floats
+
+    // Bytes per encoded element for `type`
+    static size_t element_size(Quantization type);
+
+private:
+    Quantization type_ = Quantization::None;
+    size_t n_ = 0;
+    size_t dim_ = 0;
+    size_t stride_ = 0;
+
+    AlignedArray<uint8_t> code_storage_;
+    AlignedArray<float> scale_storage_;
+    const void* codes_ = nullptr;
+    const float* scales_ = nullptr;
+
+    kernels::DotI8Fn dot_i8_;
+    kernels::DotF16Fn dot_f16_;
+};
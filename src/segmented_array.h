@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Growable array whose elements never move. Segment s holds BASE << s
+// value-initialized elements and is allocated on first use, so the array
+// costs one small segment until it grows and then doubles at most.
+//
+// Writers only race on publishing a segment pointer (one CAS; the loser
+// frees its copy), so slots claimed with an atomic counter can be filled
+// in parallel without a lock. Slots below a count published with release
+// ordering are safe to read once the reader has acquired that count.
+template <typename T, size_t BASE_LOG2 = 8>
+class SegmentedArray {
+public:
+    static constexpr size_t BASE = size_t(1) << BASE_LOG2;
+    static constexpr size_t MAX_SEGMENTS = 40;  // BASE * (2^40 - 1) elements
+
+    SegmentedArray() {
+        for (auto& segment : segments_) segment.store(nullptr, std::memory_order_relaxed);
+    }
+    ~SegmentedArray() {
+        for (auto& segment : segments_) delete[] segment.load(std::memory_order_relaxed);
+    }
+
+    // Disable copy and move: elements are referenced by address
+    SegmentedArray(const SegmentedArray&) = delete;
+    SegmentedArray& operator=(const SegmentedArray&) = delete;
+
+    // Element i, allocating its segment if needed; nullptr on allocation failure
+    T* ensure(size_t i) {
+        size_t s, offset;
+        locate(i, s, offset);
+        T* segment = segments_[s].load(std::memory_order_acquire);
+        if (!segment) {
+            T* fresh = new (std::nothrow) T[BASE << s]();
+            if (!fresh) {
+                return nullptr;
+            }
+            if (segments_[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+                segment = fresh;
+            } else {
+                delete[] fresh;  // Another writer published first
+            }
+        }
+        return segment + offset;
+    }
+
+    // Element i if its segment has been allocated, else nullptr
+    T* find(size_t i) const {
+        size_t s, offset;
+        locate(i, s, offset);
+        T* segment = segments_[s].load(std::memory_order_acquire);
+        return segment ? segment + offset : nullptr;
+    }
+
+    // Element i; its segment must have been allocated by ensure()
+    T& operator[](size_t i) { return *find(i); }
+    const T& operator[](size_t i) const { return *find(i); }
+
+    // Bytes held by allocated segments
+    size_t allocated_bytes() const {
+        size_t bytes = 0;
+        for (size_t s = 0; s < MAX_SEGMENTS; ++s) {
+            if (segments_[s].load(std::memory_order_relaxed)) bytes += (BASE << s) * sizeof(T);
+        }
+        return bytes;
+    }
+
+private:
+    // Segment s covers indices [BASE * (2^s - 1), BASE * (2^(s+1) - 1))
+    static void locate(size_t i, size_t& segment, size_t& offset) {
+        uint64_t v = (uint64_t(i) >> BASE_LOG2) + 1;
+        #ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanReverse64(&bit, v);
+        segment = bit;
+        #else
+        segment = 63 - __builtin_clzll(v);
+        #endif
+        offset = i - (((size_t(1) << segment) - 1) << BASE_LOG2);
+    }
+
+    std::atomic<T*> segments_[MAX_SEGMENTS];
+};
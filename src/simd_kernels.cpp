@@ -0,0 +1,1032 @@
+#include "simd_kernels.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NVS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define NVS_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Per-function ISA targeting: the rest of the translation unit is compiled
+// for the baseline architecture. MSVC allows intrinsics without it.
+#if defined(__GNUC__) || defined(__clang__)
+#define NVS_TARGET(isa) __attribute__((target(isa)))
+#define NVS_INLINE inline __attribute__((always_inline))
+#else
+#define NVS_TARGET(isa)
+#define NVS_INLINE __forceinline
+#endif
+
+// F16C ships with every AVX2+FMA core, so the AVX2 set relies on it too
+#define NVS_TARGET_AVX2 NVS_TARGET("avx2,fma,f16c")
+#define NVS_TARGET_AVX512 NVS_TARGET("avx512f,avx2,fma,f16c")
+
+namespace kernels {
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar
+// ---------------------------------------------------------------------------
+
+NVS_INLINE float dot_scalar_impl(const float* a, const float* b, size_t n) {
+    // Four independent accumulators break the add dependency chain
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    const size_t blocked = n & ~size_t(3);
+    for (; i < blocked; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i) {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+float dot_scalar(const float* a, const float* b, size_t n) {
+    return dot_scalar_impl(a, b, n);
+}
+
+template <size_t N>
+float dot_scalar_n(const float* a, const float* b, size_t) {
+    return dot_scalar_impl(a, b, N);
+}
+
+void dot4_scalar(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    for (size_t j = 0; j < 4; ++j) {
+        out[j] = dot_scalar(a, b + j * b_stride, n);
+    }
+}
+
+// Branch-free: every position is written, but only survivors advance the count
+NVS_INLINE size_t select_above_tail(const float* scores, size_t i, size_t n, float threshold,
+                                    uint32_t* positions, size_t count) {
+    for (; i < n; ++i) {
+        positions[count] = static_cast<uint32_t>(i);
+        count += scores[i] > threshold;
+    }
+    return count;
+}
+
+size_t select_above_scalar(const float* scores, size_t n, float threshold, uint32_t* positions) {
+    return select_above_tail(scores, 0, n, threshold, positions, 0);
+}
+
+// Appends base + (index of each set bit of `mask`)
+NVS_INLINE size_t append_mask(uint32_t mask, size_t base, uint32_t* positions, size_t count) {
+    while (mask) {
+        #ifdef _MSC_VER
+        unsigned long bit;
+        _BitScanForward(&bit, mask);
+        #else
+        unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+        #endif
+        positions[count++] = static_cast<uint32_t>(base + bit);
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+void scale_scalar(float* v, float s, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        v[i] *= s;
+    }
+}
+
+uint16_t half_from_float_bits(uint32_t x) {
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t raw_exp = (x >> 23) & 0xFF;
+    uint32_t mant = x & 0x7FFFFF;
+    
+    if (raw_exp == 0xFF) {  // Inf / NaN
+        return static_cast<uint16_t>(sign | 0x7C00 | (mant ? 0x200 : 0));
+    }
+    
+    int32_t exp = static_cast<int32_t>(raw_exp) - 127 + 15;
+    if (exp >= 31) {  // Overflow to infinity
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    
+    if (exp <= 0) {  // Subnormal or zero
+        if (exp < -10) return static_cast<uint16_t>(sign);
+        mant |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exp);
+        uint32_t half_mant = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rem > halfway || (rem == halfway && (half_mant & 1))) half_mant++;
+        return static_cast<uint16_t>(sign | half_mant);
+    }
+    
+    uint32_t half = sign | (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) half++;  // Carry into exponent is correct
+    return static_cast<uint16_t>(half);
+}
+
+float half_to_float_scalar(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exp = (h >> 10) & 0x1F;
+    uint32_t mant = h & 0x3FF;
+    uint32_t bits;
+    
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {  // Subnormal: renormalize
+            exp = 127 - 15 + 1;
+            while (!(mant & 0x400)) {
+                mant <<= 1;
+                exp--;
+            }
+            bits = sign | (exp << 23) | ((mant & 0x3FF) << 13);
+        }
+    } else if (exp == 31) {
+        bits = sign | 0x7F800000 | (mant << 13);
+    } else {
+        bits = sign | ((exp + 112) << 23) | (mant << 13);
+    }
+    
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+float dot_i8_scalar(const float* q, const int8_t* c, size_t n) {
+    float s0 = 0.0f, s1 = 0.0f;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        s0 += q[i] * c[i];
+        s1 += q[i + 1] * c[i + 1];
+    }
+    for (; i < n; ++i) {
+        s0 += q[i] * c[i];
+    }
+    return s0 + s1;
+}
+
+float dot_f16_scalar(const float* q, const uint16_t* c, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += q[i] * half_to_float_scalar(c[i]);
+    }
+    return sum;
+}
+
+void to_half_scalar(const float* src, uint16_t* dst, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &src[i], sizeof(bits));
+        dst[i] = half_from_float_bits(bits);
+    }
+}
+
+float pq_adc_scalar(const float* lut, const uint8_t* codes, size_t m) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t j = 0;
+    for (; j + 4 <= m; j += 4) {
+        s0 += lut[j * 256 + codes[j]];
+        s1 += lut[(j + 1) * 256 + codes[j + 1]];
+        s2 += lut[(j + 2) * 256 + codes[j + 2]];
+        s3 += lut[(j + 3) * 256 + codes[j + 3]];
+    }
+    for (; j < m; ++j) {
+        s0 += lut[j * 256 + codes[j]];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+void pq_scan4_scalar(const uint8_t* codes, const uint8_t* lut, size_t m, uint16_t* out) {
+    std::memset(out, 0, 32 * sizeof(uint16_t));
+    for (size_t j = 0; j < m; ++j) {
+        const uint8_t* c = codes + j * 16;
+        const uint8_t* table = lut + j * 16;
+        for (size_t b = 0; b < 16; ++b) {
+            out[b] += table[c[b] & 15];
+            out[b + 16] += table[c[b] >> 4];
+        }
+    }
+}
+
+#ifdef NVS_X86
+
+// ---------------------------------------------------------------------------
+// SSE (x86-64 baseline)
+// ---------------------------------------------------------------------------
+
+NVS_INLINE float hsum128(__m128 v) {
+    __m128 shuf = _mm_movehl_ps(v, v);
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_shuffle_ps(sums, sums, 0x55);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+NVS_INLINE float dot_sse_impl(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps(), acc3 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    float sum = hsum128(_mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float dot_sse(const float* a, const float* b, size_t n) {
+    return dot_sse_impl(a, b, n);
+}
+
+template <size_t N>
+float dot_sse_n(const float* a, const float* b, size_t) {
+    return dot_sse_impl(a, b, N);
+}
+
+void dot4_sse(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    for (size_t j = 0; j < 4; ++j) {
+        out[j] = dot_sse(a, b + j * b_stride, n);
+    }
+}
+
+void scale_sse(float* v, float s, size_t n) {
+    __m128 vs = _mm_set1_ps(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(v + i, _mm_mul_ps(_mm_loadu_ps(v + i), vs));
+    }
+    for (; i < n; ++i) {
+        v[i] *= s;
+    }
+}
+
+size_t select_above_sse(const float* scores, size_t n, float threshold, uint32_t* positions) {
+    const __m128 vt = _mm_set1_ps(threshold);
+    size_t count = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const int mask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(scores + i), vt));
+        count = append_mask(static_cast<uint32_t>(mask), i, positions, count);
+    }
+    return select_above_tail(scores, i, n, threshold, positions, count);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA
+// ---------------------------------------------------------------------------
+
+NVS_TARGET_AVX2 NVS_INLINE float hsum256(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum128(_mm_add_ps(lo, hi));
+}
+
+NVS_TARGET_AVX2 NVS_INLINE float dot_avx2_impl(const float* a, const float* b, size_t n) {
+    // Four accumulators cover the 4-cycle FMA latency on current cores
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+        acc2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), acc2);
+        acc3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), acc3);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+    float sum = hsum256(_mm256_add_ps(_mm256_add_ps(acc0, acc1), _mm256_add_ps(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX2 float dot_avx2(const float* a, const float* b, size_t n) {
+    return dot_avx2_impl(a, b, n);
+}
+
+template <size_t N>
+NVS_TARGET_AVX2 float dot_avx2_n(const float* a, const float* b, size_t) {
+    return dot_avx2_impl(a, b, N);
+}
+
+NVS_TARGET_AVX2 void dot4_avx2(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    // One load of `a` feeds four FMAs: the row is read once for four queries
+    const float* b0 = b;
+    const float* b1 = b + b_stride;
+    const float* b2 = b + 2 * b_stride;
+    const float* b3 = b + 3 * b_stride;
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    __m256 acc2 = _mm256_setzero_ps(), acc3 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 va = _mm256_loadu_ps(a + i);
+        acc0 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b0 + i), acc0);
+        acc1 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b1 + i), acc1);
+        acc2 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b2 + i), acc2);
+        acc3 = _mm256_fmadd_ps(va, _mm256_loadu_ps(b3 + i), acc3);
+    }
+    out[0] = hsum256(acc0);
+    out[1] = hsum256(acc1);
+    out[2] = hsum256(acc2);
+    out[3] = hsum256(acc3);
+    for (; i < n; ++i) {
+        out[0] += a[i] * b0[i];
+        out[1] += a[i] * b1[i];
+        out[2] += a[i] * b2[i];
+        out[3] += a[i] * b3[i];
+    }
+}
+
+NVS_TARGET_AVX2 void scale_avx2(float* v, float s, size_t n) {
+    __m256 vs = _mm256_set1_ps(s);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(v + i, _mm256_mul_ps(_mm256_loadu_ps(v + i), vs));
+    }
+    for (; i < n; ++i) {
+        v[i] *= s;
+    }
+}
+
+NVS_TARGET_AVX2 float dot_i8_avx2(const float* q, const int8_t* c, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+        __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(codes));
+        __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(codes, 8)));
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), lo, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i + 8), hi, acc1);
+    }
+    float sum = hsum256(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * c[i];
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX2 float dot_f16_avx2(const float* q, const uint16_t* c, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 lo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i)));
+        __m256 hi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i + 8)));
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i), lo, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(q + i + 8), hi, acc1);
+    }
+    float sum = hsum256(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * half_to_float_scalar(c[i]);
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX2 void to_half_avx2(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+    to_half_scalar(src + i, dst + i, n - i);
+}
+
+NVS_TARGET_AVX2 size_t select_above_avx2(const float* scores, size_t n, float threshold, uint32_t* positions) {
+    const __m256 vt = _mm256_set1_ps(threshold);
+    size_t count = 0, i = 0;
+    for (; i + 16 <= n; i += 16) {
+        // Two compares per test: below-threshold blocks cost one branch per 16 scores
+        const int lo = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + i), vt, _CMP_GT_OQ));
+        const int hi = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + i + 8), vt, _CMP_GT_OQ));
+        const uint32_t mask = static_cast<uint32_t>(lo | (hi << 8));
+        if (mask) count = append_mask(mask, i, positions, count);
+    }
+    for (; i + 8 <= n; i += 8) {
+        const int mask = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(scores + i), vt, _CMP_GT_OQ));
+        count = append_mask(static_cast<uint32_t>(mask), i, positions, count);
+    }
+    return select_above_tail(scores, i, n, threshold, positions, count);
+}
+
+NVS_TARGET_AVX2 float pq_adc_avx2(const float* lut, const uint8_t* codes, size_t m) {
+    // Eight table lookups per gather, at j * 256 + codes[j]
+    const __m256i step = _mm256_set1_epi32(8 * 256);
+    __m256i base = _mm256_setr_epi32(0, 256, 512, 768, 1024, 1280, 1536, 1792);
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t j = 0;
+    for (; j + 16 <= m; j += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + j));
+        const __m256i i0 = _mm256_add_epi32(base, _mm256_cvtepu8_epi32(c));
+        base = _mm256_add_epi32(base, step);
+        const __m256i i1 = _mm256_add_epi32(base, _mm256_cvtepu8_epi32(_mm_srli_si128(c, 8)));
+        base = _mm256_add_epi32(base, step);
+        acc0 = _mm256_add_ps(acc0, _mm256_i32gather_ps(lut, i0, 4));
+        acc1 = _mm256_add_ps(acc1, _mm256_i32gather_ps(lut, i1, 4));
+    }
+    for (; j + 8 <= m; j += 8) {
+        const __m128i c = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + j));
+        acc0 = _mm256_add_ps(acc0, _mm256_i32gather_ps(lut, _mm256_add_epi32(base, _mm256_cvtepu8_epi32(c)), 4));
+        base = _mm256_add_epi32(base, step);
+    }
+    float sum = hsum256(_mm256_add_ps(acc0, acc1));
+    for (; j < m; ++j) {
+        sum += lut[j * 256 + codes[j]];
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX2 void pq_scan4_avx2(const uint8_t* codes, const uint8_t* lut, size_t m, uint16_t* out) {
+    // The low lane looks up rows 0-15 (low nibbles), the high lane rows 16-31
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc_lo = zero, acc_hi = zero;
+    for (size_t j = 0; j < m; ++j) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + j * 16));
+        const __m256i both = _mm256_inserti128_si256(_mm256_castsi128_si256(c), _mm_srli_epi16(c, 4), 1);
+        const __m256i table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lut + j * 16)));
+        const __m256i d = _mm256_shuffle_epi8(table, _mm256_and_si256(both, low_nibble));
+        acc_lo = _mm256_add_epi16(acc_lo, _mm256_unpacklo_epi8(d, zero));
+        acc_hi = _mm256_add_epi16(acc_hi, _mm256_unpackhi_epi8(d, zero));
+    }
+    // acc_lo holds rows 0-7 | 16-23 and acc_hi rows 8-15 | 24-31
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(acc_lo, acc_hi, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16), _mm256_permute2x128_si256(acc_lo, acc_hi, 0x31));
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512F
+// ---------------------------------------------------------------------------
+
+NVS_TARGET_AVX512 NVS_INLINE float dot_avx512_impl(const float* a, const float* b, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+        acc2 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 32), _mm512_loadu_ps(b + i + 32), acc2);
+        acc3 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 48), _mm512_loadu_ps(b + i + 48), acc3);
+    }
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < n) {
+        // Masked tail: no scalar epilogue needed
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                               _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(_mm512_add_ps(acc0, acc1), _mm512_add_ps(acc2, acc3)));
+}
+
+NVS_TARGET_AVX512 float dot_avx512(const float* a, const float* b, size_t n) {
+    return dot_avx512_impl(a, b, n);
+}
+
+template <size_t N>
+NVS_TARGET_AVX512 float dot_avx512_n(const float* a, const float* b, size_t) {
+    return dot_avx512_impl(a, b, N);
+}
+
+NVS_TARGET_AVX512 void dot4_avx512(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    const float* b0 = b;
+    const float* b1 = b + b_stride;
+    const float* b2 = b + 2 * b_stride;
+    const float* b3 = b + 3 * b_stride;
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    __m512 acc2 = _mm512_setzero_ps(), acc3 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512 va = _mm512_loadu_ps(a + i);
+        acc0 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b0 + i), acc0);
+        acc1 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b1 + i), acc1);
+        acc2 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b2 + i), acc2);
+        acc3 = _mm512_fmadd_ps(va, _mm512_loadu_ps(b3 + i), acc3);
+    }
+    if (i < n) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        __m512 va = _mm512_maskz_loadu_ps(mask, a + i);
+        acc0 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b0 + i), acc0);
+        acc1 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b1 + i), acc1);
+        acc2 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b2 + i), acc2);
+        acc3 = _mm512_fmadd_ps(va, _mm512_maskz_loadu_ps(mask, b3 + i), acc3);
+    }
+    out[0] = _mm512_reduce_add_ps(acc0);
+    out[1] = _mm512_reduce_add_ps(acc1);
+    out[2] = _mm512_reduce_add_ps(acc2);
+    out[3] = _mm512_reduce_add_ps(acc3);
+}
+
+NVS_TARGET_AVX512 void scale_avx512(float* v, float s, size_t n) {
+    __m512 vs = _mm512_set1_ps(s);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(v + i, _mm512_mul_ps(_mm512_loadu_ps(v + i), vs));
+    }
+    if (i < n) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_ps(v + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, v + i), vs));
+    }
+}
+
+NVS_TARGET_AVX512 float dot_i8_avx512(const float* q, const int8_t* c, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 lo = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i))));
+        __m512 hi = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i + 16))));
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i), lo, acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i + 16), hi, acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i))));
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i), v, acc0);
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * c[i];
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX512 float dot_f16_avx512(const float* q, const uint16_t* c, size_t n) {
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m512 lo = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i)));
+        __m512 hi = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i + 16)));
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i), lo, acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i + 16), hi, acc1);
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m512 v = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i)));
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(q + i), v, acc0);
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * half_to_float_scalar(c[i]);
+    }
+    return sum;
+}
+
+NVS_TARGET_AVX512 size_t select_above_avx512(const float* scores, size_t n, float threshold,
+                                            uint32_t* positions) {
+    // Compress-store the positions of the survivors directly
+    const __m512 vt = _mm512_set1_ps(threshold);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    size_t count = 0, i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(scores + i), vt, _CMP_GT_OQ);
+        if (mask) {
+            _mm512_mask_compressstoreu_epi32(positions + count, mask, index);
+            #ifdef _MSC_VER
+            count += __popcnt(mask);
+            #else
+            count += static_cast<size_t>(__builtin_popcount(mask));
+            #endif
+        }
+        index = _mm512_add_epi32(index, step);
+    }
+    return select_above_tail(scores, i, n, threshold, positions, count);
+}
+
+NVS_TARGET_AVX512 float pq_adc_avx512(const float* lut, const uint8_t* codes, size_t m) {
+    // Sixteen table lookups per gather, at j * 256 + codes[j]
+    const __m512i step = _mm512_set1_epi32(16 * 256);
+    __m512i base = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                      _mm512_set1_epi32(256));
+    __m512 acc0 = _mm512_setzero_ps(), acc1 = _mm512_setzero_ps();
+    size_t j = 0;
+    for (; j + 32 <= m; j += 32) {
+        const __m512i i0 = _mm512_add_epi32(base, _mm512_cvtepu8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + j))));
+        base = _mm512_add_epi32(base, step);
+        const __m512i i1 = _mm512_add_epi32(base, _mm512_cvtepu8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + j + 16))));
+        base = _mm512_add_epi32(base, step);
+        acc0 = _mm512_add_ps(acc0, _mm512_i32gather_ps(i0, lut, 4));
+        acc1 = _mm512_add_ps(acc1, _mm512_i32gather_ps(i1, lut, 4));
+    }
+    for (; j + 16 <= m; j += 16) {
+        const __m512i i0 = _mm512_add_epi32(base, _mm512_cvtepu8_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + j))));
+        base = _mm512_add_epi32(base, step);
+        acc0 = _mm512_add_ps(acc0, _mm512_i32gather_ps(i0, lut, 4));
+    }
+    float sum = _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+    for (; j < m; ++j) {
+        sum += lut[j * 256 + codes[j]];
+    }
+    return sum;
+}
+
+// ---------------------------------------------------------------------------
+// CPU feature detection
+// ---------------------------------------------------------------------------
+
+#ifdef _MSC_VER
+bool cpu_has_avx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool f16c = (info[2] & (1 << 29)) != 0;
+    if (!fma || !osxsave || !f16c) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;  // OS saves XMM/YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+bool cpu_has_avx512f() {
+    if (!cpu_has_avx2()) return false;
+    if ((_xgetbv(0) & 0xE6) != 0xE6) return false;  // OS saves ZMM/opmask state
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+}
+#else
+bool cpu_has_avx2() {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+bool cpu_has_avx512f() {
+    return cpu_has_avx2() && __builtin_cpu_supports("avx512f");
+}
+#endif
+
+#endif  // NVS_X86
+
+#ifdef NVS_NEON
+
+// ---------------------------------------------------------------------------
+// NEON (always available on AArch64)
+// ---------------------------------------------------------------------------
+
+NVS_INLINE float dot_neon_impl(const float* a, const float* b, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc2 = vfmaq_f32(acc2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+        acc3 = vfmaq_f32(acc3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    float sum = vaddvq_f32(vaddq_f32(vaddq_f32(acc0, acc1), vaddq_f32(acc2, acc3)));
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float dot_neon(const float* a, const float* b, size_t n) {
+    return dot_neon_impl(a, b, n);
+}
+
+template <size_t N>
+float dot_neon_n(const float* a, const float* b, size_t) {
+    return dot_neon_impl(a, b, N);
+}
+
+void dot4_neon(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    const float* b0 = b;
+    const float* b1 = b + b_stride;
+    const float* b2 = b + 2 * b_stride;
+    const float* b3 = b + 3 * b_stride;
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    float32x4_t acc2 = vdupq_n_f32(0.0f), acc3 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t va = vld1q_f32(a + i);
+        acc0 = vfmaq_f32(acc0, va, vld1q_f32(b0 + i));
+        acc1 = vfmaq_f32(acc1, va, vld1q_f32(b1 + i));
+        acc2 = vfmaq_f32(acc2, va, vld1q_f32(b2 + i));
+        acc3 = vfmaq_f32(acc3, va, vld1q_f32(b3 + i));
+    }
+    out[0] = vaddvq_f32(acc0);
+    out[1] = vaddvq_f32(acc1);
+    out[2] = vaddvq_f32(acc2);
+    out[3] = vaddvq_f32(acc3);
+    for (; i < n; ++i) {
+        out[0] += a[i] * b0[i];
+        out[1] += a[i] * b1[i];
+        out[2] += a[i] * b2[i];
+        out[3] += a[i] * b3[i];
+    }
+}
+
+void scale_neon(float* v, float s, size_t n) {
+    float32x4_t vs = vdupq_n_f32(s);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1q_f32(v + i, vmulq_f32(vld1q_f32(v + i), vs));
+    }
+    for (; i < n; ++i) {
+        v[i] *= s;
+    }
+}
+
+float dot_i8_neon(const float* q, const int8_t* c, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t wide = vmovl_s8(vld1_s8(c + i));
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(wide)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(wide)));
+        acc0 = vfmaq_f32(acc0, vld1q_f32(q + i), lo);
+        acc1 = vfmaq_f32(acc1, vld1q_f32(q + i + 4), hi);
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * c[i];
+    }
+    return sum;
+}
+
+float dot_f16_neon(const float* q, const uint16_t* c, size_t n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t lo = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(c + i)));
+        float32x4_t hi = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(c + i + 4)));
+        acc0 = vfmaq_f32(acc0, vld1q_f32(q + i), lo);
+        acc1 = vfmaq_f32(acc1, vld1q_f32(q + i + 4), hi);
+    }
+    float sum = vaddvq_f32(vaddq_f32(acc0, acc1));
+    for (; i < n; ++i) {
+        sum += q[i] * half_to_float_scalar(c[i]);
+    }
+    return sum;
+}
+
+void to_half_neon(const float* src, uint16_t* dst, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+    }
+    to_half_scalar(src + i, dst + i, n - i);
+}
+
+size_t select_above_neon(const float* scores, size_t n, float threshold, uint32_t* positions) {
+    const float32x4_t vt = vdupq_n_f32(threshold);
+    const uint32_t lane_bits[4] = {1, 2, 4, 8};
+    const uint32x4_t bits = vld1q_u32(lane_bits);
+    size_t count = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint32_t mask = vaddvq_u32(vandq_u32(vcgtq_f32(vld1q_f32(scores + i), vt), bits));
+        count = append_mask(mask, i, positions, count);
+    }
+    return select_above_tail(scores, i, n, threshold, positions, count);
+}
+
+void pq_scan4_neon(const uint8_t* codes, const uint8_t* lut, size_t m, uint16_t* out) {
+    const uint8x16_t low_nibble = vdupq_n_u8(0x0F);
+    uint16x8_t acc0 = vdupq_n_u16(0), acc1 = vdupq_n_u16(0);  // Rows 0-7, 8-15
+    uint16x8_t acc2 = vdupq_n_u16(0), acc3 = vdupq_n_u16(0);  // Rows 16-23, 24-31
+    for (size_t j = 0; j < m; ++j) {
+        const uint8x16_t c = vld1q_u8(codes + j * 16);
+        const uint8x16_t table = vld1q_u8(lut + j * 16);
+        const uint8x16_t lo = vqtbl1q_u8(table, vandq_u8(c, low_nibble));
+        const uint8x16_t hi = vqtbl1q_u8(table, vshrq_n_u8(c, 4));
+        acc0 = vaddw_u8(acc0, vget_low_u8(lo));
+        acc1 = vaddw_u8(acc1, vget_high_u8(lo));
+        acc2 = vaddw_u8(acc2, vget_low_u8(hi));
+        acc3 = vaddw_u8(acc3, vget_high_u8(hi));
+    }
+    vst1q_u16(out, acc0);
+    vst1q_u16(out + 8, acc1);
+    vst1q_u16(out + 16, acc2);
+    vst1q_u16(out + 24, acc3);
+}
+
+#endif  // NVS_NEON
+
+// ---------------------------------------------------------------------------
+// Dispatch tables
+// ---------------------------------------------------------------------------
+
+// Embedding sizes with fully specialized kernels
+constexpr size_t FIXED_DIMS[] = {384, 768, 1024, 1536, 3072};
+constexpr size_t NUM_FIXED = sizeof(FIXED_DIMS) / sizeof(FIXED_DIMS[0]);
+
+using ToHalfFn = void (*)(const float* src, uint16_t* dst, size_t n);
+
+struct KernelSet {
+    DotFn dot;
+    ScaleFn scale;
+    DotFn fixed[NUM_FIXED];  // Parallel to FIXED_DIMS
+    DotI8Fn dot_i8;
+    DotF16Fn dot_f16;
+    ToHalfFn to_half;
+    Dot4Fn dot4;
+    AboveFn select_above;
+    PqAdcFn pq_adc;
+    PqScan4Fn pq_scan4;
+};
+
+#define NVS_FIXED_SET(name) \
+    { name<384>, name<768>, name<1024>, name<1536>, name<3072> }
+
+const KernelSet SCALAR_SET = {dot_scalar, scale_scalar, NVS_FIXED_SET(dot_scalar_n),
+                              dot_i8_scalar, dot_f16_scalar, to_half_scalar, dot4_scalar,
+                              select_above_scalar, pq_adc_scalar, pq_scan4_scalar};
+#ifdef NVS_X86
+// Baseline SSE2 has no cheap int8/fp16 widening, gathers or byte shuffles, so
+// quantized kernels stay scalar
+const KernelSet SSE_SET = {dot_sse, scale_sse, NVS_FIXED_SET(dot_sse_n),
+                           dot_i8_scalar, dot_f16_scalar, to_half_scalar, dot4_sse,
+                           select_above_sse, pq_adc_scalar, pq_scan4_scalar};
+const KernelSet AVX2_SET = {dot_avx2, scale_avx2, NVS_FIXED_SET(dot_avx2_n),
+                            dot_i8_avx2, dot_f16_avx2, to_half_avx2, dot4_avx2,
+                            select_above_avx2, pq_adc_avx2, pq_scan4_avx2};
+const KernelSet AVX512_SET = {dot_avx512, scale_avx512, NVS_FIXED_SET(dot_avx512_n),
+                              dot_i8_avx512, dot_f16_avx512, to_half_avx2, dot4_avx512,
+                              select_above_avx512, pq_adc_avx512, pq_scan4_avx2};
+#endif
+#ifdef NVS_NEON
+const KernelSet NEON_SET = {dot_neon, scale_neon, NVS_FIXED_SET(dot_neon_n),
+                            dot_i8_neon, dot_f16_neon, to_half_neon, dot4_neon,
+                            select_above_neon, pq_adc_scalar, pq_scan4_neon};
+#endif
+
+#undef NVS_FIXED_SET
+
+const KernelSet& kernel_set(Isa isa) {
+    if (!isa_supported(isa)) return SCALAR_SET;
+    switch (isa) {
+        #ifdef NVS_X86
+        case Isa::SSE: return SSE_SET;
+        case Isa::AVX2: return AVX2_SET;
+        case Isa::AVX512: return AVX512_SET;
+        #endif
+        #ifdef NVS_NEON
+        case Isa::NEON: return NEON_SET;
+        #endif
+        default: return SCALAR_SET;
+    }
+}
+
+Isa detect_isa() {
+    Isa best = Isa::Scalar;
+    #ifdef NVS_X86
+    best = cpu_has_avx512f() ? Isa::AVX512 : cpu_has_avx2() ? Isa::AVX2 : Isa::SSE;
+    #elif defined(NVS_NEON)
+    best = Isa::NEON;
+    #endif
+
+    // Optional override, e.g. NVS_SIMD=avx2 for benchmarking; ignored if unsupported
+    if (const char* forced = std::getenv("NVS_SIMD")) {
+        const Isa all[] = {Isa::Scalar, Isa::SSE, Isa::AVX2, Isa::AVX512, Isa::NEON};
+        for (Isa isa : all) {
+            if (std::strcmp(forced, isa_name(isa)) == 0 && isa_supported(isa)) {
+                return isa;
+            }
+        }
+    }
+    return best;
+}
+
+const KernelSet& active_set() {
+    static const KernelSet& set = kernel_set(active_isa());
+    return set;
+}
+
+}  // namespace
+
+bool isa_supported(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return true;
+        #ifdef NVS_X86
+        case Isa::SSE: return true;
+        case Isa::AVX2: return cpu_has_avx2();
+        case Isa::AVX512: return cpu_has_avx512f();
+        #endif
+        #ifdef NVS_NEON
+        case Isa::NEON: return true;
+        #endif
+        default: return false;
+    }
+}
+
+Isa active_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return "scalar";
+        case Isa::SSE: return "sse";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+        case Isa::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+DotFn dot_for(Isa isa, size_t dim) {
+    const KernelSet& set = kernel_set(isa);
+    for (size_t i = 0; i < NUM_FIXED; ++i) {
+        if (FIXED_DIMS[i] == dim) return set.fixed[i];
+    }
+    return set.dot;
+}
+
+DotFn dot_for_dim(size_t dim) {
+    return dot_for(active_isa(), dim);
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    return active_set().dot(a, b, n);
+}
+
+Dot4Fn dot4_for(Isa isa) {
+    return kernel_set(isa).dot4;
+}
+
+void dot4(const float* a, const float* b, size_t b_stride, size_t n, float* out) {
+    active_set().dot4(a, b, b_stride, n, out);
+}
+
+DotI8Fn dot_i8_for(Isa isa) {
+    return kernel_set(isa).dot_i8;
+}
+
+DotF16Fn dot_f16_for(Isa isa) {
+    return kernel_set(isa).dot_f16;
+}
+
+float dot_i8(const float* q, const int8_t* codes, size_t n) {
+    return active_set().dot_i8(q, codes, n);
+}
+
+float dot_f16(const float* q, const uint16_t* codes, size_t n) {
+    return active_set().dot_f16(q, codes, n);
+}
+
+AboveFn select_above_for(Isa isa) {
+    return kernel_set(isa).select_above;
+}
+
+size_t select_above(const float* scores, size_t n, float threshold, uint32_t* positions) {
+    return active_set().select_above(scores, n, threshold, positions);
+}
+
+PqAdcFn pq_adc_for(Isa isa) {
+    return kernel_set(isa).pq_adc;
+}
+
+PqScan4Fn pq_scan4_for(Isa isa) {
+    return kernel_set(isa).pq_scan4;
+}
+
+uint16_t float_to_half(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return half_from_float_bits(bits);
+}
+
+float half_to_float(uint16_t h) {
+    return half_to_float_scalar(h);
+}
+
+void float_to_half(const float* src, uint16_t* dst, size_t n) {
+    active_set().to_half(src, dst, n);
+}
+
+void normalize(float* v, size_t n) {
+    const KernelSet& set = active_set();
+    float sum = set.dot(v, v, n);
+    if (sum > 1e-10f) {  // Avoid division by zero
+        set.scale(v, 1.0f / std::sqrt(sum), n);
+    }
+}
+
+}  // namespace kernels
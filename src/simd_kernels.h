@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Hand-vectorized float kernels with runtime ISA dispatch.
+//
+// The best instruction set is picked once via CPUID (or is fixed at compile
+// time on ARM), so prebuilt binaries no longer need -march=native. Set the
+// NVS_SIMD environment variable to "scalar", "sse", "avx2", "avx512" or
+// "neon" to force a specific (supported) kernel set.
+//
+// Kernels accept unaligned pointers and any length; dimensions commonly used
+// by embedding models get fully specialized versions with a constant trip count.
+namespace kernels {
+
+enum class Isa {
+    Scalar,
+    SSE,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+using DotFn = float (*)(const float* a, const float* b, size_t n);
+using ScaleFn = void (*)(float* v, float s, size_t n);
+
+// out[j] = dot(a, b + j * b_stride) for j = 0..3, loading `a` once
+using Dot4Fn = void (*)(const float* a, const float* b, size_t b_stride, size_t n, float* out);
+
+// Mixed-precision dot products for quantized storage: float query x compact codes
+using DotI8Fn = float (*)(const float* q, const int8_t* codes, size_t n);
+using DotF16Fn = float (*)(const float* q, const uint16_t* codes, size_t n);
+
+// Writes the positions j < n with scores[j] > threshold to `positions` (room
+// for n) in increasing order and returns how many there are
+using AboveFn = size_t (*)(const float* scores, size_t n, float threshold, uint32_t* positions);
+
+// Product quantization lookups (see product_quantizer.h). ADC: the sum over
+// j < m of lut[j * 256 + codes[j]], one row's 8-bit codes against a query table.
+using PqAdcFn = float (*)(const float* lut, const uint8_t* codes, size_t m);
+
+// 4-bit fast-scan over one block of 32 rows: out[r] = sum over j < m of
+// lut[j * 16 + code of row r in subspace j]. Byte j * 16 + b of `codes` holds
+// row b in its low nibble and row b + 16 in its high one; `lut` is m x 16
+// byte-quantized entries whose sum must fit in 16 bits.
+using PqScan4Fn = void (*)(const uint8_t* codes, const uint8_t* lut, size_t m, uint16_t* out);
+
+// Is the kernel set usable on this CPU/build?
+bool isa_supported(Isa isa);
+
+// Kernel set selected for this process
+Isa active_isa();
+
+const char* isa_name(Isa isa);
+
+// Dot product kernel for `isa`, specialized for `dim` when a fixed-size
+// version exists. Falls back to scalar if `isa` is unsupported.
+DotFn dot_for(Isa isa, size_t dim);
+
+// Same as dot_for(active_isa(), dim)
+DotFn dot_for_dim(size_t dim);
+
+// Generic dot product using the active kernel set
+float dot(const float* a, const float* b, size_t n);
+
+// Four dot products sharing one operand (blocked multi-query scans)
+Dot4Fn dot4_for(Isa isa);
+void dot4(const float* a, const float* b, size_t b_stride, size_t n, float* out);
+
+// L2-normalize `v` in place (vectors with norm^2 <= 1e-10 are left untouched)
+void normalize(float* v, size_t n);
+
+// Quantized dot product kernels for `isa` (scalar if unsupported)
+DotI8Fn dot_i8_for(Isa isa);
+DotF16Fn dot_f16_for(Isa isa);
+
+// Quantized dot products using the active kernel set
+float dot_i8(const float* q, const int8_t* codes, size_t n);
+float dot_f16(const float* q, const uint16_t* codes, size_t n);
+
+// Score filter for top-k selection: one vector compare per 4-16 scores
+AboveFn select_above_for(Isa isa);
+size_t select_above(const float* scores, size_t n, float threshold, uint32_t* positions);
+
+// PQ kernels for `isa`: gathers for ADC, byte shuffles for 4-bit fast-scan
+// (scalar where the instruction set has neither)
+PqAdcFn pq_adc_for(Isa isa);
+PqScan4Fn pq_scan4_for(Isa isa);
+
+// IEEE 754 binary16 conversion (round to nearest even)
+uint16_t float_to_half(float f);
+float half_to_float(uint16_t h);
+void float_to_half(const float* src, uint16_t* dst, size_t n);
+
+}  // namespace kernels
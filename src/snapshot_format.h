@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+// On-disk layout of a VectorStore snapshot (native byte order):
+//
+//   [Header][Section x section_count][payload][payload]...
+//
+// Every payload starts on a 64-byte boundary so that, once the file is
+// memory-mapped, embeddings can be used in place for SIMD scans.
+//
+// Documents are always stored in entry order. Embedding rows are too, unless
+// SECTION_ROW_IDS is present (IVF stores keep rows grouped by list).
+namespace snapshot {
+
+constexpr char MAGIC[8] = {'N', 'V', 'S', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t VERSION = 2;
+constexpr size_t ALIGNMENT = 64;
+
+enum SectionType : uint32_t {
+    SECTION_EMBEDDINGS = 1,  // count x stride floats, normalized, zero row padding
+    SECTION_DOCUMENTS = 2,   // count x DocRecord
+    SECTION_STRINGS = 3,     // id/text/metadata bytes, each null-terminated
+    SECTION_INT8_CODES = 4,  // count x stride int8 codes (optional)
+    SECTION_INT8_SCALES = 5, // dim floats, per-dimension int8 scales (optional)
+    SECTION_FP16_CODES = 6,  // count x stride binary16 codes (optional)
+    SECTION_HNSW_META = 7,   // HnswRecord (optional, with the three graph sections below)
+    SECTION_HNSW_LEVEL0 = 8, // count x (1 + 2M) uint32 layer-0 link blocks
+    SECTION_HNSW_UPPER_OFFSETS = 9,  // count + 1 uint64 offsets into SECTION_HNSW_UPPER
+    SECTION_HNSW_UPPER = 10, // (1 + M) uint32 link blocks for layers above 0
+    SECTION_ROW_IDS = 11,    // count uint32 entry index per embedding row (rows permuted)
+    SECTION_IVF_CENTROIDS = 12,  // nlist x stride floats
+    SECTION_IVF_LISTS = 13,  // nlist + 1 uint64 row offsets into the embeddings
+    SECTION_PQ_META = 14,    // PqRecord (optional, with the two PQ sections below)
+    SECTION_PQ_CODEBOOKS = 15,  // m x 2^bits x ceil(dim / m) floats
+    SECTION_PQ_CODES = 16,   // count x m bytes (8-bit) or 32-row blocks of m x 16 bytes (4-bit)
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t dim;
+    uint64_t stride;  // Floats per embedding row
+    uint64_t count;
+    uint64_t file_size;
+};
+
+struct Section {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;  // Absolute file offset of the payload
+    uint64_t size;    // Payload size in bytes
+};
+
+// Offsets are relative to the start of the strings section
+struct DocRecord {
+    uint64_t id_offset;
+    uint64_t id_size;
+    uint64_t text_offset;
+    uint64_t text_size;
+    uint64_t meta_offset;
+    uint64_t meta_size;
+};
+
+// HNSW graph parameters needed to interpret the link sections
+struct HnswRecord {
+    uint64_t M;
+    uint64_t entry_point;
+    uint64_t max_level;
+    uint64_t reserved;
+};
+
+// Product quantizer shape needed to interpret the PQ sections
+struct PqRecord {
+    uint64_t m;
+    uint64_t bits;
+    uint64_t reserved[2];
+};
+
+inline size_t align_up(size_t value, size_t align = ALIGNMENT) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+}  // namespace snapshot
@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <simdjson.h>
+
+// Always-on counters and histograms for loads and searches. Every update is a
+// relaxed atomic add on data that is otherwise only read by stats(), so the
+// cost is a few nanoseconds per document or query. Build with
+// -DNVS_NO_STATS to compile all of it out (stats() then reports zeros and
+// enabled = false).
+#ifdef NVS_NO_STATS
+constexpr bool STATS_ENABLED = false;
+#else
+constexpr bool STATS_ENABLED = true;
+#endif
+
+// Search latency buckets: bucket b counts searches that took [2^(b-1), 2^b)
+// microseconds (bucket 0: under 1us; the last bucket holds everything slower)
+constexpr size_t LATENCY_BUCKETS = 24;
+
+inline uint64_t stats_now_ns() {
+    if constexpr (!STATS_ENABLED) return 0;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Point-in-time copy of StatsCounters, returned by VectorStore::stats()
+struct StoreStats {
+    bool enabled = STATS_ENABLED;
+
+    // Loading. Phase times are summed over the threads that ran them, so they
+    // can exceed wall time; parse includes the add_document() calls it makes.
+    uint64_t read_ns = 0;            // Loader I/O threads reading files
+    uint64_t parse_ns = 0;           // Loader parser threads working on files and chunks
+    uint64_t add_ns = 0;             // Inside add_document() / upsert(), from any caller
+    uint64_t finalize_ns = 0;        // Wall time of finalize()
+    uint64_t bytes_read = 0;         // File bytes read by the loader
+    uint64_t files_read = 0;
+    uint64_t documents_added = 0;
+    uint64_t documents_rejected = 0; // By the loader or add_document(); see rejected_by_error
+    uint64_t rejected_by_error[simdjson::NUM_ERROR_CODES] = {};
+
+    // Memory
+    size_t arena_reserved_bytes = 0;  // Mapped for document payloads
+    size_t arena_used_bytes = 0;      // Handed out of those mappings
+    size_t query_cache_bytes = 0;     // Held by the query result cache
+    size_t query_cache_entries = 0;
+
+    // Searching (search(), search_batch() and text_search() calls)
+    uint64_t searches = 0;
+    uint64_t search_ns = 0;                    // Summed latency
+    uint64_t latency_histogram[LATENCY_BUCKETS] = {};
+    uint64_t rows_scanned = 0;                 // Rows scored by scans, delta segment included
+    uint64_t graph_searches = 0;               // Answered by an HNSW walk instead of a scan
+    uint64_t parallel_scans = 0;               // Scans that ran on an OpenMP team
+    uint64_t lock_waits = 0;                   // Searches that found search_mutex_ held by compact()
+    uint64_t lock_wait_ns = 0;                 // Time those searches waited for it
+    uint64_t cache_hits = 0;                   // search()/search_range() answered by the query cache
+    uint64_t cache_misses = 0;                 // Looked up in the query cache and computed
+    int omp_threads = 0;                       // OpenMP team size used by parallel scans and finalize()
+};
+
+// Live counters owned by VectorStore; updated from any thread
+class StatsCounters {
+public:
+    using Counter = std::atomic<uint64_t>;
+
+    static void add(Counter& counter, uint64_t value) {
+        if constexpr (STATS_ENABLED) counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void reject(simdjson::error_code error) {
+        add(documents_rejected, 1);
+        if (static_cast<size_t>(error) < simdjson::NUM_ERROR_CODES) add(rejected_by_error[error], 1);
+    }
+
+    // Count an add_document()/upsert() outcome; returns `error` unchanged
+    simdjson::error_code count_add(simdjson::error_code error) {
+        if (error) {
+            reject(error);
+        } else {
+            add(documents_added, 1);
+        }
+        return error;
+    }
+
+    void record_search(uint64_t ns) {
+        add(searches, 1);
+        add(search_ns, ns);
+        size_t bucket = 0;
+        for (uint64_t us = ns / 1000; us && bucket + 1 < LATENCY_BUCKETS; us >>= 1) ++bucket;
+        add(latency_histogram[bucket], 1);
+    }
+
+    void copy_to(StoreStats& out) const {
+        auto load = [](const Counter& counter) { return counter.load(std::memory_order_relaxed); };
+        out.read_ns = load(read_ns);
+        out.parse_ns = load(parse_ns);
+        out.add_ns = load(add_ns);
+        out.finalize_ns = load(finalize_ns);
+        out.bytes_read = load(bytes_read);
+        out.files_read = load(files_read);
+        out.documents_added = load(documents_added);
+        out.documents_rejected = load(documents_rejected);
+        for (size_t e = 0; e < simdjson::NUM_ERROR_CODES; ++e) out.rejected_by_error[e] = load(rejected_by_error[e]);
+        out.searches = load(searches);
+        out.search_ns = load(search_ns);
+        for (size_t b = 0; b < LATENCY_BUCKETS; ++b) out.latency_histogram[b] = load(latency_histogram[b]);
+        out.rows_scanned = load(rows_scanned);
+        out.graph_searches = load(graph_searches);
+        out.parallel_scans = load(parallel_scans);
+        out.lock_waits = load(lock_waits);
+        out.lock_wait_ns = load(lock_wait_ns);
+        out.cache_hits = load(cache_hits);
+        out.cache_misses = load(cache_misses);
+        out.omp_threads = omp_threads.load(std::memory_order_relaxed);
+    }
+
+    Counter read_ns{0}, parse_ns{0}, add_ns{0}, finalize_ns{0};
+    Counter bytes_read{0}, files_read{0};
+    Counter documents_added{0}, documents_rejected{0};
+    Counter rejected_by_error[simdjson::NUM_ERROR_CODES] = {};
+    Counter searches{0}, search_ns{0};
+    Counter latency_histogram[LATENCY_BUCKETS] = {};
+    Counter rows_scanned{0}, graph_searches{0}, parallel_scans{0};
+    Counter lock_waits{0}, lock_wait_ns{0};
+    Counter cache_hits{0}, cache_misses{0};
+    std::atomic<int> omp_threads{0};
+};
+
+// Adds the time from construction to destruction to a counter
+class ScopedTimer {
+public:
+    explicit ScopedTimer(StatsCounters::Counter& counter) : counter_(counter), start_(stats_now_ns()) {}
+    ~ScopedTimer() { StatsCounters::add(counter_, stats_now_ns() - start_); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    StatsCounters::Counter& counter_;
+    uint64_t start_;
+};
+
+// Records one search latency sample from construction to destruction
+class SearchTimer {
+public:
+    explicit SearchTimer(StatsCounters& counters) : counters_(counters), start_(stats_now_ns()) {}
+    ~SearchTimer() {
+        if constexpr (STATS_ENABLED) counters_.record_search(stats_now_ns() - start_);
+    }
+    SearchTimer(const SearchTimer&) = delete;
+    SearchTimer& operator=(const SearchTimer&) = delete;
+
+private:
+    StatsCounters& counters_;
+    uint64_t start_;
+};
@@ -1,5 +1,7 @@
 #include "vector_store.h"
 #include "vector_store_loader.h"
+#include "json_chunks.h"
+#include "snapshot_format.h"
 #include <thread>
 #include <random>
 #include <chrono>
@@ -9,6 +11,8 @@
 #include <sstream>
 #include <iomanip>
 #include <filesystem>
+#include <cstring>
+#include <fstream>
 
 using namespace std::chrono;
 
@@ -50,6 +54,22 @@ std::string create_json_document(const std::string& id, const std::string& text,
     return json.str();
 }
 
+// Helper to copy a snapshot with one section's recorded size cut by `bytes`
+void copy_with_short_section(const std::string& from, const std::string& to, uint32_t type, uint64_t bytes) {
+    std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+    std::fstream file(to, std::ios::in | std::ios::out | std::ios::binary);
+    snapshot::Header header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    std::vector<snapshot::Section> sections(header.section_count);
+    file.read(reinterpret_cast<char*>(sections.data()), sections.size() * sizeof(snapshot::Section));
+    for (size_t i = 0; i < sections.size(); ++i) {
+        if (sections[i].type != type) continue;
+        sections[i].size -= bytes;
+        file.seekp(sizeof(header) + i * sizeof(snapshot::Section));
+        file.write(reinterpret_cast<const char*>(&sections[i]), sizeof(snapshot::Section));
+    }
+}
+
 
 // Test 1: Producer-consumer loading performance
 void test_loading_performance() {
@@ -120,56 +140,53 @@ void test_phase_enforcement() {
     assert(!results.empty());
     std::cout << "   ✅ Search works after finalization\n";
     
-    // Verify document addition fails after finalization
+    // Documents added after finalization go to the delta segment
     auto embedding = generate_random_embedding(DIM, rng);
-    std::string json_str = create_json_document("blocked", "Should fail", embedding);
+    std::string json_str = create_json_document("late", "Added when serving", embedding);
     simdjson::padded_string padded(json_str);
     simdjson::ondemand::document doc;
     parser.iterate(padded).get(doc);
     auto error = store.add_document(doc);
-    assert(error == simdjson::INCORRECT_TYPE);
-    std::cout << "   ✅ Document addition correctly blocked after finalization\n";
+    assert(error == simdjson::SUCCESS);
+    assert(store.size() == 101);
+    results = store.search(embedding.data(), 1);
+    assert(store.get_entry(results[0].second).doc.id == "late");
+    std::cout << "   ✅ Document added after finalization is searchable\n";
 }
 
-// Test 3: 64MB+1 allocation (expect fail)
+// Test 3: 64MB+1 document (dedicated arena chunk)
 void test_oversize_allocation() {
-    std::cout << "\n📏 Test 3: 64MB+1 allocation (expect fail)\n";
+    std::cout << "\n📏 Test 3: 64MB+1 document (dedicated arena chunk)\n";
     
     VectorStore store(10);
     
-    // Create a document with metadata that exceeds chunk size
-    std::stringstream huge_json;
-    huge_json << "{\"id\":\"huge\",\"text\":\"test\",\"metadata\":{\"embedding\":[";
+    // Metadata larger than the biggest arena chunk
+    std::string json_str = "{\"id\":\"huge\",\"text\":\"test\",\"metadata\":{\"embedding\":[";
     for (int i = 0; i < 10; ++i) {
-        if (i > 0) huge_json << ",";
-        huge_json << "0.1";
-    }
-    huge_json << "],\"huge\":\"";
-    // Add 64MB + 1 byte of data
-    for (size_t i = 0; i < 67108865; ++i) {
-        huge_json << "x";
+        if (i > 0) json_str += ",";
+        json_str += "0.1";
     }
-    huge_json << "\"}}";
+    json_str += "],\"huge\":\"";
+    json_str.append(67108865, 'x');
+    json_str += "\"}}";
     
-    std::string json_str = huge_json.str();
     simdjson::padded_string padded(json_str);
     simdjson::ondemand::parser parser;
     simdjson::ondemand::document doc;
     
     auto error = parser.iterate(padded).get(doc);
-    if (!error) {
-        // This should fail in the allocator
-        error = store.add_document(doc);
-        if (error == simdjson::MEMALLOC) {
-            std::cout << "✅ Correctly rejected oversize allocation\n";
-        } else {
-            std::cout << "❌ Should have failed with MEMALLOC error, got: " << simdjson::error_message(error) << "\n";
-            std::exit(1);
-        }
-    } else {
+    if (error) {
         std::cout << "❌ Failed to parse test JSON: " << simdjson::error_message(error) << "\n";
         std::exit(1);
     }
+    error = store.add_document(doc);
+    if (error) {
+        std::cout << "❌ Oversize document rejected: " << simdjson::error_message(error) << "\n";
+        std::exit(1);
+    }
+    store.finalize();
+    assert(store.get_entry(0).doc.metadata_json.size() > 67108865);
+    std::cout << "✅ Oversize document stored in a dedicated chunk\n";
 }
 
 // Test 4: Alignment requests
@@ -252,16 +269,16 @@ void test_phase_separation() {
     auto finalize_time = duration_cast<milliseconds>(high_resolution_clock::now() - finalize_start).count();
     std::cout << "   Finalized (normalized) in " << finalize_time << "ms\n";
     
-    // Verify no more documents can be added
+    // Documents can still be added, into the delta segment
     {
         auto embedding = generate_random_embedding(DIM, rng);
-        std::string json_str = create_json_document("blocked", "Should fail", embedding);
+        std::string json_str = create_json_document("late", "Added when serving", embedding);
         simdjson::padded_string padded(json_str);
         simdjson::ondemand::document doc;
         parser.iterate(padded).get(doc);
         auto error = store.add_document(doc);
-        assert(error == simdjson::INCORRECT_TYPE);
-        std::cout << "   ✅ Document additions correctly blocked after finalization\n";
+        assert(error == simdjson::SUCCESS);
+        std::cout << "   ✅ Document addition after finalization goes to the delta segment\n";
     }
     
     // Phase 3: Concurrent searches (multiple threads)
@@ -362,6 +379,2449 @@ void test_concurrent_search_performance() {
     std::cout << "   Throughput: " << (total_searches.load() * 1000 / search_time) << " searches/sec\n";
 }
 
+// Test 7: Snapshot save and reopen
+void test_snapshot_roundtrip() {
+    std::cout << "\n💾 Test 7: Snapshot save and reopen\n";
+    
+    VectorStore store(DIM);
+    std::mt19937 rng(7);
+    simdjson::ondemand::parser parser;
+    
+    for (size_t i = 0; i < 500; ++i) {
+        auto embedding = generate_random_embedding(DIM, rng);
+        std::string json_str = create_json_document(
+            "snap-" + std::to_string(i),
+            "Snapshot document " + std::to_string(i),
+            embedding
+        );
+        
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        if (!parser.iterate(padded).get(doc)) {
+            auto error = store.add_document(doc);
+            assert(error == simdjson::SUCCESS);
+        }
+    }
+    
+    // Saving before finalization is rejected
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_snapshot.bin").string();
+    assert(store.save(path) == simdjson::INCORRECT_TYPE);
+    
+    store.finalize();
+    auto save_start = high_resolution_clock::now();
+    auto error = store.save(path);
+    assert(error == simdjson::SUCCESS);
+    auto save_time = duration_cast<milliseconds>(high_resolution_clock::now() - save_start).count();
+    std::cout << "   Saved " << store.size() << " documents in " << save_time << "ms\n";
+    
+    // Dimension mismatch is rejected
+    {
+        VectorStore wrong_dim(DIM / 2);
+        assert(wrong_dim.open_snapshot(path) == simdjson::INCORRECT_TYPE);
+        assert(!wrong_dim.is_finalized());
+    }
+    
+    VectorStore reopened(DIM);
+    auto open_start = high_resolution_clock::now();
+    error = reopened.open_snapshot(path);
+    assert(error == simdjson::SUCCESS);
+    auto open_time = duration_cast<microseconds>(high_resolution_clock::now() - open_start).count();
+    assert(reopened.is_finalized());
+    assert(reopened.size() == store.size());
+    std::cout << "   Opened snapshot in " << open_time << "us\n";
+    
+    for (size_t i = 0; i < store.size(); ++i) {
+        const auto& a = store.get_entry(i);
+        const auto& b = reopened.get_entry(i);
+        assert(a.doc.id == b.doc.id);
+        assert(a.doc.text == b.doc.text);
+        assert(a.doc.metadata_json == b.doc.metadata_json);
+        assert(std::memcmp(a.embedding, b.embedding, DIM * sizeof(float)) == 0);
+    }
+    
+    auto query = generate_random_embedding(DIM, rng);
+    auto expected = store.search(query.data(), 10);
+    auto actual = reopened.search(query.data(), 10);
+    assert(expected.size() == actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        assert(expected[i].second == actual[i].second);
+    }
+    
+    // A second open on an already-populated store is rejected
+    assert(reopened.open_snapshot(path) == simdjson::INCORRECT_TYPE);
+    
+    std::filesystem::remove(path);
+    std::cout << "✅ Snapshot round trip preserved documents and search results\n";
+}
+
+// Test 8: Finalized embeddings form one contiguous, padded matrix
+void test_contiguous_matrix() {
+    std::cout << "\n🧱 Test 8: Contiguous embedding matrix layout\n";
+    
+    constexpr size_t SMALL_DIM = 100;  // Not a multiple of the SIMD width
+    VectorStore store(SMALL_DIM);
+    std::mt19937 rng(8);
+    simdjson::ondemand::parser parser;
+    
+    for (size_t i = 0; i < 64; ++i) {
+        auto embedding = generate_random_embedding(SMALL_DIM, rng);
+        for (auto& v : embedding) v *= 3.0f;  // Denormalize to exercise finalize()
+        std::string json_str = create_json_document("row-" + std::to_string(i), "Row", embedding);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        if (!parser.iterate(padded).get(doc)) {
+            assert(store.add_document(doc) == simdjson::SUCCESS);
+        }
+    }
+    
+    assert(store.finalize() == simdjson::SUCCESS);
+    assert(store.stride() % VectorStore::ROW_ALIGN_FLOATS == 0);
+    assert(store.stride() >= SMALL_DIM);
+    
+    const float* first = store.get_entry(0).embedding;
+    assert(((uintptr_t)first % 64) == 0);
+    
+    for (size_t i = 0; i < store.size(); ++i) {
+        const float* row = store.get_entry(i).embedding;
+        assert(row == first + i * store.stride());
+        
+        float norm = 0.0f;
+        for (size_t j = 0; j < SMALL_DIM; ++j) norm += row[j] * row[j];
+        assert(std::fabs(norm - 1.0f) < 1e-4f);
+        
+        for (size_t j = SMALL_DIM; j < store.stride(); ++j) assert(row[j] == 0.0f);
+    }
+    
+    std::cout << "✅ Rows are 64-byte aligned, contiguous (stride " << store.stride()
+              << "), normalized and zero-padded\n";
+}
+
+// Test 9: SIMD kernels agree with a scalar reference for every ISA
+void test_simd_kernels() {
+    std::cout << "\n⚡ Test 9: SIMD dot-product kernels (active: "
+              << kernels::isa_name(kernels::active_isa()) << ")\n";
+    
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    
+    std::vector<size_t> dims;
+    for (size_t d = 1; d <= 80; ++d) dims.push_back(d);
+    for (size_t d : {384, 768, 1024, 1536, 3072, 1537}) dims.push_back(d);
+    
+    const kernels::Isa all_isas[] = {kernels::Isa::Scalar, kernels::Isa::SSE, kernels::Isa::AVX2,
+                                     kernels::Isa::AVX512, kernels::Isa::NEON};
+    
+    for (kernels::Isa isa : all_isas) {
+        if (!kernels::isa_supported(isa)) continue;
+        
+        for (size_t d : dims) {
+            // Offset by one float to exercise unaligned loads
+            std::vector<float> a(d + 1), b(d + 1);
+            double expected = 0.0;
+            for (size_t j = 0; j < d; ++j) {
+                a[j + 1] = dist(rng);
+                b[j + 1] = dist(rng);
+                expected += double(a[j + 1]) * b[j + 1];
+            }
+            
+            float actual = kernels::dot_for(isa, d)(a.data() + 1, b.data() + 1, d);
+            if (std::fabs(actual - expected) > 1e-3 * (1.0 + std::fabs(expected))) {
+                std::cout << "❌ " << kernels::isa_name(isa) << " dot mismatch at dim " << d
+                          << ": " << actual << " vs " << expected << "\n";
+                std::exit(1);
+            }
+            
+            // dot4: same row against four vectors spaced d + 3 floats apart
+            std::vector<float> quad(4 * (d + 3));
+            for (float& x : quad) x = dist(rng);
+            float scores[4];
+            kernels::dot4_for(isa)(a.data() + 1, quad.data(), d + 3, d, scores);
+            for (size_t j = 0; j < 4; ++j) {
+                double ref = 0.0;
+                for (size_t t = 0; t < d; ++t) ref += double(a[t + 1]) * quad[j * (d + 3) + t];
+                assert(std::fabs(scores[j] - ref) <= 1e-3 * (1.0 + std::fabs(ref)));
+            }
+        }
+        
+        // select_above: every length up to two AVX-512 registers plus a tail
+        for (size_t n = 0; n <= 37; ++n) {
+            std::vector<float> block(n);
+            for (float& x : block) x = dist(rng);
+            std::vector<uint32_t> positions(n + 1), expected_positions;
+            for (size_t j = 0; j < n; ++j) {
+                if (block[j] > 0.25f) expected_positions.push_back(uint32_t(j));
+            }
+            size_t count = kernels::select_above_for(isa)(block.data(), n, 0.25f, positions.data());
+            positions.resize(count);
+            assert(positions == expected_positions);
+        }
+        
+        // PQ: ADC gathers with every tail shape, and 4-bit fast-scan block sums
+        for (size_t m : {1, 7, 8, 16, 33, 40}) {
+            std::vector<float> lut(m * 256);
+            for (float& x : lut) x = dist(rng);
+            std::vector<uint8_t> codes(m * 16), lut8(m * 16);
+            for (uint8_t& c : codes) c = static_cast<uint8_t>(rng());
+            for (uint8_t& c : lut8) c = static_cast<uint8_t>(rng());
+            
+            double ref = 0.0;
+            for (size_t j = 0; j < m; ++j) ref += lut[j * 256 + codes[j]];
+            float adc = kernels::pq_adc_for(isa)(lut.data(), codes.data(), m);
+            assert(std::fabs(adc - ref) <= 1e-4 * (1.0 + std::fabs(ref)));
+            
+            uint16_t sums[32];
+            kernels::pq_scan4_for(isa)(codes.data(), lut8.data(), m, sums);
+            for (size_t r = 0; r < 32; ++r) {
+                uint32_t expected = 0;
+                for (size_t j = 0; j < m; ++j) {
+                    uint8_t byte = codes[j * 16 + (r & 15)];
+                    expected += lut8[j * 16 + (r < 16 ? byte & 15 : byte >> 4)];
+                }
+                assert(sums[r] == expected);
+            }
+        }
+        std::cout << "   ✅ " << kernels::isa_name(isa) << " matches reference\n";
+    }
+    
+    std::vector<float> v = {3.0f, 4.0f, 0.0f};
+    kernels::normalize(v.data(), v.size());
+    assert(std::fabs(v[0] - 0.6f) < 1e-6f && std::fabs(v[1] - 0.8f) < 1e-6f);
+    
+    std::vector<float> zero(17, 0.0f);
+    kernels::normalize(zero.data(), zero.size());
+    assert(zero[0] == 0.0f);
+    
+    std::cout << "✅ Kernels and normalization correct\n";
+}
+
+// Test 10: Quantized scan with exact re-rank matches exact search
+void test_quantized_search() {
+    std::cout << "\n🗜️  Test 10: Quantized storage (int8 / fp16) with exact re-ranking\n";
+    
+    constexpr size_t QDIM = 384;
+    constexpr size_t NUM_DOCS = 2000;
+    constexpr size_t K = 10;
+    
+    // Quantized kernels against a double-precision reference
+    std::mt19937 rng(10);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t d : {1, 7, 16, 33, 384, 1537}) {
+        std::vector<float> q(d), decoded_h(d);
+        std::vector<int8_t> codes(d);
+        std::vector<uint16_t> halves(d);
+        double expected_i8 = 0.0, expected_h = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            q[j] = dist(rng);
+            codes[j] = static_cast<int8_t>(rng() % 255 - 127);
+            halves[j] = kernels::float_to_half(dist(rng));
+            expected_i8 += double(q[j]) * codes[j];
+            expected_h += double(q[j]) * kernels::half_to_float(halves[j]);
+        }
+        assert(std::fabs(kernels::dot_i8(q.data(), codes.data(), d) - expected_i8) <
+               1e-3 * (1.0 + std::fabs(expected_i8)));
+        assert(std::fabs(kernels::dot_f16(q.data(), halves.data(), d) - expected_h) <
+               1e-3 * (1.0 + std::fabs(expected_h)));
+    }
+    assert(kernels::half_to_float(kernels::float_to_half(0.5f)) == 0.5f);
+    assert(kernels::half_to_float(kernels::float_to_half(-2.0f)) == -2.0f);
+    
+    std::vector<std::vector<float>> embeddings;
+    for (size_t i = 0; i < NUM_DOCS; ++i) {
+        embeddings.push_back(generate_random_embedding(QDIM, rng));
+    }
+    
+    auto build = [&](const VectorStoreOptions& options) {
+        auto store = std::make_unique<VectorStore>(QDIM, options);
+        simdjson::ondemand::parser parser;
+        for (size_t i = 0; i < NUM_DOCS; ++i) {
+            std::string json_str = create_json_document(
+                "q-" + std::to_string(i), "Quantized " + std::to_string(i), embeddings[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            if (!parser.iterate(padded).get(doc)) {
+                auto error = store->add_document(doc);
+                assert(error == simdjson::SUCCESS);
+            }
+        }
+        auto error = store->finalize();
+        assert(error == simdjson::SUCCESS);
+        return store;
+    };
+    
+    auto exact = build(VectorStoreOptions());
+    assert(exact->quantization() == Quantization::None);
+    
+    std::vector<std::vector<float>> queries;
+    for (size_t q = 0; q < 50; ++q) {
+        queries.push_back(generate_random_embedding(QDIM, rng));
+    }
+    
+    auto recall_at_k = [&](const VectorStore& store) {
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            auto truth = exact->search(query.data(), K);
+            auto approx = store.search(query.data(), K);
+            assert(approx.size() == K);
+            for (const auto& a : approx) {
+                for (const auto& t : truth) {
+                    if (a.second == t.second) { ++hits; break; }
+                }
+            }
+        }
+        return double(hits) / (queries.size() * K);
+    };
+    
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_quantized.bin").string();
+    
+    for (Quantization type : {Quantization::Int8, Quantization::Fp16}) {
+        VectorStoreOptions options;
+        options.quantization = type;
+        auto store = build(options);
+        assert(store->quantization() == type);
+        
+        double recall = recall_at_k(*store);
+        std::cout << "   " << quantization_name(type) << " recall@" << K << ": "
+                  << std::fixed << std::setprecision(3) << recall << std::defaultfloat << "\n";
+        assert(recall >= 0.9);
+        
+        // Re-ranked scores are exact float scores
+        auto results = store->search(queries[0].data(), K);
+        const auto& top = store->get_entry(results[0].second);
+        float expected_score = kernels::dot(top.embedding, queries[0].data(), QDIM);
+        assert(std::fabs(results[0].first - expected_score) < 1e-5f);
+        
+        // Codes survive a snapshot round trip
+        assert(store->save(path) == simdjson::SUCCESS);
+        VectorStore reopened(QDIM, options);
+        assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+        assert(reopened.quantization() == type);
+        auto reopened_results = reopened.search(queries[0].data(), K);
+        for (size_t i = 0; i < K; ++i) {
+            assert(reopened_results[i].second == results[i].second);
+        }
+    }
+    
+    // A float-only snapshot opened by a quantized store encodes codes on open
+    assert(exact->save(path) == simdjson::SUCCESS);
+    VectorStoreOptions int8_options;
+    int8_options.quantization = Quantization::Int8;
+    VectorStore encoded(QDIM, int8_options);
+    assert(encoded.open_snapshot(path) == simdjson::SUCCESS);
+    assert(encoded.quantization() == Quantization::Int8);
+    assert(recall_at_k(encoded) >= 0.9);
+    
+    std::filesystem::remove(path);
+    std::cout << "✅ Quantized search matches exact search within recall target\n";
+}
+
+// Test 11: HNSW graph search against the brute-force ground truth
+void test_hnsw_index() {
+    std::cout << "\n🕸️  Test 11: HNSW approximate nearest-neighbor index\n";
+    
+    constexpr size_t HDIM = 64;
+    constexpr size_t NUM_DOCS = 3000;
+    constexpr size_t K = 10;
+    
+    std::mt19937 rng(11);
+    VectorStoreOptions options;
+    options.index = IndexType::HNSW;
+    options.hnsw.M = 12;
+    options.hnsw.ef_construction = 100;
+    
+    auto build = [&](size_t count) {
+        auto store = std::make_unique<VectorStore>(HDIM, options);
+        simdjson::ondemand::parser parser;
+        for (size_t i = 0; i < count; ++i) {
+            auto embedding = generate_random_embedding(HDIM, rng);
+            std::string json_str = create_json_document(
+                "h-" + std::to_string(i), "Graph " + std::to_string(i), embedding);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            if (!parser.iterate(padded).get(doc)) {
+                auto error = store->add_document(doc);
+                assert(error == simdjson::SUCCESS);
+            }
+        }
+        return store;
+    };
+    
+    // Below min_index_size the store is only ever scanned
+    {
+        auto small = build(options.min_index_size - 1);
+        small->finalize();
+        assert(small->index_type() == IndexType::Flat);
+    }
+    
+    auto store = build(NUM_DOCS);
+    auto build_start = high_resolution_clock::now();
+    auto error = store->finalize();
+    assert(error == simdjson::SUCCESS);
+    auto build_time = duration_cast<milliseconds>(high_resolution_clock::now() - build_start).count();
+    assert(store->index_type() == IndexType::HNSW);
+    std::cout << "   Built graph over " << NUM_DOCS << " documents in " << build_time << "ms\n";
+    
+    std::vector<std::vector<float>> queries;
+    for (size_t q = 0; q < 50; ++q) {
+        queries.push_back(generate_random_embedding(HDIM, rng));
+    }
+    
+    SearchOptions exact;
+    exact.exact = true;
+    
+    auto recall_at_k = [&](const VectorStore& s, size_t ef) {
+        SearchOptions approx;
+        approx.ef = ef;
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            auto truth = s.search(query.data(), K, exact);
+            auto results = s.search(query.data(), K, approx);
+            assert(results.size() == K);
+            for (size_t i = 1; i < results.size(); ++i) {
+                assert(results[i - 1].first >= results[i].first);
+            }
+            for (const auto& r : results) {
+                for (const auto& t : truth) {
+                    if (r.second == t.second) { ++hits; break; }
+                }
+            }
+        }
+        return double(hits) / (queries.size() * K);
+    };
+    
+    double recall_low = recall_at_k(*store, 16);
+    double recall_high = recall_at_k(*store, 128);
+    std::cout << "   recall@" << K << ": ef=16 " << std::fixed << std::setprecision(3) << recall_low
+              << ", ef=128 " << recall_high << std::defaultfloat << "\n";
+    assert(recall_high >= 0.9);
+    assert(recall_high >= recall_low);
+    
+    // The graph is saved with the snapshot and mapped back without rebuilding
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_hnsw.bin").string();
+    assert(store->save(path) == simdjson::SUCCESS);
+    VectorStore reopened(HDIM, options);
+    assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+    assert(reopened.index_type() == IndexType::HNSW);
+    SearchOptions approx;
+    approx.ef = 64;
+    for (const auto& query : queries) {
+        auto expected = store->search(query.data(), K, approx);
+        auto actual = reopened.search(query.data(), K, approx);
+        assert(expected.size() == actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(expected[i].second == actual[i].second);
+        }
+    }
+    
+    // A flat store opening the same snapshot ignores the graph
+    VectorStore flat(HDIM);
+    assert(flat.open_snapshot(path) == simdjson::SUCCESS);
+    assert(flat.index_type() == IndexType::Flat);
+    
+    // Corrupt graph sections are rejected before any search can follow them
+    const std::string corrupt_path = path + ".corrupt";
+    auto open_corrupted = [&](uint32_t type, size_t index, auto value) {
+        std::filesystem::copy_file(path, corrupt_path, std::filesystem::copy_options::overwrite_existing);
+        std::fstream file(corrupt_path, std::ios::in | std::ios::out | std::ios::binary);
+        snapshot::Header header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        std::vector<snapshot::Section> sections(header.section_count);
+        file.read(reinterpret_cast<char*>(sections.data()), sections.size() * sizeof(snapshot::Section));
+        for (const auto& section : sections) {
+            if (section.type != type) continue;
+            file.seekp(section.offset + index * sizeof(value));
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+        file.close();
+        VectorStore corrupted(HDIM, options);
+        return corrupted.open_snapshot(corrupt_path);
+    };
+    const uint32_t n = static_cast<uint32_t>(NUM_DOCS);
+    assert(open_corrupted(snapshot::SECTION_HNSW_LEVEL0, 1, n + 7) == simdjson::IO_ERROR);  // Neighbor id
+    assert(open_corrupted(snapshot::SECTION_HNSW_LEVEL0, 0, uint32_t(1000)) == simdjson::IO_ERROR);  // Link count
+    assert(open_corrupted(snapshot::SECTION_HNSW_UPPER, 0, uint32_t(1000)) == simdjson::IO_ERROR);
+    assert(open_corrupted(snapshot::SECTION_HNSW_UPPER_OFFSETS, n / 2, UINT64_MAX / 2) == simdjson::IO_ERROR);
+    assert(open_corrupted(snapshot::SECTION_HNSW_UPPER_OFFSETS, 1, uint64_t(1)) == simdjson::IO_ERROR);
+    assert(open_corrupted(snapshot::SECTION_HNSW_META, 2, uint64_t(40)) == simdjson::IO_ERROR);  // max_level
+    VectorStore intact(HDIM, options);
+    assert(intact.open_snapshot(path) == simdjson::SUCCESS);  // The original is untouched
+    
+    std::filesystem::remove(corrupt_path);
+    std::filesystem::remove(path);
+    std::cout << "✅ HNSW search meets recall target and survives snapshot round trip\n";
+}
+
+// Test 12: IVF lists (plain and IVF-SQ8) against the brute-force ground truth
+void test_ivf_index() {
+    std::cout << "\n📇 Test 12: IVF coarse-quantizer index\n";
+    
+    constexpr size_t VDIM = 64;
+    constexpr size_t NUM_DOCS = 4000;
+    constexpr size_t K = 10;
+    
+    // Clustered data: IVF relies on the corpus having structure
+    std::mt19937 rng(12);
+    std::normal_distribution<float> noise(0.0f, 0.15f);
+    std::vector<std::vector<float>> centers;
+    for (size_t c = 0; c < 40; ++c) {
+        centers.push_back(generate_random_embedding(VDIM, rng));
+    }
+    auto clustered = [&]() {
+        std::vector<float> v = centers[rng() % centers.size()];
+        for (float& x : v) x += noise(rng);
+        return v;
+    };
+    
+    std::vector<std::vector<float>> embeddings;
+    for (size_t i = 0; i < NUM_DOCS; ++i) {
+        embeddings.push_back(clustered());
+    }
+    std::vector<std::vector<float>> queries;
+    for (size_t q = 0; q < 50; ++q) {
+        auto v = clustered();
+        kernels::normalize(v.data(), VDIM);
+        queries.push_back(v);
+    }
+    
+    auto build = [&](const VectorStoreOptions& options) {
+        auto store = std::make_unique<VectorStore>(VDIM, options);
+        simdjson::ondemand::parser parser;
+        for (size_t i = 0; i < NUM_DOCS; ++i) {
+            std::string json_str = create_json_document(
+                "ivf-" + std::to_string(i), "List " + std::to_string(i), embeddings[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            if (!parser.iterate(padded).get(doc)) {
+                auto error = store->add_document(doc);
+                assert(error == simdjson::SUCCESS);
+            }
+        }
+        auto error = store->finalize();
+        assert(error == simdjson::SUCCESS);
+        return store;
+    };
+    
+    auto flat = build(VectorStoreOptions());
+    
+    auto recall_at_k = [&](const VectorStore& store, size_t nprobe) {
+        SearchOptions search_options;
+        search_options.nprobe = nprobe;
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            auto truth = flat->search(query.data(), K);
+            auto results = store.search(query.data(), K, search_options);
+            for (const auto& r : results) {
+                for (const auto& t : truth) {
+                    if (r.second == t.second) { ++hits; break; }
+                }
+            }
+        }
+        return double(hits) / (queries.size() * K);
+    };
+    
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_ivf.bin").string();
+    
+    for (Quantization type : {Quantization::None, Quantization::Int8}) {
+        VectorStoreOptions options;
+        options.index = IndexType::IVF;
+        options.ivf.nlist = 64;
+        options.quantization = type;
+        auto store = build(options);
+        assert(store->index_type() == IndexType::IVF);
+        
+        // Rows are reordered into lists, but results still name entries
+        for (size_t i = 0; i < NUM_DOCS; i += 97) {
+            const auto& entry = store->get_entry(i);
+            assert(entry.doc.id == "ivf-" + std::to_string(i));
+            auto expected = embeddings[i];
+            kernels::normalize(expected.data(), VDIM);
+            assert(std::fabs(entry.embedding[0] - expected[0]) < 1e-6f);
+        }
+        SearchOptions exact;
+        exact.exact = true;
+        auto exact_results = store->search(queries[0].data(), K, exact);
+        auto flat_results = flat->search(queries[0].data(), K);
+        for (size_t i = 0; i < K; ++i) {
+            assert(exact_results[i].second == flat_results[i].second);
+        }
+        
+        double recall_low = recall_at_k(*store, 1);
+        double recall_high = recall_at_k(*store, 8);
+        std::cout << "   " << (type == Quantization::Int8 ? "IVF-SQ8" : "IVF") << " recall@" << K
+                  << ": nprobe=1 " << std::fixed << std::setprecision(3) << recall_low
+                  << ", nprobe=8 " << recall_high << std::defaultfloat << "\n";
+        assert(recall_high >= 0.9);
+        assert(recall_high >= recall_low);
+        
+        // Lists, centroids and row order are mapped back from the snapshot
+        assert(store->save(path) == simdjson::SUCCESS);
+        VectorStore reopened(VDIM, options);
+        assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+        assert(reopened.index_type() == IndexType::IVF);
+        assert(std::fabs(recall_at_k(reopened, 8) - recall_high) < 1e-9);
+        for (size_t i = 0; i < NUM_DOCS; i += 97) {
+            assert(std::memcmp(reopened.get_entry(i).embedding, store->get_entry(i).embedding,
+                               VDIM * sizeof(float)) == 0);
+        }
+        
+        // A flat store on the same snapshot still maps rows to the right entries
+        VectorStore flat_reopened(VDIM);
+        assert(flat_reopened.open_snapshot(path) == simdjson::SUCCESS);
+        auto reopened_results = flat_reopened.search(queries[0].data(), K);
+        for (size_t i = 0; i < K; ++i) {
+            assert(reopened_results[i].second == flat_results[i].second);
+        }
+    }
+    
+    // A failed open leaves nothing behind: the IVF-SQ8 snapshot above, with a
+    // truncated scale section, fails after its row order was read
+    const std::string corrupt_path = path + ".corrupt";
+    copy_with_short_section(path, corrupt_path, snapshot::SECTION_INT8_SCALES, sizeof(float));
+    VectorStoreOptions sq8_options;
+    sq8_options.quantization = Quantization::Int8;
+    VectorStore retried(VDIM, sq8_options);
+    assert(retried.open_snapshot(corrupt_path) == simdjson::IO_ERROR);
+    std::filesystem::remove(corrupt_path);
+    
+    // The next open, of a snapshot in entry order, maps rows to the right entries
+    assert(flat->save(path) == simdjson::SUCCESS);
+    assert(retried.open_snapshot(path) == simdjson::SUCCESS);
+    for (size_t i = 0; i < NUM_DOCS; i += 97) {
+        assert(std::memcmp(retried.get_entry(i).embedding, flat->get_entry(i).embedding,
+                           VDIM * sizeof(float)) == 0);
+    }
+    
+    // An IVF store trains its lists when opening a flat snapshot
+    VectorStoreOptions ivf_options;
+    ivf_options.index = IndexType::IVF;
+    ivf_options.ivf.nlist = 64;
+    VectorStore trained(VDIM, ivf_options);
+    assert(trained.open_snapshot(path) == simdjson::SUCCESS);
+    assert(trained.index_type() == IndexType::IVF);
+    assert(recall_at_k(trained, 8) >= 0.9);
+    
+    std::filesystem::remove(path);
+    std::cout << "✅ IVF search meets recall target and survives snapshot round trip\n";
+}
+
+// Test 13: Search executor strategies agree and run concurrently
+void test_search_executor() {
+    std::cout << "\n🚦 Test 13: Concurrent search executor\n";
+    
+    constexpr size_t EDIM = 128;
+    constexpr size_t NUM_DOCS = 5000;
+    constexpr size_t K = 10;
+    
+    VectorStore store(EDIM);
+    std::mt19937 rng(13);
+    simdjson::ondemand::parser parser;
+    for (size_t i = 0; i < NUM_DOCS; ++i) {
+        auto embedding = generate_random_embedding(EDIM, rng);
+        std::string json_str = create_json_document(
+            "exec-" + std::to_string(i), "Executor " + std::to_string(i), embedding);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        if (!parser.iterate(padded).get(doc)) {
+            store.add_document(doc);
+        }
+    }
+    store.finalize();
+    
+    std::vector<std::vector<float>> queries;
+    for (size_t q = 0; q < 32; ++q) {
+        queries.push_back(generate_random_embedding(EDIM, rng));
+    }
+    
+    SearchOptions sequential, parallel;
+    sequential.mode = SearchMode::Sequential;
+    parallel.mode = SearchMode::Parallel;
+    
+    std::vector<std::vector<std::pair<float, size_t>>> expected;
+    for (const auto& query : queries) {
+        auto a = store.search(query.data(), K, sequential);
+        auto b = store.search(query.data(), K, parallel);
+        assert(a.size() == K && b.size() == K);
+        // Compare scores: per-thread heaps may order exact ties differently
+        for (size_t i = 0; i < K; ++i) {
+            assert(std::fabs(a[i].first - b[i].first) < 1e-6f);
+        }
+        expected.push_back(a);
+    }
+    
+    // Many threads, every mode at once: no search waits on another's lock,
+    // and a parallel request that finds a team running falls back to sequential
+    const SearchMode modes[] = {SearchMode::Auto, SearchMode::Sequential, SearchMode::Parallel};
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> searchers;
+    auto start = high_resolution_clock::now();
+    for (size_t t = 0; t < 8; ++t) {
+        searchers.emplace_back([&, t]() {
+            SearchOptions search_options;
+            search_options.mode = modes[t % 3];
+            for (size_t round = 0; round < 20; ++round) {
+                size_t q = (t + round) % queries.size();
+                auto results = store.search(queries[q].data(), K, search_options);
+                for (size_t i = 0; i < K; ++i) {
+                    if (std::fabs(results[i].first - expected[q][i].first) >= 1e-6f) mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& t : searchers) t.join();
+    auto elapsed = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+    
+    assert(mismatches.load() == 0);
+    std::cout << "✅ 160 mixed-mode concurrent searches matched sequential results in " << elapsed << "ms\n";
+}
+
+// Test 14: Batched search matches per-query search
+void test_search_batch() {
+    std::cout << "\n📦 Test 14: Batched multi-query search\n";
+    
+    constexpr size_t NUM_DOCS = 5000;
+    constexpr size_t NQ = 32;
+    constexpr size_t K = 10;
+    
+    VectorStore store(DIM);
+    std::mt19937 rng(14);
+    simdjson::ondemand::parser parser;
+    for (size_t i = 0; i < NUM_DOCS; ++i) {
+        auto embedding = generate_random_embedding(DIM, rng);
+        std::string json_str = create_json_document(
+            "batch-" + std::to_string(i), "Batch " + std::to_string(i), embedding);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        if (!parser.iterate(padded).get(doc)) {
+            store.add_document(doc);
+        }
+    }
+    store.finalize();
+    
+    std::vector<float> queries;
+    for (size_t q = 0; q < NQ; ++q) {
+        auto query = generate_random_embedding(DIM, rng);
+        queries.insert(queries.end(), query.begin(), query.end());
+    }
+    
+    auto loop_start = high_resolution_clock::now();
+    std::vector<std::vector<std::pair<float, size_t>>> expected;
+    for (size_t q = 0; q < NQ; ++q) {
+        expected.push_back(store.search(queries.data() + q * DIM, K));
+    }
+    auto loop_time = duration_cast<microseconds>(high_resolution_clock::now() - loop_start).count();
+    
+    auto batch_start = high_resolution_clock::now();
+    auto batched = store.search_batch(queries.data(), NQ, K);
+    auto batch_time = duration_cast<microseconds>(high_resolution_clock::now() - batch_start).count();
+    
+    assert(batched.size() == NQ);
+    for (size_t q = 0; q < NQ; ++q) {
+        assert(batched[q].size() == K);
+        for (size_t i = 0; i < K; ++i) {
+            assert(std::fabs(batched[q][i].first - expected[q][i].first) < 1e-6f);
+        }
+    }
+    
+    SearchOptions parallel;
+    parallel.mode = SearchMode::Parallel;
+    auto batched_parallel = store.search_batch(queries.data(), NQ, K, parallel);
+    for (size_t q = 0; q < NQ; ++q) {
+        for (size_t i = 0; i < K; ++i) {
+            assert(std::fabs(batched_parallel[q][i].first - expected[q][i].first) < 1e-6f);
+        }
+    }
+    
+    assert(store.search_batch(queries.data(), 0, K).empty());
+    
+    std::cout << "   search() loop: " << loop_time / 1000 << "ms, search_batch(): "
+              << batch_time / 1000 << "ms for " << NQ << " queries\n";
+    std::cout << "✅ Batched results match per-query search\n";
+}
+
+// Test 15: Stored metadata drops the embedding and keeps every other field
+void test_metadata_without_embedding() {
+    std::cout << "\n🏷️  Test 15: Metadata stored without the embedding\n";
+    
+    VectorStore store(4);
+    simdjson::ondemand::parser parser;
+    const char* docs[] = {
+        R"({"id":"a","text":"A","metadata":{"embedding":[1,0,0,0],"category":"x","tags":["p","q"]}})",
+        R"({"id":"b","text":"B","metadata":{"source" : { "file": "b.json" } , "embedding": [0, 1, 0, 0] , "rank" : 3 }})",
+        R"({"id":"c","text":"C","metadata":{"embedding":[0,0,1,0]}})",
+    };
+    for (const char* json : docs) {
+        simdjson::padded_string padded(json, std::strlen(json));
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    }
+    
+    // Missing embeddings and wrong dimensions are rejected
+    const char* rejected[] = {
+        R"({"id":"d","text":"D","metadata":{"category":"y"}})",
+        R"({"id":"e","text":"E","metadata":{"embedding":[1,2,3]}})",
+        R"({"id":"f","text":"F","metadata":{"embedding":[1,2,3,4,5]}})",
+        R"({"id":"g","text":"G","metadata":{"embedding":[1,"2",3,4]}})",
+    };
+    for (const char* json : rejected) {
+        simdjson::padded_string padded(json, std::strlen(json));
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) != simdjson::SUCCESS);
+    }
+    
+    store.finalize();
+    assert(store.size() == 3);
+    assert(store.get_entry(0).doc.metadata_json == R"({"category":"x","tags":["p","q"]})");
+    assert(store.get_entry(1).doc.metadata_json == R"({"source":{ "file": "b.json" },"rank":3})");
+    assert(store.get_entry(2).doc.metadata_json == "{}");
+    
+    float query[4] = {0, 1, 0, 0};
+    auto results = store.search(query, 1);
+    assert(results.size() == 1 && store.get_entry(results[0].second).doc.id == "b");
+    
+    std::cout << "✅ Embedding stripped, remaining metadata fields preserved\n";
+}
+
+// Test 16: Embeddings from binary sidecar files
+void test_embedding_sidecar() {
+    std::cout << "\n📎 Test 16: Binary embedding sidecars (.npy / .f32)\n";
+    
+    constexpr size_t NUM_DOCS = 200;
+    const auto dir = std::filesystem::temp_directory_path() / "nvs_test_sidecar";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    
+    // Two files of 100 documents each without embeddings in the JSON
+    std::mt19937 rng(16);
+    std::vector<std::vector<float>> embeddings;
+    for (size_t f = 0; f < 2; ++f) {
+        std::ofstream json(dir / ("part" + std::to_string(f) + ".json"));
+        std::vector<float> rows;
+        json << "[";
+        for (size_t i = f * 100; i < (f + 1) * 100; ++i) {
+            if (i > f * 100) json << ",";
+            json << "{\"id\":\"side-" << i << "\",\"text\":\"Sidecar " << i << "\",\"metadata\":{\"n\":" << i << "}}";
+            embeddings.push_back(generate_random_embedding(DIM, rng));
+            rows.insert(rows.end(), embeddings.back().begin(), embeddings.back().end());
+        }
+        json << "]";
+        
+        if (f == 0) {
+            // NumPy v1: magic, version, little-endian header length, padded dict
+            std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (100, " +
+                                 std::to_string(DIM) + "), }";
+            while ((10 + header.size() + 1) % 64 != 0) header += ' ';
+            header += '\n';
+            std::ofstream npy(dir / "part0.npy", std::ios::binary);
+            npy.write("\x93NUMPY\x01\x00", 8);
+            char len[2] = {char(header.size() & 0xff), char(header.size() >> 8)};
+            npy.write(len, 2);
+            npy << header;
+            npy.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(float));
+        } else {
+            std::ofstream raw(dir / "part1.f32", std::ios::binary);
+            raw.write(reinterpret_cast<const char*>(rows.data()), rows.size() * sizeof(float));
+        }
+    }
+    
+    using Loader = void (*)(VectorStore*, const std::string&);
+    const std::pair<const char*, Loader> loaders[] = {
+        {"standard", VectorStoreLoader::loadDirectory},
+        {"mmap", VectorStoreLoader::loadDirectoryMMap},
+        {"adaptive", VectorStoreLoader::loadDirectoryAdaptive},
+    };
+    for (const auto& [name, load] : loaders) {
+        VectorStore store(DIM);
+        load(&store, dir.string());
+        assert(store.is_finalized());
+        assert(store.size() == NUM_DOCS);
+        
+        // Every document finds itself, so each row reached the right document
+        for (size_t i = 0; i < NUM_DOCS; i += 17) {
+            auto results = store.search(embeddings[i].data(), 1);
+            assert(results.size() == 1);
+            const auto& doc = store.get_entry(results[0].second).doc;
+            assert(doc.id == "side-" + std::to_string(i));
+            assert(doc.metadata_json == "{\"n\":" + std::to_string(i) + "}");
+        }
+        std::cout << "✅ " << name << " loader paired " << NUM_DOCS << " documents with sidecar rows\n";
+    }
+    
+    // A sidecar for a different dimension is rejected with its file
+    {
+        VectorStore store(DIM + 1);
+        VectorStoreLoader::loadDirectory(&store, dir.string());
+        assert(store.is_finalized());
+        assert(store.size() == 0);
+        std::cout << "✅ Mismatched sidecar dimensions rejected\n";
+    }
+    
+    std::filesystem::remove_all(dir);
+}
+
+// Test 17: Large array files are split and parsed by every loader thread
+void test_split_array_loading() {
+    std::cout << "\n🧩 Test 17: Intra-file parallel parsing of large arrays\n";
+    
+    // Element boundaries survive strings holding brackets, commas and escapes
+    const std::string tricky = R"( [ {"a":"],}\"[","b":[1,{"c":2}]} ,
+        "str\\", 12.5e3 , [[]], {} ] )";
+    std::vector<std::pair<size_t, size_t>> elements;
+    assert(split_json_array(tricky.data(), tricky.size(), elements));
+    std::vector<std::string> parts;
+    for (auto [begin, end] : elements) parts.push_back(tricky.substr(begin, end - begin));
+    assert(parts.size() == 5);
+    assert(parts[0] == R"({"a":"],}\"[","b":[1,{"c":2}]})");
+    assert(parts[1] == R"("str\\")");
+    assert(parts[2] == "12.5e3");
+    assert(parts[3] == "[[]]");
+    assert(parts[4] == "{}");
+    assert(!split_json_array("{\"id\":1}", 8, elements));
+    assert(!split_json_array("[{\"id\":1}", 9, elements));
+    
+    // One file above the split threshold
+    constexpr size_t NUM_DOCS = 1400;
+    const auto dir = std::filesystem::temp_directory_path() / "nvs_test_split";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::mt19937 rng(17);
+    std::vector<std::vector<float>> embeddings;
+    {
+        std::ofstream json(dir / "huge.json");
+        json << "[\n";
+        for (size_t i = 0; i < NUM_DOCS; ++i) {
+            embeddings.push_back(generate_random_embedding(DIM, rng));
+            if (i > 0) json << ",\n";
+            json << create_json_document("split-" + std::to_string(i), "Split [" + std::to_string(i) + "]",
+                                         embeddings.back());
+        }
+        json << "\n]";
+    }
+    assert(std::filesystem::file_size(dir / "huge.json") > 16 * 1024 * 1024);
+    
+    using Loader = void (*)(VectorStore*, const std::string&);
+    const std::pair<const char*, Loader> loaders[] = {
+        {"standard", VectorStoreLoader::loadDirectory},
+        {"mmap", VectorStoreLoader::loadDirectoryMMap},
+        {"adaptive", VectorStoreLoader::loadDirectoryAdaptive},
+    };
+    for (const auto& [name, load] : loaders) {
+        VectorStore store(DIM);
+        auto start = high_resolution_clock::now();
+        load(&store, dir.string());
+        auto ms = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        assert(store.is_finalized());
+        assert(store.size() == NUM_DOCS);
+        
+        for (size_t i = 0; i < NUM_DOCS; i += 97) {
+            auto results = store.search(embeddings[i].data(), 1);
+            assert(store.get_entry(results[0].second).doc.id == "split-" + std::to_string(i));
+        }
+        std::cout << "✅ " << name << " loader: " << NUM_DOCS << " documents from one file in " << ms << "ms\n";
+    }
+    
+    std::filesystem::remove_all(dir);
+}
+
+// Test 18: Inserts after finalize() land in the delta segment
+void test_delta_segment() {
+    std::cout << "\n🧱 Test 18: Delta segment and compaction\n";
+    
+    constexpr size_t dim = 32;
+    std::mt19937 rng(18);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings;
+    auto add = [&](VectorStore& store, size_t i) {
+        std::string json_str = create_json_document("delta-" + std::to_string(i), "Delta", embeddings[i]);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    };
+    auto top_id = [&](const VectorStore& store, size_t i, bool exact) {
+        SearchOptions search_options;
+        search_options.exact = exact;
+        auto results = store.search(embeddings[i].data(), 1, search_options);
+        return std::string(store.get_entry(results[0].second).doc.id);
+    };
+    for (size_t i = 0; i < 1200; ++i) embeddings.push_back(generate_random_embedding(dim, rng));
+    
+    VectorStoreOptions options;
+    options.index = IndexType::HNSW;
+    options.min_index_size = 200;
+    options.delta_compact_rows = 0;  // Compact by hand
+    VectorStore store(dim, options);
+    for (size_t i = 0; i < 500; ++i) add(store, i);
+    assert(store.finalize() == simdjson::SUCCESS);
+    
+    // Searchable right away, next to the graph-searched main segment
+    for (size_t i = 500; i < 800; ++i) add(store, i);
+    assert(store.size() == 800);
+    assert(store.delta_size() == 300);
+    for (size_t i = 0; i < 800; i += 7) {
+        assert(top_id(store, i, true) == "delta-" + std::to_string(i));
+        assert(top_id(store, i, false) == "delta-" + std::to_string(i) || i < 500);
+    }
+    auto batch = store.search_batch(embeddings[600].data(), 1, 3);
+    assert(store.get_entry(batch[0][0].second).doc.id == "delta-600");
+    std::cout << "✅ 300 documents searchable in the delta segment\n";
+    
+    // Snapshots carry the delta; its index is rebuilt on open
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_delta.bin").string();
+    assert(store.save(path) == simdjson::SUCCESS);
+    {
+        VectorStore reopened(dim, options);
+        assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+        assert(reopened.size() == 800 && reopened.delta_size() == 0);
+        assert(top_id(reopened, 700, true) == "delta-700");
+    }
+    std::filesystem::remove(path);
+    
+    // Compaction merges the delta into the main segment and its graph
+    assert(store.compact() == simdjson::SUCCESS);
+    assert(store.delta_size() == 0);
+    assert(store.index_type() == IndexType::HNSW);
+    size_t found = 0;
+    for (size_t i = 500; i < 800; ++i) {
+        found += top_id(store, i, false) == "delta-" + std::to_string(i);
+        assert(store.get_entry(i).embedding != nullptr);
+    }
+    assert(found >= 290);
+    std::cout << "✅ Compacted into the graph, " << found << "/300 recalled\n";
+    
+    // Background compaction while searches run; IVF rows get permuted each time
+    options.index = IndexType::IVF;
+    options.ivf.nprobe = 64;
+    options.delta_compact_rows = 100;
+    VectorStore ivf_store(dim, options);
+    for (size_t i = 0; i < 300; ++i) add(ivf_store, i);
+    assert(ivf_store.finalize() == simdjson::SUCCESS);
+    
+    std::atomic<bool> done{false};
+    std::atomic<size_t> searches{0};
+    std::thread searcher([&]() {
+        std::mt19937 search_rng(1);
+        while (!done.load()) {
+            auto query = generate_random_embedding(dim, search_rng);
+            auto results = ivf_store.search(query.data(), 5);
+            assert(!results.empty());
+            for (const auto& r : results) assert(r.second < ivf_store.size());
+            searches++;
+        }
+    });
+    for (size_t i = 300; i < 1200; ++i) {
+        add(ivf_store, i);
+        assert(top_id(ivf_store, i, true) == "delta-" + std::to_string(i));
+    }
+    done = true;
+    searcher.join();
+    
+    assert(ivf_store.compact() == simdjson::SUCCESS);  // Waits for a background run
+    assert(ivf_store.delta_size() == 0);
+    assert(ivf_store.index_type() == IndexType::IVF);
+    for (size_t i = 0; i < 1200; i += 11) {
+        assert(top_id(ivf_store, i, true) == "delta-" + std::to_string(i));
+    }
+    std::cout << "✅ 900 inserts with background compaction alongside " << searches.load() << " searches\n";
+    
+    // Past delta_compact_rows, the trigger scales with the main segment
+    options.index = IndexType::Flat;
+    options.delta_compact_rows = 50;
+    options.delta_compact_fraction = 0.5;
+    VectorStore growing(dim, options);
+    for (size_t i = 0; i < 600; ++i) add(growing, i);
+    assert(growing.finalize() == simdjson::SUCCESS);
+    for (size_t i = 600; i < 899; ++i) add(growing, i);
+    assert(growing.delta_size() == 299);  // Below 0.5 * 600: no background run started
+    add(growing, 899);
+    assert(growing.compact() == simdjson::SUCCESS);
+    assert(growing.delta_size() == 0);
+    std::cout << "✅ Compaction trigger scales with the main segment\n";
+}
+
+// Test 19: Remove and upsert by id
+void test_remove_upsert() {
+    std::cout << "\n🪦 Test 19: Remove and upsert by id\n";
+    
+    constexpr size_t dim = 32;
+    constexpr size_t NUM_DOCS = 600;
+    std::mt19937 rng(19);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings;
+    for (size_t i = 0; i < NUM_DOCS; ++i) embeddings.push_back(generate_random_embedding(dim, rng));
+    auto new_embedding = generate_random_embedding(dim, rng);
+    
+    auto add = [&](VectorStore& store, const std::string& id, const std::vector<float>& embedding, bool replace) {
+        std::string json_str = create_json_document(id, "Text of " + id, embedding);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        return replace ? store.upsert(doc) : store.add_document(doc);
+    };
+    auto top_id = [](const VectorStore& store, const std::vector<float>& query, bool exact) {
+        SearchOptions search_options;
+        search_options.exact = exact;
+        auto results = store.search(query.data(), 1, search_options);
+        return std::string(store.get_entry(results[0].second).doc.id);
+    };
+    auto removed = [](size_t i) { return i % 5 == 0; };
+    
+    // The reopened and compacted copies must answer like the original
+    auto check = [&](const VectorStore& store, const char* label) {
+        for (size_t i = 1; i < NUM_DOCS; i += 3) {
+            std::string id = "doc-" + std::to_string(i);
+            if (i == 1) continue;  // Replaced below
+            if (removed(i)) {
+                assert(store.get_by_id(id) == nullptr);
+                assert(top_id(store, embeddings[i], true) != id);
+            } else {
+                assert(store.get_by_id(id) && store.get_by_id(id)->doc.id == id);
+                assert(top_id(store, embeddings[i], true) == id);
+            }
+        }
+        assert(top_id(store, new_embedding, true) == "doc-1");
+        assert(top_id(store, new_embedding, false) == "doc-1");
+        assert(top_id(store, embeddings[1], true) != "doc-1");
+        std::cout << "✅ " << label << "\n";
+    };
+    
+    const IndexType types[] = {IndexType::Flat, IndexType::HNSW, IndexType::IVF};
+    for (IndexType type : types) {
+        VectorStoreOptions options;
+        options.index = type;
+        options.min_index_size = 100;
+        options.ivf.nprobe = 64;
+        options.delta_compact_rows = 0;
+        VectorStore store(dim, options);
+        for (size_t i = 0; i < NUM_DOCS; ++i) {
+            assert(add(store, "doc-" + std::to_string(i), embeddings[i], false) == simdjson::SUCCESS);
+        }
+        assert(add(store, "doc-1", new_embedding, true) == simdjson::INCORRECT_TYPE);  // Needs the id map
+        assert(store.finalize() == simdjson::SUCCESS);
+        assert(store.index_of("doc-42") == 42);
+        assert(store.index_of("missing") == SIZE_MAX);
+        
+        for (size_t i = 0; i < NUM_DOCS; ++i) {
+            if (removed(i)) assert(store.remove("doc-" + std::to_string(i)));
+        }
+        assert(!store.remove("doc-0"));
+        assert(add(store, "doc-1", new_embedding, true) == simdjson::SUCCESS);
+        assert(store.index_of("doc-1") == NUM_DOCS);
+        assert(store.removed_size() == NUM_DOCS / 5 + 1);
+        
+        // Removed rows never surface, even when k covers the whole store
+        auto all = store.search(embeddings[2].data(), store.size());
+        for (const auto& r : all) assert(r.second == NUM_DOCS || (!removed(r.second) && r.second != 1));
+        auto batch = store.search_batch(embeddings[2].data(), 1, store.size());
+        assert(batch[0].size() == all.size());
+        check(store, "removed and replaced documents hidden from search");
+        
+        // Snapshots drop removed documents and renumber the rest
+        const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_remove.bin").string();
+        assert(store.save(path) == simdjson::SUCCESS);
+        {
+            VectorStore reopened(dim, options);
+            assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+            assert(reopened.size() == NUM_DOCS - NUM_DOCS / 5);
+            check(reopened, "snapshot without removed documents");
+        }
+        
+        // Compaction drops their rows; the id map and entry indices stay
+        assert(store.compact() == simdjson::SUCCESS);
+        assert(store.get_entry(0).embedding == nullptr && store.get_entry(1).embedding == nullptr);
+        assert(store.index_of("doc-1") == NUM_DOCS);
+        check(store, "compacted without removed rows");
+        
+        assert(store.save(path) == simdjson::SUCCESS);
+        {
+            VectorStore reopened(dim, options);
+            assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+            assert(reopened.index_type() == store.index_type());
+            check(reopened, "compacted snapshot renumbered");
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+// Test 20: Growable entry table
+void test_entry_table() {
+    std::cout << "\n📚 Test 20: Growable entry table\n";
+    
+    // Slots claimed with a shared counter are filled by many threads at once
+    SegmentedArray<uint64_t> table;
+    assert(table.allocated_bytes() == 0);
+    constexpr size_t SLOTS = 300000;
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 8; ++t) {
+        writers.emplace_back([&]() {
+            for (size_t i; (i = next.fetch_add(1)) < SLOTS;) *table.ensure(i) = i * 3;
+        });
+    }
+    for (auto& w : writers) w.join();
+    for (size_t i = 0; i < SLOTS; ++i) assert(table[i] == i * 3);
+    assert(table.allocated_bytes() < 2 * SLOTS * sizeof(uint64_t) + SegmentedArray<uint64_t>::BASE * sizeof(uint64_t));
+    assert(table.find(SLOTS * 4) == nullptr);
+    
+    // Far indices only allocate their own segment, value-initialized
+    SegmentedArray<uint64_t> sparse;
+    assert(*sparse.ensure(5'000'000) == 0);
+    assert(sparse.find(0) == nullptr);
+    std::cout << "✅ " << SLOTS << " slots filled by 8 threads in " << table.allocated_bytes() / 1024 << "KB\n";
+    
+    // Small stores stay small; max_documents bounds the store
+    VectorStoreOptions options;
+    options.max_documents = 10;
+    VectorStore store(8, options);
+    std::mt19937 rng(20);
+    simdjson::ondemand::parser parser;
+    for (size_t i = 0; i < 11; ++i) {
+        std::string json_str = create_json_document("cap-" + std::to_string(i), "Capped",
+                                                    generate_random_embedding(8, rng));
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == (i < 10 ? simdjson::SUCCESS : simdjson::CAPACITY));
+    }
+    assert(store.size() == 10);
+    assert(store.finalize() == simdjson::SUCCESS);
+    auto results = store.search(generate_random_embedding(8, rng).data(), 20);
+    assert(results.size() == 10);
+    std::cout << "✅ max_documents enforced\n";
+}
+
+// Test 21: Geometric arena chunks, dedicated oversized chunks and shrink_to_fit
+void test_arena_chunks() {
+    std::cout << "\n🧱 Test 21: Arena chunk sizing\n";
+    
+    // A small arena reserves only its first chunk
+    ArenaOptions options;
+    options.first_chunk = 64 * 1024;
+    options.max_chunk = 1024 * 1024;
+    ArenaAllocator arena(options);
+    assert(arena.reserved_bytes() == 0);
+    char* first = static_cast<char*>(arena.allocate(100, 1));
+    assert(first);
+    assert(arena.reserved_bytes() == 64 * 1024);
+    
+    // Chunks double up to max_chunk; earlier allocations stay put
+    std::memset(first, 'a', 100);
+    for (int i = 0; i < 64; ++i) {
+        char* p = static_cast<char*>(arena.allocate(32 * 1024, 64));
+        assert(p && ((uintptr_t)p % 64) == 0);
+        std::memset(p, 'b', 32 * 1024);
+    }
+    size_t grown = arena.reserved_bytes();
+    assert(grown >= 2 * 1024 * 1024 && grown < 4 * 1024 * 1024);
+    assert(first[99] == 'a');
+    std::cout << "   ✅ Chunks grow geometrically (" << grown / 1024 << "KB for 2MB of data)\n";
+    
+    // Anything over max_chunk gets its own chunk
+    char* big = static_cast<char*>(arena.allocate(3 * 1024 * 1024, 4096));
+    assert(big && ((uintptr_t)big % 4096) == 0);
+    std::memset(big, 'c', 3 * 1024 * 1024);
+    assert(arena.reserved_bytes() >= grown + 3 * 1024 * 1024);
+    char* small = static_cast<char*>(arena.allocate(16, 1));
+    assert(small);
+    std::cout << "   ✅ Oversized allocation gets a dedicated chunk\n";
+    
+    // shrink_to_fit releases the current chunk's tail, and allocation carries on
+    size_t before = arena.reserved_bytes();
+    arena.shrink_to_fit();
+    assert(arena.reserved_bytes() < before);
+    char* after = static_cast<char*>(arena.allocate(1000, 8));
+    assert(after);
+    std::memset(after, 'd', 1000);
+    assert(first[0] == 'a' && big[0] == 'c');
+    std::cout << "   ✅ shrink_to_fit released " << (before - arena.reserved_bytes()) / 1024 << "KB\n";
+    
+    // A store built with the same options finalizes and searches normally
+    VectorStoreOptions store_options;
+    store_options.arena = options;
+    store_options.arena.numa_node = 0;
+    VectorStore store(DIM, store_options);
+    std::mt19937 rng(21);
+    simdjson::ondemand::parser parser;
+    for (size_t i = 0; i < 2000; ++i) {
+        auto embedding = generate_random_embedding(DIM, rng);
+        std::string json_str = create_json_document("a-" + std::to_string(i), "Arena document", embedding);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    }
+    assert(store.finalize() == simdjson::SUCCESS);
+    for (size_t i = 0; i < 2000; i += 397) {
+        auto results = store.search(store.get_entry(i).embedding, 1);
+        assert(results[0].second == i);
+        assert(store.get_entry(i).doc.id == "a-" + std::to_string(i));
+    }
+    std::cout << "   ✅ Store with small chunks and a NUMA hint searches correctly\n";
+}
+
+// Test 22: Parallel finalize with load-time normalization and progress
+void test_parallel_finalize() {
+    std::cout << "\n🏭 Test 22: Parallel finalize\n";
+    
+    constexpr size_t D = 24;
+    constexpr size_t N = 40000;
+    VectorStoreOptions options;
+    options.index = IndexType::IVF;
+    options.quantization = Quantization::Int8;
+    VectorStore store(D, options);
+    
+    // Unnormalized embeddings (norm 3), added from every thread
+    std::vector<std::vector<float>> raw(N);
+    std::mt19937 rng(22);
+    for (auto& v : raw) {
+        v = generate_random_embedding(D, rng);
+        for (float& x : v) x *= 3.0f;
+    }
+    #pragma omp parallel
+    {
+        simdjson::ondemand::parser parser;
+        #pragma omp for schedule(dynamic, 256)
+        for (int64_t i = 0; i < static_cast<int64_t>(N); ++i) {
+            std::string json_str = create_json_document("p-" + std::to_string(i), "Parallel", raw[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            if (parser.iterate(padded).get(doc) || store.add_document(doc)) {
+                std::abort();
+            }
+        }
+    }
+    
+    // Stages arrive in order on this thread, with Compact counting up to all rows
+    std::vector<std::pair<FinalizeStage, size_t>> events;
+    const auto caller = std::this_thread::get_id();
+    auto error = store.finalize([&](FinalizeStage stage, size_t done, size_t total) {
+        assert(std::this_thread::get_id() == caller);
+        assert(done <= total || stage == FinalizeStage::Done);
+        assert(stage == FinalizeStage::Done || total == N);
+        events.emplace_back(stage, done);
+    });
+    assert(error == simdjson::SUCCESS);
+    assert(events.size() >= 7);
+    assert(events.front() == std::make_pair(FinalizeStage::Compact, size_t(0)));
+    assert(events.back() == std::make_pair(FinalizeStage::Done, N));
+    for (size_t e = 1; e < events.size(); ++e) {
+        assert(events[e].first >= events[e - 1].first || 
+               (events[e - 1].first == FinalizeStage::Index && events[e].first == FinalizeStage::Quantize));
+        if (events[e].first == events[e - 1].first) assert(events[e].second >= events[e - 1].second);
+    }
+    std::vector<FinalizeStage> order;
+    for (auto& event : events) {
+        if (order.empty() || order.back() != event.first) order.push_back(event.first);
+    }
+    assert((order == std::vector<FinalizeStage>{FinalizeStage::Compact, FinalizeStage::Index,
+                                                FinalizeStage::Quantize, FinalizeStage::Done}));
+    std::cout << "   ✅ " << events.size() << " progress events in stage order\n";
+    
+    // Every row is the normalized input, wherever IVF placed it
+    SearchOptions exact;
+    exact.exact = true;
+    for (size_t i = 0; i < N; i += 997) {
+        // Parallel adds claim slots in any order
+        size_t idx = store.index_of("p-" + std::to_string(i));
+        assert(idx < N);
+        const float* row = store.get_entry(idx).embedding;
+        for (size_t d = 0; d < D; ++d) {
+            assert(std::fabs(row[d] - raw[i][d] / 3.0f) < 1e-5f);
+        }
+        auto results = store.search(row, 1, exact);
+        assert(results[0].second == idx);
+    }
+    assert(store.index_type() == IndexType::IVF);
+    std::cout << "   ✅ Rows normalized at load and copied by " << omp_get_max_threads() << " threads\n";
+}
+
+// Test 23: Metadata filters pushed into the scan, graph and lists
+void test_filtered_search() {
+    std::cout << "\n🔎 Test 23: Filtered search\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 3000;
+    constexpr size_t LATE = 200;
+    const char* tenants[] = {"t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7", "t8", "t9"};
+    const char* langs[] = {"en", "de", "fr"};
+    
+    struct Meta { std::string tenant, lang; int prio; bool flag; };
+    auto meta_of = [&](size_t i) {
+        return Meta{tenants[(i * 7) % 10], langs[i % 3], int(i % 5), i % 4 == 0};
+    };
+    auto make_doc = [&](size_t i, const std::vector<float>& embedding) {
+        Meta m = meta_of(i);
+        std::stringstream json;
+        json << "{\"id\":\"f-" << i << "\",\"text\":\"Filtered\",\"metadata\":{\"tenant\":\"" << m.tenant
+             << "\",\"lang\":\"" << m.lang << "\",\"prio\":" << m.prio << ",\"flag\":"
+             << (m.flag ? "true" : "false") << ",\"tags\":[\"x\"],\"embedding\":[";
+        for (size_t d = 0; d < embedding.size(); ++d) {
+            if (d > 0) json << ",";
+            json << std::fixed << std::setprecision(6) << embedding[d];
+        }
+        json << "]}}";
+        return json.str();
+    };
+    
+    std::mt19937 rng(23);
+    std::vector<std::vector<float>> embeddings(N + LATE);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    std::vector<std::vector<float>> queries(20);
+    for (auto& q : queries) q = generate_random_embedding(D, rng);
+    auto removed = [](size_t i) { return i % 11 == 5; };
+    
+    // Ground truth: exact top-k over matching, live documents
+    auto truth = [&](const float* query, size_t k, const std::function<bool(const Meta&)>& pred) {
+        std::vector<std::pair<float, size_t>> all;
+        for (size_t i = 0; i < N + LATE; ++i) {
+            if (removed(i) || !pred(meta_of(i))) continue;
+            float s = 0;
+            for (size_t d = 0; d < D; ++d) s += query[d] * embeddings[i][d];
+            all.emplace_back(s, i);
+        }
+        std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+        if (all.size() > k) all.resize(k);
+        return all;
+    };
+    
+    SearchFilter broad;
+    broad.clauses = {{"tenant", {"t1", "t3", "t4"}}, {"lang", {"en", "fr"}}};
+    auto broad_pred = [](const Meta& m) {
+        return (m.tenant == "t1" || m.tenant == "t3" || m.tenant == "t4") && (m.lang == "en" || m.lang == "fr");
+    };
+    SearchFilter narrow;  // About 1 in 30 documents
+    narrow.clauses = {{"tenant", {"t2"}}, {"prio", {3}}, {"flag", {false}}};
+    auto narrow_pred = [](const Meta& m) { return m.tenant == "t2" && m.prio == 3 && !m.flag; };
+    SearchFilter wide;  // Two thirds: HNSW walks the graph instead of scanning
+    wide.clauses = {{"lang", {"en", "de"}}};
+    auto wide_pred = [](const Meta& m) { return m.lang != "fr"; };
+    const SearchFilter* filters[] = {&broad, &narrow, &wide};
+    const std::function<bool(const Meta&)> preds[] = {broad_pred, narrow_pred, wide_pred};
+    
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_filter_snapshot.bin").string();
+    for (IndexType index : {IndexType::Flat, IndexType::IVF, IndexType::HNSW}) {
+        VectorStoreOptions options;
+        options.index = index;
+        options.filter_fields = {"tenant", "lang", "prio", "flag", "tags"};
+        options.delta_compact_rows = 0;
+        if (index == IndexType::IVF) {
+            options.quantization = Quantization::Int8;
+            options.ivf.nlist = 16;  // Random vectors have no clusters: probe half the lists
+        }
+        VectorStore store(D, options);
+        simdjson::ondemand::parser parser;
+        auto add = [&](size_t i) {
+            std::string json_str = make_doc(i, embeddings[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            assert(!parser.iterate(padded).get(doc));
+            assert(store.add_document(doc) == simdjson::SUCCESS);
+        };
+        for (size_t i = 0; i < N; ++i) add(i);
+        assert(store.finalize() == simdjson::SUCCESS);
+        for (size_t i = N; i < N + LATE; ++i) add(i);  // Delta segment
+        for (size_t i = 0; i < N + LATE; ++i) {
+            if (removed(i)) assert(store.remove("f-" + std::to_string(i)));
+        }
+        
+        auto check = [&](const VectorStore& s, const char* label) {
+            double found = 0, wanted = 0;
+            for (const auto& q : queries) {
+                for (int which = 0; which < 3; ++which) {
+                    SearchOptions search_options;
+                    search_options.filter = *filters[which];
+                    search_options.ef = 16;
+                    const auto& pred = preds[which];
+                    auto expected = truth(q.data(), 10, pred);
+                    auto results = s.search(q.data(), 10, search_options);
+                    for (const auto& r : results) {
+                        size_t i = std::stoul(std::string(s.get_entry(r.second).doc.id.substr(2)));
+                        assert(!removed(i) && pred(meta_of(i)));
+                        for (const auto& e : expected) found += e.second == i;
+                    }
+                    wanted += expected.size();
+                    
+                    // The flat scan is exact
+                    search_options.exact = true;
+                    results = s.search(q.data(), 10, search_options);
+                    assert(results.size() == expected.size());
+                    for (size_t r = 0; r < results.size(); ++r) {
+                        assert(s.get_entry(results[r].second).doc.id == "f-" + std::to_string(expected[r].second));
+                    }
+                }
+            }
+            double recall = found / wanted;
+            assert(recall >= (index == IndexType::Flat ? 1.0 : 0.7));
+            std::cout << "   ✅ " << label << ": every hit matches, recall " << recall << "\n";
+        };
+        const char* names[] = {"flat", "hnsw", "ivf-sq8"};
+        const std::string label = names[static_cast<int>(index)];
+        check(store, label.c_str());
+        
+        // Unknown fields and values match nothing; array fields are not indexed
+        SearchOptions none;
+        none.filter.clauses = {{"tenant", {"nobody"}}};
+        assert(store.search(queries[0].data(), 5, none).empty());
+        none.filter.clauses = {{"colour", {"red"}}};
+        assert(store.search(queries[0].data(), 5, none).empty());
+        none.filter.clauses = {{"tags", {"x"}}};
+        assert(store.search(queries[0].data(), 5, none).empty());
+        assert(store.is_filter_field("lang") && !store.is_filter_field("colour"));
+        
+        // Filtered batches run query by query
+        std::vector<float> batch;
+        for (const auto& q : queries) batch.insert(batch.end(), q.begin(), q.end());
+        SearchOptions batch_options;
+        batch_options.filter = broad;
+        auto batches = store.search_batch(batch.data(), queries.size(), 10, batch_options);
+        for (size_t q = 0; q < queries.size(); ++q) {
+            assert(batches[q] == store.search(queries[q].data(), 10, batch_options));
+        }
+        
+        // Columns survive compaction and are rebuilt from a snapshot
+        assert(store.compact() == simdjson::SUCCESS);
+        check(store, (label + " compacted").c_str());
+        assert(store.save(path) == simdjson::SUCCESS);
+        VectorStore reopened(D, options);
+        assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+        check(reopened, (label + " snapshot").c_str());
+        std::filesystem::remove(path);
+    }
+    
+    // Values compare decoded and by type, however the JSON spells them
+    VectorStoreOptions value_options;
+    value_options.filter_fields = {"v"};
+    VectorStore spelled(4, value_options);
+    simdjson::ondemand::parser parser;
+    const char* docs[] = {
+        R"({"id":"e0","text":"","metadata":{"embedding":[1,0,0,0],"v":"caf\u00e9"}})",
+        R"({"id":"e1","text":"","metadata":{"embedding":[1,0,0,0],"v":"a\"b"}})",
+        R"({"id":"e2","text":"","metadata":{"embedding":[1,0,0,0],"v":"C:\\x"}})",
+        R"({"id":"e3","text":"","metadata":{"embedding":[1,0,0,0],"v":1.0}})",
+        R"({"id":"e4","text":"","metadata":{"embedding":[1,0,0,0],"v":1e3}})",
+        R"({"id":"e5","text":"","metadata":{"embedding":[1,0,0,0],"v":true}})",
+        R"({"id":"e6","text":"","metadata":{"embedding":[1,0,0,0],"v":"true"}})",
+    };
+    for (const char* json : docs) {
+        simdjson::padded_string padded(json, std::strlen(json));
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(spelled.add_document(doc) == simdjson::SUCCESS);
+    }
+    assert(spelled.finalize() == simdjson::SUCCESS);
+    assert(spelled.save(path) == simdjson::SUCCESS);
+    VectorStore respelled(4, value_options);
+    assert(respelled.open_snapshot(path) == simdjson::SUCCESS);
+    std::filesystem::remove(path);
+    for (const VectorStore* store : {&spelled, &respelled}) {
+        const float query[4] = {1, 0, 0, 0};
+        auto only = [&](SearchFilter::Value value) {
+            SearchOptions options;
+            options.filter.clauses = {{"v", {value}}};
+            auto results = store->search(query, 10, options);
+            return results.size() == 1 ? results[0].second : SIZE_MAX;
+        };
+        assert(only("caf\xc3\xa9") == 0);
+        assert(only("a\"b") == 1);
+        assert(only("C:\\x") == 2);
+        assert(only(1) == 3 && only(1.0) == 3);
+        assert(only(1000) == 4);
+        assert(only(true) == 5 && only("true") == 6);
+        assert(only("1") == SIZE_MAX && only(false) == SIZE_MAX);
+    }
+    std::cout << "   ✅ escaped strings, number spellings and value types\n";
+}
+
+// Test 24: BM25 text search (block-max WAND) and hybrid fusion
+void test_text_search() {
+    std::cout << "\n📚 Test 24: BM25 text search and hybrid search\n";
+    
+    constexpr size_t D = 16;
+    constexpr size_t N = 3000;
+    constexpr size_t LATE = 150;
+    constexpr size_t VOCAB = 300;
+    
+    // Skewed word frequencies, so common words have many blocks of postings
+    std::mt19937 rng(24);
+    std::vector<std::vector<size_t>> words(N + LATE);
+    for (auto& doc : words) {
+        size_t length = 3 + rng() % 40;
+        for (size_t w = 0; w < length; ++w) {
+            double u = std::uniform_real_distribution<double>(0, 1)(rng);
+            doc.push_back(static_cast<size_t>(VOCAB * u * u * u));
+        }
+    }
+    auto text_of = [&](size_t i) {
+        std::string text;
+        for (size_t w : words[i]) text += (w % 7 == 0 ? "W" : "w") + std::to_string(w) + (w % 5 ? " " : ", ");
+        return text;
+    };
+    std::vector<std::vector<float>> embeddings(N + LATE);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    auto removed = [](size_t i) { return i % 13 == 4; };
+    
+    // Brute-force BM25: statistics over `stats`, scores for `candidates`
+    auto truth = [&](const std::vector<size_t>& query, size_t k, const std::function<bool(size_t)>& stats,
+                     const std::function<bool(size_t)>& candidates) {
+        const float k1 = 1.2f, b = 0.75f;
+        double docs = 0, length = 0;
+        std::vector<double> df(VOCAB, 0);
+        for (size_t i = 0; i < N + LATE; ++i) {
+            if (!stats(i)) continue;
+            ++docs;
+            length += words[i].size();
+            std::vector<size_t> distinct = words[i];
+            std::sort(distinct.begin(), distinct.end());
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+            for (size_t w : distinct) ++df[w];
+        }
+        const float avg = std::max(1.0f, float(length / docs));
+        std::vector<std::pair<float, size_t>> all;
+        for (size_t i = 0; i < N + LATE; ++i) {
+            if (!candidates(i)) continue;
+            float score = 0;
+            for (size_t w : query) {
+                float tf = float(std::count(words[i].begin(), words[i].end(), w));
+                if (tf == 0) continue;
+                float idf = std::log(1.0f + (float(docs) - float(df[w]) + 0.5f) / (float(df[w]) + 0.5f));
+                score += idf * tf * (k1 + 1) / (tf + k1 * (1 - b + b * float(words[i].size()) / avg));
+            }
+            if (score > 0) all.emplace_back(score, i);
+        }
+        std::sort(all.begin(), all.end(), [](const auto& x, const auto& y) { return x.first > y.first; });
+        if (all.size() > k) all.resize(k);
+        return all;
+    };
+    std::vector<std::vector<size_t>> queries;
+    for (size_t q = 0; q < 30; ++q) {
+        std::vector<size_t> query;
+        for (size_t t = 0; t < 1 + q % 4; ++t) query.push_back((q * 37 + t * 11) % (q < 10 ? 20 : VOCAB));
+        std::sort(query.begin(), query.end());
+        query.erase(std::unique(query.begin(), query.end()), query.end());
+        queries.push_back(query);
+    }
+    auto query_text = [](const std::vector<size_t>& query) {
+        std::string text;
+        for (size_t w : query) text += "W" + std::to_string(w) + " ";  // Matching ignores case
+        return text;
+    };
+    auto index_of = [](const VectorStore& s, size_t idx) {
+        return std::stoul(std::string(s.get_entry(idx).doc.id.substr(2)));
+    };
+    auto check = [&](const VectorStore& s, const std::function<bool(size_t)>& stats,
+                     const std::function<bool(size_t)>& candidates, const char* label) {
+        for (const auto& query : queries) {
+            auto expected = truth(query, 10, stats, candidates);
+            auto results = s.text_search(query_text(query), 10);
+            assert(results.size() == expected.size());
+            for (size_t r = 0; r < results.size(); ++r) {
+                // Equal scores may come in either order: compare scores, and ids where unambiguous
+                assert(std::abs(results[r].first - expected[r].first) < 1e-4f * expected[r].first);
+                size_t i = index_of(s, results[r].second);
+                assert(candidates(i));
+                if (r + 1 < expected.size() && (r == 0 || expected[r - 1].first - expected[r].first > 1e-4f) &&
+                    expected[r].first - expected[r + 1].first > 1e-4f) {
+                    assert(i == expected[r].second);
+                }
+            }
+        }
+        std::cout << "   ✅ " << label << ": block-max WAND matches brute-force BM25\n";
+    };
+    
+    VectorStoreOptions options;
+    options.text_index = true;
+    options.filter_fields = {"tenant"};
+    options.delta_compact_rows = 0;
+    VectorStore store(D, options);
+    simdjson::ondemand::parser parser;
+    auto add = [&](size_t i) {
+        std::stringstream json;
+        json << "{\"id\":\"t-" << i << "\",\"text\":\"" << text_of(i) << "\",\"metadata\":{\"tenant\":\"t"
+             << i % 3 << "\",\"embedding\":[";
+        for (size_t d = 0; d < D; ++d) json << (d ? "," : "") << std::fixed << std::setprecision(6) << embeddings[i][d];
+        json << "]}}";
+        simdjson::padded_string padded(json.str());
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    };
+    for (size_t i = 0; i < N; ++i) add(i);
+    assert(store.text_search("w1", 5).empty());  // Loading phase
+    assert(store.finalize() == simdjson::SUCCESS);
+    auto main_docs = [](size_t i) { return i < N; };
+    check(store, main_docs, main_docs, "finalized");
+    
+    // Delta documents are scored against the main index statistics; removed documents drop out
+    for (size_t i = N; i < N + LATE; ++i) add(i);
+    for (size_t i = 0; i < N + LATE; ++i) {
+        if (removed(i)) assert(store.remove("t-" + std::to_string(i)));
+    }
+    auto live = [&](size_t i) { return !removed(i); };
+    check(store, main_docs, live, "delta + removed");
+    
+    // Filters apply to both the index and the delta
+    SearchOptions filtered;
+    filtered.filter.clauses = {{"tenant", {"t1"}}};
+    for (const auto& query : queries) {
+        auto expected = truth(query, 10, main_docs, [&](size_t i) { return live(i) && i % 3 == 1; });
+        auto results = store.text_search(query_text(query), 10, filtered);
+        assert(results.size() == expected.size());
+        for (size_t r = 0; r < results.size(); ++r) {
+            assert(index_of(store, results[r].second) % 3 == 1);
+            assert(std::abs(results[r].first - expected[r].first) < 1e-4f * expected[r].first);
+        }
+    }
+    std::cout << "   ✅ filtered text search\n";
+    assert(store.text_search("nothing-matches-this", 10).empty());
+    assert(store.text_search(" ,. ", 10).empty());
+    
+    // Hybrid: alpha = 1 is vector order, alpha = 0 text order; a document first in both wins
+    for (size_t q = 0; q < 10; ++q) {
+        const std::string text = query_text(queries[q]);
+        const size_t own_doc = removed(q * 100 + 1) ? q * 100 + 2 : q * 100 + 1;
+        std::vector<float> query = embeddings[own_doc];
+        kernels::normalize(query.data(), D);
+        auto vector_hits = store.search(query.data(), 10);
+        auto text_hits = store.text_search(text, 10);
+        auto pure_vector = store.hybrid_search(query.data(), text, 10, 1.0f);
+        auto pure_text = store.hybrid_search(query.data(), text, 10, 0.0f);
+        assert(pure_vector.size() == vector_hits.size() && pure_text.size() == text_hits.size());
+        for (size_t r = 0; r < vector_hits.size(); ++r) assert(pure_vector[r].second == vector_hits[r].second);
+        for (size_t r = 0; r + 1 < text_hits.size(); ++r) {
+            const bool untied = (r == 0 || text_hits[r - 1].first > text_hits[r].first) &&
+                                text_hits[r].first > text_hits[r + 1].first;
+            if (untied) assert(pure_text[r].second == text_hits[r].second);
+        }
+        
+        auto fused = store.hybrid_search(query.data(), text, 10);
+        assert(fused.size() == 10);
+        for (size_t r = 1; r < fused.size(); ++r) assert(fused[r - 1].first >= fused[r].first);
+        if (!text_hits.empty() && vector_hits[0].second == text_hits[0].second) {
+            assert(fused[0].second == vector_hits[0].second);
+        }
+        // A document's own embedding and words put it first by both measures
+        auto own_hits = store.hybrid_search(query.data(), query_text(words[own_doc]), 10);
+        assert(own_hits[0].second == store.index_of("t-" + std::to_string(own_doc)));
+    }
+    std::cout << "   ✅ hybrid search fuses vector and BM25 ranks\n";
+    
+    // Compaction rebuilds the postings (and statistics) over live documents only
+    assert(store.compact() == simdjson::SUCCESS);
+    check(store, live, live, "compacted");
+    
+    // The text index is rebuilt when a snapshot is opened
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_text_snapshot.bin").string();
+    assert(store.save(path) == simdjson::SUCCESS);
+    VectorStore reopened(D, options);
+    assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+    check(reopened, live, live, "snapshot");
+    std::filesystem::remove(path);
+    
+    // Without text_index, text search finds nothing
+    VectorStore plain(D);
+    assert(plain.finalize() == simdjson::SUCCESS);
+    assert(plain.text_search("w1", 5).empty());
+}
+
+// Test 25: Load, finalize and search statistics
+void test_store_stats() {
+    std::cout << "\n📈 Test 25: Load and search statistics\n";
+    
+    constexpr size_t D = 32;
+    const auto dir = std::filesystem::temp_directory_path() / "nvs_test_stats";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    
+    // 3 files of 100 documents; the last one also holds 2 bad documents and 1 bad embedding
+    std::mt19937 rng(25);
+    size_t bytes = 0;
+    for (size_t f = 0; f < 3; ++f) {
+        const auto file = dir / ("part" + std::to_string(f) + ".json");
+        {
+            std::ofstream json(file);
+            json << "[";
+            for (size_t i = 0; i < 100; ++i) {
+                if (i > 0) json << ",";
+                json << create_json_document("s-" + std::to_string(f * 100 + i), "Stats", generate_random_embedding(D, rng));
+            }
+            if (f == 2) {
+                json << ",{\"text\":\"no id\"},42";
+                json << "," << create_json_document("short", "Stats", generate_random_embedding(D - 1, rng));
+            }
+            json << "]";
+        }
+        bytes += std::filesystem::file_size(file);
+    }
+    
+    VectorStore store(D);
+    VectorStoreLoader::loadDirectory(&store, dir.string());
+    std::filesystem::remove_all(dir);
+    assert(store.size() == 300);
+    
+    StoreStats stats = store.stats();
+    if (!stats.enabled) {
+        std::cout << "   ✅ built with NVS_NO_STATS: nothing recorded\n";
+        return;
+    }
+    assert(stats.files_read == 3 && stats.bytes_read == bytes);
+    assert(stats.documents_added == 300);
+    assert(stats.documents_rejected == 3);
+    assert(stats.rejected_by_error[simdjson::NO_SUCH_FIELD] == 1);     // Missing id
+    assert(stats.rejected_by_error[simdjson::INCORRECT_TYPE] == 2);    // Not an object; short embedding
+    assert(stats.read_ns > 0 && stats.parse_ns >= stats.add_ns && stats.add_ns > 0 && stats.finalize_ns > 0);
+    assert(stats.arena_used_bytes > 0 && stats.arena_used_bytes <= stats.arena_reserved_bytes);
+    assert(stats.omp_threads >= 1);
+    std::cout << "   ✅ load: " << stats.files_read << " files, " << stats.bytes_read << " bytes, "
+              << stats.documents_rejected << " rejected; read " << stats.read_ns / 1000 << "us, parse "
+              << stats.parse_ns / 1000 << "us, add " << stats.add_ns / 1000 << "us\n";
+    
+    // Searches: one latency sample each, and every row of the flat scan counted
+    auto query = generate_random_embedding(D, rng);
+    for (int i = 0; i < 10; ++i) store.search(query.data(), 5);
+    store.search_batch(query.data(), 1, 5);
+    stats = store.stats();
+    assert(stats.searches == 11);
+    uint64_t samples = 0;
+    for (uint64_t bucket : stats.latency_histogram) samples += bucket;
+    assert(samples == 11 && stats.search_ns > 0);
+    assert(stats.rows_scanned == 11 * 300 && stats.graph_searches == 0);
+    assert(stats.lock_waits <= stats.searches);
+    
+    // Documents added by hand count too
+    simdjson::ondemand::parser parser;
+    simdjson::padded_string bad(std::string("{\"id\":\"x\",\"text\":\"t\"}"));
+    simdjson::ondemand::document doc;
+    assert(!parser.iterate(bad).get(doc));
+    assert(store.add_document(doc) == simdjson::NO_SUCH_FIELD);
+    assert(store.stats().documents_rejected == 4);
+    std::cout << "   ✅ search: " << stats.searches << " searches, " << stats.rows_scanned << " rows scanned, "
+              << stats.search_ns / stats.searches << "ns average\n";
+}
+
+// Test 26: NUMA-sharded matrix scans agree with a single shard
+void test_numa_shards() {
+    std::cout << "\n🧭 Test 26: NUMA-sharded matrix and scans\n";
+    
+    // Topology helpers
+    assert((numa::parse_list("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    assert(numa::parse_list("").empty());
+    size_t first, last;
+    numa::shard_threads(1, 2, 8, first, last);
+    assert(first == 4 && last == 8);
+    numa::shard_threads(3, 4, 2, first, last);
+    assert(first == 1 && last == 2);
+    
+    constexpr size_t D = 48;
+    constexpr size_t N = 5000;
+    std::mt19937 rng(26);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings(N);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    auto load = [&](VectorStore& store) {
+        for (size_t i = 0; i < N; ++i) {
+            std::string json_str = create_json_document("numa-" + std::to_string(i), "Numa", embeddings[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            assert(!parser.iterate(padded).get(doc));
+            assert(store.add_document(doc) == simdjson::SUCCESS);
+        }
+        assert(store.finalize() == simdjson::SUCCESS);
+    };
+    
+    // Three shards on the first node (one per listed entry), against an unsharded store
+    const int node = numa::topology().empty() ? 0 : numa::topology()[0].id;
+    for (Quantization quantization : {Quantization::None, Quantization::Int8}) {
+        VectorStoreOptions plain_options;
+        plain_options.quantization = quantization;
+        VectorStoreOptions numa_options = plain_options;
+        numa_options.numa.shard = true;
+        numa_options.numa.nodes = {node, node, node, 12345};
+        VectorStore plain(D, plain_options), sharded(D, numa_options);
+        load(plain);
+        load(sharded);
+        const size_t shards = sharded.numa_nodes().size();
+        assert(shards == (numa::topology().empty() ? 0 : 3));
+        
+        sharded.remove("numa-7");
+        plain.remove("numa-7");
+        SearchOptions parallel;
+        parallel.mode = SearchMode::Parallel;
+        for (size_t q = 0; q < 20; ++q) {
+            auto expected = plain.search(embeddings[q * 50].data(), 10);
+            auto got = sharded.search(embeddings[q * 50].data(), 10, parallel);
+            assert(got.size() == expected.size());
+            for (size_t i = 0; i < got.size(); ++i) {
+                assert(got[i].second == expected[i].second);
+            }
+        }
+        std::vector<float> queries;
+        for (size_t q = 0; q < 6; ++q) queries.insert(queries.end(), embeddings[q + 7].begin(), embeddings[q + 7].end());
+        auto batch = sharded.search_batch(queries.data(), 6, 5, parallel);
+        for (size_t q = 0; q < 6; ++q) {
+            auto expected = plain.search(embeddings[q + 7].data(), 5);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                assert(batch[q][i].second == expected[i].second);
+            }
+        }
+        std::cout << "   ✅ " << quantization_name(quantization) << ": " << shards
+                  << " shards, results match the unsharded store\n";
+    }
+}
+
+// Test 27: Large-k top-k selection matches a full sort
+void test_large_k_selection() {
+    std::cout << "\n🥇 Test 27: Large-k selection against a full sort\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 20000;
+    std::mt19937 rng(27);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings(N);
+    VectorStore store(D);
+    for (size_t i = 0; i < N; ++i) {
+        embeddings[i] = generate_random_embedding(D, rng);
+        std::string json_str = create_json_document("k-" + std::to_string(i), "K", embeddings[i]);
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    }
+    assert(store.finalize() == simdjson::SUCCESS);
+    store.remove("k-3");
+    
+    SearchOptions sequential, parallel;
+    sequential.mode = SearchMode::Sequential;
+    parallel.mode = SearchMode::Parallel;
+    std::vector<float> queries;
+    for (size_t q = 0; q < 3; ++q) {
+        auto query = generate_random_embedding(D, rng);
+        queries.insert(queries.end(), query.begin(), query.end());
+    }
+    for (size_t k : {size_t(1), size_t(10), size_t(200), size_t(1000), N}) {
+        auto batch = store.search_batch(queries.data(), 3, k, parallel);
+        for (size_t q = 0; q < 3; ++q) {
+            // Reference: every live row's stored score, fully sorted
+            const float* query = queries.data() + q * D;
+            std::vector<float> all;
+            for (size_t i = 0; i < N; ++i) {
+                if (i != 3) all.push_back(kernels::dot(store.get_entry(i).embedding, query, D));
+            }
+            std::sort(all.begin(), all.end(), std::greater<float>());
+            const size_t expected = std::min(k, all.size());
+            
+            for (const auto& results : {store.search(query, k, sequential), store.search(query, k, parallel), batch[q]}) {
+                assert(results.size() == expected);
+                for (size_t i = 0; i < expected; ++i) {
+                    assert(results[i].first == all[i]);
+                    assert(results[i].second != 3);
+                }
+            }
+        }
+        std::cout << "   ✅ k = " << k << ": sequential, parallel and batched match\n";
+    }
+}
+
+// Test 28: Range search and minimum-score cutoffs
+void test_range_search() {
+    std::cout << "\n🎚️  Test 28: Range search and minimum scores\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 3000;
+    constexpr float MIN_SCORE = 0.5f;
+    std::mt19937 rng(28);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings(N);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    
+    for (int config = 0; config < 3; ++config) {
+        VectorStoreOptions options;
+        options.delta_compact_rows = 0;
+        options.min_index_size = 100;
+        if (config == 1) options.quantization = Quantization::Int8;
+        if (config == 2) options.index = IndexType::HNSW;
+        VectorStore store(D, options);
+        auto add = [&](size_t i) {
+            std::string json_str = create_json_document("range-" + std::to_string(i), "Range", embeddings[i]);
+            simdjson::padded_string padded(json_str);
+            simdjson::ondemand::document doc;
+            assert(!parser.iterate(padded).get(doc));
+            assert(store.add_document(doc) == simdjson::SUCCESS);
+        };
+        for (size_t i = 0; i < N - 200; ++i) add(i);
+        assert(store.finalize() == simdjson::SUCCESS);
+        for (size_t i = N - 200; i < N; ++i) add(i);  // Delta segment
+        assert(store.remove("range-11"));
+        
+        size_t hits = 0;
+        for (size_t q = 0; q < 20; ++q) {
+            const float* query = embeddings[q * 149].data();
+            std::vector<float> expected;
+            for (size_t i = 0; i < N; ++i) {
+                if (i == 11) continue;
+                float score = kernels::dot(store.get_entry(i).embedding, query, D);
+                if (score >= MIN_SCORE) expected.push_back(score);
+            }
+            std::sort(expected.begin(), expected.end(), std::greater<float>());
+            hits += expected.size();
+            
+            for (SearchMode mode : {SearchMode::Sequential, SearchMode::Parallel}) {
+                SearchOptions search_options;
+                search_options.mode = mode;
+                auto all = store.search_range(query, MIN_SCORE, 0, search_options);
+                assert(all.size() == expected.size());
+                for (size_t i = 0; i < all.size(); ++i) {
+                    assert(all[i].first == expected[i]);
+                    assert(all[i].second != 11);
+                }
+                auto capped = store.search_range(query, MIN_SCORE, 3, search_options);
+                assert(capped.size() == std::min<size_t>(3, expected.size()));
+                for (size_t i = 0; i < capped.size(); ++i) assert(capped[i].first == expected[i]);
+                
+                // min_score on top-k: exact for the flat scan, a floor for the others
+                search_options.min_score = MIN_SCORE;
+                auto top = store.search(query, 50, search_options);
+                for (const auto& r : top) assert(r.first >= MIN_SCORE);
+                if (config == 0) {
+                    assert(top.size() == std::min<size_t>(50, expected.size()));
+                    for (size_t i = 0; i < top.size(); ++i) assert(top[i].first == expected[i]);
+                }
+            }
+        }
+        assert(store.search_range(embeddings[0].data(), 1.5f).empty());
+        std::cout << "   ✅ " << (config == 0 ? "flat" : config == 1 ? "int8" : "hnsw") << ": " << hits
+                  << " hits at cosine >= " << MIN_SCORE << " match brute force\n";
+    }
+}
+
+// Test 29: Query result cache hits, misses and invalidation
+void test_query_cache() {
+    std::cout << "\n🗃️  Test 29: Query result cache\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 2000;
+    std::mt19937 rng(29);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings(N + 10);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    
+    VectorStoreOptions options;
+    options.delta_compact_rows = 0;
+    options.filter_fields = {"category"};
+    options.query_cache.max_bytes = 64 * 1024;
+    options.query_cache.shards = 4;
+    VectorStore store(D, options);
+    auto add = [&](size_t i) {
+        std::string json_str = "{\"id\":\"cache-" + std::to_string(i) + "\",\"text\":\"t\",\"metadata\":{\"category\":\"" +
+                               std::to_string(i % 3) + "\",\"embedding\":[";
+        for (size_t j = 0; j < D; ++j) json_str += (j ? "," : "") + std::to_string(embeddings[i][j]);
+        json_str += "]}}";
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    };
+    for (size_t i = 0; i < N; ++i) add(i);
+    assert(store.finalize() == simdjson::SUCCESS);
+    
+    const float* query = embeddings[5].data();
+    auto first = store.search(query, 10);
+    assert(store.stats().cache_misses == 1 && store.stats().cache_hits == 0);
+    assert(store.search(query, 10) == first);
+    assert(store.stats().cache_hits == 1);
+    
+    // Different k, filter or cutoff: separate entries
+    SearchOptions filtered;
+    filtered.filter.clauses.push_back({"category", {"1"}});
+    auto other = store.search(query, 5, filtered);
+    for (const auto& r : other) assert(r.second % 3 == 1);
+    store.search(query, 5);
+    store.search_range(query, 0.3f);
+    assert(store.stats().cache_hits == 1 && store.stats().cache_misses == 4);
+    assert(store.search(query, 5, filtered) == other);
+    assert(store.stats().cache_hits == 2);
+    
+    // Removals, inserts and compaction invalidate
+    assert(first[0].second == 5);
+    assert(store.remove("cache-5"));
+    auto after_remove = store.search(query, 10);
+    assert(after_remove.size() == 10 && after_remove[0].second != 5);
+    assert(store.stats().cache_hits == 2);
+    add(N);  // Delta insert: the closest match for its own embedding
+    assert(store.search(embeddings[N].data(), 1)[0].second == N);
+    auto before_compact = store.search(query, 10);
+    assert(store.compact() == simdjson::SUCCESS);
+    const uint64_t misses = store.stats().cache_misses;
+    assert(store.search(query, 10) == before_compact);
+    assert(store.stats().cache_misses == misses + 1);
+    
+    // Bounded: many distinct queries never exceed the budget
+    for (size_t q = 0; q < N; q += 3) store.search(embeddings[q].data(), 20);
+    assert(store.stats().query_cache_bytes <= options.query_cache.max_bytes);
+    assert(store.stats().query_cache_entries > 0);
+    
+    // Concurrent searches and inserts: nothing cached while a document was
+    // being added is served once it is visible
+    std::atomic<bool> done{false};
+    std::thread writer([&]() {
+        for (size_t i = N + 1; i < N + 10; ++i) {
+            add(i);
+            std::this_thread::yield();
+        }
+        done = true;
+    });
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            while (!done) store.search(embeddings[N + 1 + t].data(), 3);
+        });
+    }
+    writer.join();
+    for (auto& r : readers) r.join();
+    for (size_t t = 0; t < 4; ++t) {
+        auto results = store.search(embeddings[N + 1 + t].data(), 3);
+        assert(results[0].second == N + 1 + t);
+    }
+    std::cout << "   ✅ " << store.stats().cache_hits << " hits, " << store.stats().cache_misses << " misses, "
+              << store.stats().query_cache_bytes << " bytes cached\n";
+}
+
+// Test 30: Stores published by name and attached from one mapping
+void test_shared_store() {
+    std::cout << "\n🤝 Test 30: Published stores attached by name\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 1500;
+    std::mt19937 rng(30);
+    simdjson::ondemand::parser parser;
+    std::vector<std::vector<float>> embeddings(N + 1);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    
+    VectorStoreOptions options;
+    options.quantization = Quantization::Int8;
+    options.index = IndexType::HNSW;
+    options.min_index_size = 0;
+    options.delta_compact_rows = 0;
+    VectorStore store(D, options);
+    auto add = [&](size_t i) {
+        std::string json_str = "{\"id\":\"shared-" + std::to_string(i) + "\",\"text\":\"t\",\"metadata\":{\"embedding\":[";
+        for (size_t j = 0; j < D; ++j) json_str += (j ? "," : "") + std::to_string(embeddings[i][j]);
+        json_str += "]}}";
+        simdjson::padded_string padded(json_str);
+        simdjson::ondemand::document doc;
+        assert(!parser.iterate(padded).get(doc));
+        assert(store.add_document(doc) == simdjson::SUCCESS);
+    };
+    for (size_t i = 0; i < N; ++i) add(i);
+    assert(store.finalize() == simdjson::SUCCESS);
+    
+    assert(VectorStore::shared_path("").empty());
+    assert(VectorStore::shared_path("../escape").empty());
+    assert(store.publish("a/b") == simdjson::INCORRECT_TYPE);
+    
+    const std::string name = "test-" + std::to_string(rng());
+    VectorStore missing(D, options);
+    assert(missing.attach(name) == simdjson::IO_ERROR);
+    assert(store.publish(name) == simdjson::SUCCESS);
+    assert(std::filesystem::exists(VectorStore::shared_path(name)));
+    
+    // Every attached store serves the same results as the publisher
+    VectorStore first(D, options), second(D, options);
+    assert(first.attach(name) == simdjson::SUCCESS);
+    assert(second.attach(name) == simdjson::SUCCESS);
+    assert(first.is_finalized() && first.size() == N && first.index_type() == IndexType::HNSW);
+    for (size_t q = 0; q < 20; ++q) {
+        auto expected = store.search(embeddings[q * 7].data(), 10);
+        assert(first.search(embeddings[q * 7].data(), 10) == expected);
+        assert(second.search(embeddings[q * 7].data(), 10) == expected);
+    }
+    assert(second.get_entry(42).doc.id == "shared-42");
+    
+    // Attached stores take writes privately, like any snapshot-opened store
+    assert(first.remove("shared-7"));
+    assert(second.search(embeddings[7].data(), 1)[0].second == 7);
+    
+    // A pending delta leaves the graph out of the snapshot: attaching would
+    // mean rebuilding it in every process, so it is refused until compact()
+    add(N);
+    assert(store.publish(name) == simdjson::SUCCESS);
+    VectorStore stale(D, options);
+    assert(stale.attach(name) == simdjson::INCORRECT_TYPE);
+    assert(store.compact() == simdjson::SUCCESS);
+    assert(store.publish(name) == simdjson::SUCCESS);
+    VectorStore fresh(D, options);
+    assert(fresh.attach(name) == simdjson::SUCCESS);
+    assert(fresh.size() == N + 1);
+    assert(fresh.search(embeddings[N].data(), 1)[0].second == N);
+    
+    // Racing publishes of one name each write their own temporary file, so
+    // whichever rename lands last installs a whole snapshot
+    std::vector<std::thread> publishers;
+    for (int t = 0; t < 4; ++t) {
+        publishers.emplace_back([&]() {
+            for (int i = 0; i < 3; ++i) assert(store.publish(name) == simdjson::SUCCESS);
+        });
+    }
+    for (auto& publisher : publishers) publisher.join();
+    VectorStore raced(D, options);
+    assert(raced.attach(name) == simdjson::SUCCESS);
+    assert(raced.search(embeddings[N].data(), 1)[0].second == N);
+    const auto shared_file = std::filesystem::path(VectorStore::shared_path(name));
+    for (const auto& file : std::filesystem::directory_iterator(shared_file.parent_path())) {
+        assert(file.path().filename().string().rfind(shared_file.filename().string() + ".tmp", 0) != 0);
+    }
+    
+    // Unpublishing removes the name; existing mappings stay valid
+    assert(VectorStore::unpublish(name) == simdjson::SUCCESS);
+    assert(VectorStore::unpublish(name) == simdjson::IO_ERROR);
+    VectorStore late(D, options);
+    assert(late.attach(name) == simdjson::IO_ERROR);
+    assert(fresh.search(embeddings[N].data(), 1)[0].second == N);
+    assert(second.get_entry(42).doc.id == "shared-42");
+    std::cout << "   ✅ " << N << " documents served from one mapping by two stores\n";
+}
+
+// Test 31: NDJSON, JSON array and binary buffer ingestion
+void test_buffer_ingestion() {
+    std::cout << "\n📥 Test 31: NDJSON, array and binary ingestion\n";
+    
+    constexpr size_t D = 32;
+    constexpr size_t N = 3000;
+    std::mt19937 rng(31);
+    std::vector<std::vector<float>> embeddings(N + 50);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    
+    // Full float precision, so every store sees the same embeddings
+    auto doc_json = [&](size_t i) {
+        std::ostringstream json;
+        json << std::setprecision(9) << "{\"id\":\"doc-" << i << "\",\"text\":\"text " << i
+             << "\",\"metadata\":{\"embedding\":[";
+        for (size_t j = 0; j < D; ++j) json << (j ? "," : "") << embeddings[i][j];
+        json << "],\"n\":" << i << "}}";
+        return json.str();
+    };
+    
+    LoaderOptions options;
+    options.parse_threads = 4;
+    
+    // NDJSON with blank and CRLF lines, one document without an id and one cut off mid-string
+    std::string ndjson;
+    for (size_t i = 0; i < N; ++i) {
+        ndjson += doc_json(i) + (i % 100 == 0 ? "\r\n\n" : "\n");
+        if (i == 1000) ndjson += "{\"text\":\"no id\",\"metadata\":{\"embedding\":[1]}}\n";
+        if (i == 2000) ndjson += "{\"id\":\"cut\n";
+    }
+    VectorStore lines(D);
+    auto result = VectorStoreLoader::addBuffer(&lines, ndjson.data(), ndjson.size(), options);
+    assert(result.added == N && result.rejected == 2);
+    assert(lines.stats().documents_rejected == 2);
+    
+    // JSON array with a non-object element and a document with a numeric id
+    std::string array = "[\n";
+    for (size_t i = 0; i < N; ++i) array += doc_json(i) + ",\n";
+    array += "5, {\"id\":7,\"text\":\"t\",\"metadata\":{}}\n]";
+    VectorStore elements(D);
+    result = VectorStoreLoader::addBuffer(&elements, array.data(), array.size(), options);
+    assert(result.added == N && result.rejected == 2);
+    
+    std::string broken = "[{\"id\":\"a\"}, {";
+    result = VectorStoreLoader::addBuffer(&elements, broken.data(), broken.size(), options);
+    assert(result.added == 0 && result.rejected == 1);
+    
+    // Binary: ids, texts and one contiguous block of embeddings
+    std::vector<std::string> id_strings, text_strings;
+    std::vector<float> block;
+    for (size_t i = 0; i < N; ++i) {
+        id_strings.push_back("doc-" + std::to_string(i));
+        text_strings.push_back("text " + std::to_string(i));
+        block.insert(block.end(), embeddings[i].begin(), embeddings[i].end());
+    }
+    std::vector<std::string_view> ids(id_strings.begin(), id_strings.end());
+    std::vector<std::string_view> texts(text_strings.begin(), text_strings.end());
+    VectorStore binary(D);
+    assert(binary.add_documents(ids.data(), texts.data(), block.data(), N) == N);
+    
+    for (VectorStore* store : {&lines, &elements, &binary}) {
+        assert(store->finalize() == simdjson::SUCCESS);
+        assert(store->size() == N);
+    }
+    
+    // Same documents whichever way they came in (entry order differs)
+    for (size_t q = 0; q < 50; ++q) {
+        const float* query = embeddings[q * 37].data();
+        auto expected = lines.search(query, 5);
+        assert(lines.get_entry(expected[0].second).doc.id == "doc-" + std::to_string(q * 37));
+        assert(std::abs(expected[0].first - 1.0f) < 1e-5f);
+        for (const VectorStore* store : {&elements, &binary}) {
+            auto actual = store->search(query, 5);
+            assert(actual.size() == expected.size());
+            for (size_t i = 0; i < actual.size(); ++i) {
+                assert(store->get_entry(actual[i].second).doc.id == lines.get_entry(expected[i].second).doc.id);
+                assert(std::abs(actual[i].first - expected[i].first) < 1e-6f);
+            }
+        }
+    }
+    auto hit = elements.get_by_id("doc-42");
+    assert(hit && hit->doc.text == "text 42" && hit->doc.metadata_json == "{\"n\":42}");
+    hit = binary.get_by_id("doc-42");
+    assert(hit && hit->doc.text == "text 42" && hit->doc.metadata_json == "{}");
+    
+    // Serving phase: both paths append to the delta segment
+    std::string more;
+    for (size_t i = N; i < N + 25; ++i) more += doc_json(i) + "\n";
+    result = VectorStoreLoader::addBuffer(&lines, more.data(), more.size(), options);
+    assert(result.added == 25 && lines.size() == N + 25);
+    std::vector<std::string_view> more_ids = {"late-0", "late-1"};
+    std::vector<std::string_view> more_texts = {"", ""};
+    std::vector<float> more_block(embeddings[N + 30].begin(), embeddings[N + 30].end());
+    more_block.insert(more_block.end(), embeddings[N + 31].begin(), embeddings[N + 31].end());
+    assert(binary.add_documents(more_ids.data(), more_texts.data(), more_block.data(), 2) == 2);
+    assert(lines.get_entry(lines.search(embeddings[N + 10].data(), 1)[0].second).doc.id ==
+           "doc-" + std::to_string(N + 10));
+    assert(binary.get_entry(binary.search(embeddings[N + 31].data(), 1)[0].second).doc.id == "late-1");
+    std::cout << "   ✅ " << N << " documents from NDJSON, array and binary input agree\n";
+}
+
+// Test 32: Product quantization recall, snapshots and IVF-PQ
+void test_product_quantization() {
+    std::cout << "\n🧩 Test 32: Product quantization (ADC, 4-bit fast-scan, IVF-PQ)\n";
+    
+    constexpr size_t D = 64;
+    constexpr size_t N = 3000;
+    constexpr size_t K = 10;
+    std::mt19937 rng(32);
+    std::vector<std::vector<float>> embeddings(N);
+    for (auto& e : embeddings) e = generate_random_embedding(D, rng);
+    std::vector<std::vector<float>> queries(30);
+    for (auto& q : queries) q = generate_random_embedding(D, rng);
+    
+    auto build = [&](const VectorStoreOptions& options) {
+        auto store = std::make_unique<VectorStore>(D, options);
+        std::vector<std::string> ids(N), texts(N);
+        std::vector<std::string_view> id_views(N), text_views(N);
+        std::vector<float> flat(N * D);
+        for (size_t i = 0; i < N; ++i) {
+            ids[i] = "pq-" + std::to_string(i);
+            texts[i] = "text " + std::to_string(i);
+            id_views[i] = ids[i];
+            text_views[i] = texts[i];
+            std::copy(embeddings[i].begin(), embeddings[i].end(), flat.begin() + i * D);
+        }
+        assert(store->add_documents(id_views.data(), text_views.data(), flat.data(), N) == N);
+        assert(store->finalize() == simdjson::SUCCESS);
+        return store;
+    };
+    
+    auto exact = build(VectorStoreOptions());
+    auto recall_at_k = [&](const VectorStore& store) {
+        size_t hits = 0;
+        for (const auto& query : queries) {
+            auto truth = exact->search(query.data(), K);
+            auto approx = store.search(query.data(), K);
+            assert(approx.size() == K);
+            for (const auto& a : approx) {
+                for (const auto& t : truth) {
+                    if (a.second == t.second) { ++hits; break; }
+                }
+            }
+        }
+        return double(hits) / (queries.size() * K);
+    };
+    
+    // The quantizer on its own: 4-bit block scans of unaligned ranges agree with
+    // whole-range scans and stay within the byte table's rounding of the float table
+    {
+        std::vector<float> matrix(N * D);
+        for (size_t i = 0; i < N; ++i) std::copy(embeddings[i].begin(), embeddings[i].end(), matrix.begin() + i * D);
+        PqParams params;
+        params.bits = 4;
+        ProductQuantizer pq;
+        assert(pq.allocate(N, D, params));
+        pq.train(matrix.data(), D);
+        assert(pq.m() == D / 4 && pq.bits() == 4 && pq.centroids() == 16);
+        
+        ProductQuantizer::Table table;
+        pq.prepare_query(queries[0].data(), table);
+        std::vector<float> all(N), part(77 - 5);
+        pq.score_rows(table, 0, N, all.data());
+        pq.score_rows(table, 5, 77, part.data());
+        for (size_t i = 5; i < 77; ++i) assert(part[i - 5] == all[i]);
+        
+        for (size_t i = 0; i < N; i += 97) {
+            const uint8_t* block = pq.codes() + (i / 32) * pq.m() * 16;
+            const size_t r = i % 32;
+            float ref = 0.0f;
+            for (size_t j = 0; j < pq.m(); ++j) {
+                uint8_t byte = block[j * 16 + (r & 15)];
+                ref += table.lut[j * 16 + (r < 16 ? byte & 15 : byte >> 4)];
+            }
+            assert(std::fabs(all[i] - ref) <= table.scale * (0.5f * pq.m() + 1.0f));
+        }
+    }
+    
+    const std::string path = (std::filesystem::temp_directory_path() / "nvs_test_pq.bin").string();
+    struct Config {
+        const char* name;
+        IndexType index;
+        size_t bits;
+        double min_recall;
+    };
+    for (const Config& config : {Config{"PQ8", IndexType::Flat, 8, 0.9},
+                                 Config{"PQ4 fast-scan", IndexType::Flat, 4, 0.85},
+                                 Config{"IVF-PQ8", IndexType::IVF, 8, 0.75}}) {
+        VectorStoreOptions options;
+        options.index = config.index;
+        options.ivf.nlist = 32;
+        options.ivf.nprobe = 16;
+        options.quantization = Quantization::PQ;
+        options.pq.bits = config.bits;
+        options.rerank_oversample = 10;
+        auto store = build(options);
+        assert(store->quantization() == Quantization::PQ);
+        
+        double recall = recall_at_k(*store);
+        std::cout << "   " << config.name << " recall@" << K << ": "
+                  << std::fixed << std::setprecision(3) << recall << std::defaultfloat << "\n";
+        assert(recall >= config.min_recall);
+        
+        // Re-ranked scores are exact float scores
+        auto results = store->search(queries[0].data(), K);
+        float expected_score = kernels::dot(store->get_entry(results[0].second).embedding, queries[0].data(), D);
+        assert(std::fabs(results[0].first - expected_score) < 1e-5f);
+        
+        // Codebooks and codes are mapped back from a snapshot, not retrained
+        assert(store->save(path) == simdjson::SUCCESS);
+        VectorStore reopened(D, options);
+        assert(reopened.open_snapshot(path) == simdjson::SUCCESS);
+        assert(reopened.quantization() == Quantization::PQ);
+        for (const auto& query : queries) {
+            auto a = store->search(query.data(), K);
+            auto b = reopened.search(query.data(), K);
+            assert(a.size() == b.size());
+            for (size_t i = 0; i < a.size(); ++i) assert(a[i].second == b[i].second);
+        }
+        
+        // A store configured with another code width retrains on open
+        VectorStoreOptions other = options;
+        other.pq.bits = config.bits == 8 ? 4 : 8;
+        VectorStore retrained(D, other);
+        assert(retrained.open_snapshot(path) == simdjson::SUCCESS);
+        assert(retrained.quantization() == Quantization::PQ);
+        assert(recall_at_k(retrained) >= 0.7);
+        
+        // Codebook and code sections are sized against the record before they are used
+        const std::string corrupt_path = path + ".corrupt";
+        for (uint32_t type : {snapshot::SECTION_PQ_CODEBOOKS, snapshot::SECTION_PQ_CODES}) {
+            copy_with_short_section(path, corrupt_path, type, 16);
+            VectorStore corrupted(D, options);
+            assert(corrupted.open_snapshot(corrupt_path) == simdjson::IO_ERROR);
+        }
+        std::filesystem::remove(corrupt_path);
+    }
+    
+    std::filesystem::remove(path);
+    std::cout << "✅ Product-quantized search matches exact search within recall target\n";
+}
+
 int main() {
     std::cout << "🔥 Starting concurrent stress tests...\n";
     
@@ -384,10 +2844,36 @@ int main() {
     
     test_loading_performance();
     test_phase_enforcement();
-    // test_oversize_allocation();
+    test_oversize_allocation();
     test_alignment_requests();
     test_phase_separation();
     test_concurrent_search_performance();
+    test_snapshot_roundtrip();
+    test_contiguous_matrix();
+    test_simd_kernels();
+    test_quantized_search();
+    test_hnsw_index();
+    test_ivf_index();
+    test_search_executor();
+    test_search_batch();
+    test_metadata_without_embedding();
+    test_embedding_sidecar();
+    test_split_array_loading();
+    test_delta_segment();
+    test_remove_upsert();
+    test_entry_table();
+    test_arena_chunks();
+    test_parallel_finalize();
+    test_filtered_search();
+    test_text_search();
+    test_store_stats();
+    test_numa_shards();
+    test_large_k_selection();
+    test_range_search();
+    test_query_cache();
+    test_shared_store();
+    test_buffer_ingestion();
+    test_product_quantization();
     
     std::cout << "\n✅ All stress tests passed!\n";
     return 0;
@@ -0,0 +1,231 @@
+#include "text_index.h"
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "vector_store.h"  // TopK
+
+uint64_t term_hash(std::string_view token) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : token) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (byte >= 'A' && byte <= 'Z') byte += 'a' - 'A';
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+size_t tokenize(std::string_view text, std::vector<uint64_t>& terms) {
+    auto is_word = [](unsigned char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+    };
+    size_t tokens = 0;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !is_word(static_cast<unsigned char>(text[i]))) ++i;
+        size_t start = i;
+        while (i < text.size() && is_word(static_cast<unsigned char>(text[i]))) ++i;
+        if (i > start) {
+            terms.push_back(term_hash(text.substr(start, i - start)));
+            ++tokens;
+        }
+    }
+    return tokens;
+}
+
+void count_terms(std::vector<uint64_t>& terms, std::vector<TermCount>& counts) {
+    counts.clear();
+    std::sort(terms.begin(), terms.end());
+    for (size_t i = 0; i < terms.size();) {
+        size_t j = i;
+        while (j < terms.size() && terms[j] == terms[i]) ++j;
+        counts.push_back({terms[i], static_cast<uint32_t>(j - i)});
+        i = j;
+    }
+}
+
+float TextIndex::idf(size_t df) const {
+    return std::log(1.0f + (float(docs_) - float(df) + 0.5f) / (float(df) + 0.5f));
+}
+
+float TextIndex::weight(float idf, uint32_t count, uint32_t length) const {
+    const float tf = float(count);
+    const float norm = params_.k1 * (1.0f - params_.b + params_.b * float(length) / avg_length_);
+    return idf * tf * (params_.k1 + 1.0f) / (tf + norm);
+}
+
+bool TextIndex::build(size_t n, const TermSource& source, const Bm25Params& params, bool parallel) {
+    params_ = params;
+    docs_ = 0;
+    term_ids_.clear();
+    terms_.clear();
+    if (!lengths_.allocate(std::max<size_t>(n, 1))) {
+        return false;
+    }
+    std::memset(lengths_.data(), 0, std::max<size_t>(n, 1) * sizeof(uint32_t));
+
+    // Pass 1: dictionary and document frequencies. Term ids are remembered so
+    // the fill pass does not hash every term again.
+    std::vector<uint32_t> pair_terms;
+    std::vector<uint64_t> df;
+    uint64_t total_length = 0;
+    for (size_t i = 0; i < n; ++i) {
+        DocTerms doc = source(i);
+        if (!doc.terms) continue;
+        ++docs_;
+        lengths_[i] = doc.length;
+        total_length += doc.length;
+        for (uint32_t t = 0; t < doc.count; ++t) {
+            auto [it, inserted] = term_ids_.try_emplace(doc.terms[t].term, static_cast<uint32_t>(df.size()));
+            if (inserted) df.push_back(0);
+            ++df[it->second];
+            pair_terms.push_back(it->second);
+        }
+    }
+    avg_length_ = docs_ ? std::max(1.0f, float(double(total_length) / double(docs_))) : 1.0f;
+
+    // Lists back to back, each followed by one block maximum per BLOCK postings
+    terms_.resize(df.size());
+    uint64_t offset = 0;
+    uint64_t blocks = 0;
+    for (size_t t = 0; t < df.size(); ++t) {
+        terms_[t].begin = terms_[t].end = offset;
+        terms_[t].first_block = blocks;
+        terms_[t].idf = idf(df[t]);
+        offset += df[t];
+        blocks += (df[t] + BLOCK - 1) / BLOCK;
+    }
+    if (!postings_.allocate(std::max<uint64_t>(offset, 1)) || !block_max_.allocate(std::max<uint64_t>(blocks, 1))) {
+        return false;
+    }
+
+    // Pass 2: documents in ascending order, so every list comes out sorted
+    size_t pair = 0;
+    for (size_t i = 0; i < n; ++i) {
+        DocTerms doc = source(i);
+        if (!doc.terms) continue;
+        for (uint32_t t = 0; t < doc.count; ++t) {
+            Term& term = terms_[pair_terms[pair++]];
+            postings_[term.end++] = {static_cast<uint32_t>(i), doc.terms[t].count};
+        }
+    }
+
+    // Score upper bounds, per block and per list
+    #pragma omp parallel for schedule(dynamic, 256) if(parallel)
+    for (int64_t t = 0; t < static_cast<int64_t>(terms_.size()); ++t) {
+        Term& term = terms_[t];
+        float list_max = 0;
+        for (uint64_t b = term.begin; b < term.end; b += BLOCK) {
+            float block = 0;
+            for (uint64_t p = b; p < std::min(term.end, b + BLOCK); ++p) {
+                block = std::max(block, weight(term.idf, postings_[p].count, lengths_[postings_[p].doc]));
+            }
+            block_max_[term.first_block + (b - term.begin) / BLOCK] = block;
+            list_max = std::max(list_max, block);
+        }
+        term.max_score = list_max;
+    }
+    return true;
+}
+
+float TextIndex::term_score(uint64_t term, uint32_t count, uint32_t length) const {
+    auto it = term_ids_.find(term);
+    return weight(it == term_ids_.end() ? idf(0) : terms_[it->second].idf, count, length);
+}
+
+std::vector<std::pair<float, size_t>>
+TextIndex::search(const std::vector<uint64_t>& terms, size_t k,
+                  const std::function<bool(uint32_t)>& accept) const {
+    if (docs_ == 0 || k == 0) return {};
+
+    // One cursor per query term present in the index
+    struct Cursor {
+        const Term* term;
+        uint64_t pos;
+    };
+    std::vector<Cursor> cursors;
+    for (uint64_t hash : terms) {
+        auto it = term_ids_.find(hash);
+        if (it != term_ids_.end()) cursors.push_back({&terms_[it->second], terms_[it->second].begin});
+    }
+    constexpr uint32_t END = UINT32_MAX;
+    auto doc = [&](const Cursor& c) { return c.pos < c.term->end ? postings_[c.pos].doc : END; };
+    auto seek = [&](Cursor& c, uint32_t target) {
+        // Jump whole blocks by their last document, then search inside one
+        uint64_t block_end = std::min(c.term->end, c.term->begin + ((c.pos - c.term->begin) / BLOCK + 1) * BLOCK);
+        while (block_end < c.term->end && postings_[block_end - 1].doc < target) {
+            c.pos = block_end;
+            block_end = std::min(c.term->end, block_end + BLOCK);
+        }
+        c.pos = std::lower_bound(postings_.data() + c.pos, postings_.data() + block_end, target,
+                                 [](const Posting& p, uint32_t d) { return p.doc < d; }) - postings_.data();
+    };
+    // Block of `c` that would hold `target` (which is >= doc(c)): its bound and its last document
+    auto block_bound = [&](const Cursor& c, uint32_t target, uint32_t& last) {
+        uint64_t b = (c.pos - c.term->begin) / BLOCK;
+        uint64_t block_end = std::min(c.term->end, c.term->begin + (b + 1) * BLOCK);
+        while (block_end < c.term->end && postings_[block_end - 1].doc < target) {
+            ++b;
+            block_end = std::min(c.term->end, block_end + BLOCK);
+        }
+        last = postings_[block_end - 1].doc;
+        return block_max_[c.term->first_block + b];
+    };
+
+    TopK heap(k);
+    auto threshold = [&]() { return heap.heap.size() < k ? 0.0f : heap.heap.front().first; };
+    while (true) {
+        std::sort(cursors.begin(), cursors.end(), [&](const Cursor& a, const Cursor& b) { return doc(a) < doc(b); });
+
+        // Pivot: first cursor at which the summed list bounds beat the threshold
+        const float theta = threshold();
+        float bound = 0;
+        size_t pivot = cursors.size();
+        for (size_t i = 0; i < cursors.size() && doc(cursors[i]) != END; ++i) {
+            bound += cursors[i].term->max_score;
+            if (bound > theta) {
+                pivot = i;
+                break;
+            }
+        }
+        if (pivot == cursors.size()) break;  // No remaining document can enter the top k
+        const uint32_t pivot_doc = doc(cursors[pivot]);
+        while (pivot + 1 < cursors.size() && doc(cursors[pivot + 1]) == pivot_doc) ++pivot;
+
+        // Block-max check: tighter bounds from the blocks that hold pivot_doc
+        float block_sum = 0;
+        uint32_t next = pivot + 1 < cursors.size() ? doc(cursors[pivot + 1]) : END;
+        for (size_t i = 0; i <= pivot; ++i) {
+            uint32_t last;
+            block_sum += block_bound(cursors[i], pivot_doc, last);
+            next = std::min(next, last == END ? END : last + 1);
+        }
+        if (block_sum <= theta) {
+            // Nothing in these blocks can beat the threshold: skip past them
+            next = std::max(next, pivot_doc + 1);
+            for (size_t i = 0; i <= pivot; ++i) {
+                if (doc(cursors[i]) < next) seek(cursors[i], next);
+            }
+            continue;
+        }
+
+        if (doc(cursors[0]) == pivot_doc) {
+            // Every cursor up to the pivot is on pivot_doc: score it
+            if (accept(pivot_doc)) {
+                float score = 0;
+                for (size_t i = 0; i <= pivot; ++i) {
+                    const Posting& p = postings_[cursors[i].pos];
+                    score += weight(cursors[i].term->idf, p.count, lengths_[pivot_doc]);
+                }
+                heap.push(score, pivot_doc);
+            }
+            for (size_t i = 0; i <= pivot; ++i) ++cursors[i].pos;
+        } else {
+            // Bring the cursors before the pivot up to pivot_doc
+            for (size_t i = 0; i < pivot && doc(cursors[i]) < pivot_doc; ++i) {
+                seek(cursors[i], pivot_doc);
+            }
+        }
+    }
+    return std::move(heap.heap);
+}
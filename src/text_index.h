@@ -0,0 +1,90 @@
+#pragma once
+#include "aligned_array.h"
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// BM25 tuning knobs
+struct Bm25Params {
+    float k1 = 1.2f;   // Term frequency saturation
+    float b = 0.75f;   // Document length normalization
+};
+
+// One distinct term of a document and its number of occurrences
+struct TermCount {
+    uint64_t term;  // term_hash() of the token
+    uint32_t count;
+};
+
+// Hash of a lowercased token (FNV-1a, 64 bits)
+uint64_t term_hash(std::string_view token);
+
+// Split `text` into tokens - runs of ASCII letters, digits and '_' plus any
+// non-ASCII bytes, so identifiers such as `add_document` stay whole - and
+// append their lowercased hashes to `terms`. Returns the number of tokens.
+size_t tokenize(std::string_view text, std::vector<uint64_t>& terms);
+
+// Sort and count the hashes from tokenize() into distinct terms
+void count_terms(std::vector<uint64_t>& terms, std::vector<TermCount>& counts);
+
+// BM25 inverted index over document ids [0, n). Posting lists are laid out
+// back to back in one array, sorted by document, with the highest possible
+// score of each block of BLOCK postings kept beside them. Queries run
+// block-max WAND: documents whose upper bound cannot enter the top k are
+// skipped a block at a time, without being scored.
+class TextIndex {
+public:
+    static constexpr size_t BLOCK = 128;
+
+    // Distinct terms and token count of document i; terms == nullptr leaves it out
+    struct DocTerms {
+        const TermCount* terms = nullptr;
+        uint32_t count = 0;
+        uint32_t length = 0;
+    };
+    using TermSource = std::function<DocTerms(size_t doc)>;
+
+    // Build postings for documents [0, n), on an OpenMP team if `parallel`;
+    // returns false on allocation failure
+    bool build(size_t n, const TermSource& source, const Bm25Params& params, bool parallel = true);
+
+    bool empty() const { return docs_ == 0; }
+
+    // Top-k (score, doc) for the distinct query terms, unsorted. Only
+    // documents for which accept(doc) holds are scored.
+    std::vector<std::pair<float, size_t>> search(const std::vector<uint64_t>& terms, size_t k,
+                                                 const std::function<bool(uint32_t)>& accept) const;
+
+    // BM25 contribution of `count` occurrences of `term` in a document of
+    // `length` tokens, using this index's statistics (for documents added
+    // after it was built)
+    float term_score(uint64_t term, uint32_t count, uint32_t length) const;
+
+private:
+    struct Posting {
+        uint32_t doc;
+        uint32_t count;
+    };
+    struct Term {
+        uint64_t begin = 0;        // Postings [begin, end)
+        uint64_t end = 0;
+        uint64_t first_block = 0;  // Index of its first block in block_max_
+        float idf = 0;
+        float max_score = 0;       // Upper bound over the whole list
+    };
+
+    float idf(size_t df) const;
+    float weight(float idf, uint32_t count, uint32_t length) const;
+
+    Bm25Params params_;
+    size_t docs_ = 0;       // Indexed documents
+    float avg_length_ = 1;
+    std::unordered_map<uint64_t, uint32_t> term_ids_;
+    std::vector<Term> terms_;
+    AlignedArray<Posting> postings_;
+    AlignedArray<float> block_max_;
+    AlignedArray<uint32_t> lengths_;  // Token count per document id
+};
@@ -1,9 +1,30 @@
 #include "vector_store.h"
+#include <limits>
+#include <type_traits>
 
 // ArenaAllocator implementation
 
-ArenaAllocator::ArenaAllocator() : head_(std::make_unique<Chunk>()), 
-                                   current_(head_.get()) {}
+ArenaAllocator::ArenaAllocator(const ArenaOptions& options)
+    : options_(options),
+      next_chunk_(std::max<size_t>(options.first_chunk, 4096)) {
+    options_.max_chunk = std::max(options_.max_chunk, next_chunk_);
+}
+
+ArenaAllocator::Chunk* ArenaAllocator::map_chunk(size_t bytes) {
+    Chunk* chunk = new (std::nothrow) Chunk;
+    if (!chunk) {
+        return nullptr;
+    }
+    chunk->data = static_cast<char*>(page_memory::map(bytes, options_.huge_pages, options_.numa_node,
+                                                      chunk->mapped));
+    if (!chunk->data) {
+        delete chunk;
+        return nullptr;
+    }
+    chunk->capacity = chunk->mapped;
+    reserved_.fetch_add(chunk->mapped, std::memory_order_relaxed);
+    return chunk;
+}
 
 void* ArenaAllocator::allocate(size_t size, size_t align) {
     // Validate alignment is power of 2 and reasonable
@@ -12,13 +33,32 @@ void* ArenaAllocator::allocate(size_t size, size_t align) {
         return nullptr;  // Alignment too large
     }
     
-    // Validate size
-    if (size > CHUNK_SIZE) {
-        return nullptr;  // Cannot allocate larger than chunk size
+    if (size > SIZE_MAX / 2) {
+        return nullptr;
+    }
+    
+    // Too big for any bump chunk: give it a dedicated one (page aligned, so any
+    // supported alignment holds)
+    if (size + align > options_.max_chunk) {
+        std::lock_guard<std::mutex> lock(chunk_creation_mutex_);
+        Chunk* chunk = map_chunk(size);
+        if (!chunk) {
+            return nullptr;
+        }
+        chunk->offset.store(size, std::memory_order_relaxed);
+        chunk->next = oversized_;
+        oversized_ = chunk;
+        return chunk->data;
     }
     
     Chunk* chunk = current_.load(std::memory_order_acquire);
     while (true) {
+        if (!chunk) {
+            chunk = add_chunk(nullptr, size + align);
+            if (!chunk) {
+                return nullptr;
+            }
+        }
         size_t old_offset = chunk->offset.load(std::memory_order_relaxed);
         
         // Calculate the pointer that would result from current offset
@@ -31,25 +71,12 @@ void* ArenaAllocator::allocate(size_t size, size_t align) {
         size_t aligned_offset = old_offset + padding;
         size_t new_offset = aligned_offset + size;
         
-        if (new_offset > CHUNK_SIZE) {
+        if (new_offset > chunk->capacity) {
             // Need new chunk
-            Chunk* next = chunk->next.load(std::memory_order_acquire);
-            if (!next) {
-                // Lock to prevent multiple threads creating chunks
-                std::lock_guard<std::mutex> lock(chunk_creation_mutex_);
-                // Double-check after acquiring lock
-                next = chunk->next.load(std::memory_order_acquire);
-                if (!next) {
-                    auto new_chunk = std::make_unique<Chunk>();
-                    next = new_chunk.get();
-                    chunk->next.store(next, std::memory_order_release);
-                    // Transfer ownership after setting atomic pointer
-                    new_chunk.release();
-                }
+            chunk = add_chunk(chunk, size + align);
+            if (!chunk) {
+                return nullptr;
             }
-            // Update current to the new chunk
-            current_.store(next, std::memory_order_release);
-            chunk = next;
             continue;
         }
         
@@ -61,13 +88,61 @@ void* ArenaAllocator::allocate(size_t size, size_t align) {
     }
 }
 
+ArenaAllocator::Chunk* ArenaAllocator::add_chunk(Chunk* full, size_t min_bytes) {
+    // Lock to prevent multiple threads creating chunks
+    std::lock_guard<std::mutex> lock(chunk_creation_mutex_);
+    // Double-check after acquiring lock: another thread may have moved on already
+    Chunk* current = current_.load(std::memory_order_acquire);
+    if (current != full) {
+        return current;
+    }
+    
+    // Geometric growth: small stores stay small, large loads reach max_chunk quickly
+    size_t bytes = std::max(next_chunk_, min_bytes);
+    Chunk* chunk = map_chunk(bytes);
+    if (!chunk) {
+        return nullptr;
+    }
+    next_chunk_ = std::min(next_chunk_ * 2, options_.max_chunk);
+    chunk->next = current;
+    current_.store(chunk, std::memory_order_release);
+    return chunk;
+}
+
+void ArenaAllocator::shrink_to_fit() {
+    std::lock_guard<std::mutex> lock(chunk_creation_mutex_);
+    Chunk* chunk = current_.load(std::memory_order_acquire);
+    if (!chunk) {
+        return;
+    }
+    size_t used = chunk->offset.load(std::memory_order_acquire);
+    size_t mapped = page_memory::trim(chunk->data, chunk->mapped, used);
+    reserved_.fetch_sub(chunk->mapped - mapped, std::memory_order_relaxed);
+    chunk->mapped = mapped;
+    chunk->capacity = used;
+    // Grow again from the first size if more documents arrive
+    next_chunk_ = std::max<size_t>(options_.first_chunk, 4096);
+}
+
+size_t ArenaAllocator::used_bytes() const {
+    std::lock_guard<std::mutex> lock(chunk_creation_mutex_);
+    size_t used = 0;
+    for (Chunk* list : {current_.load(std::memory_order_acquire), oversized_}) {
+        for (Chunk* chunk = list; chunk; chunk = chunk->next) {
+            used += std::min(chunk->offset.load(std::memory_order_relaxed), chunk->capacity);
+        }
+    }
+    return used;
+}
+
 ArenaAllocator::~ArenaAllocator() {
-    // Clean up linked chunks
-    Chunk* chunk = head_->next.load(std::memory_order_acquire);
-    while (chunk) {
-        Chunk* next = chunk->next.load(std::memory_order_acquire);
-        delete chunk;
-        chunk = next;
+    for (Chunk* list : {current_.load(std::memory_order_acquire), oversized_}) {
+        while (list) {
+            Chunk* next = list->next;
+            page_memory::unmap(list->data, list->mapped);
+            delete list;
+            list = next;
+        }
     }
 }
 
@@ -108,24 +183,139 @@ void TopK::merge(const TopK& other) {
 
 // VectorStore implementation
 
-VectorStore::VectorStore(size_t dim) : dim_(dim) {
-    entries_.resize(1'000'000);  // Pre-size with default-constructed entries
+VectorStore::VectorStore(size_t dim, const VectorStoreOptions& options) 
+    : options_(options),
+      dim_(dim),
+      stride_((dim + ROW_ALIGN_FLOATS - 1) / ROW_ALIGN_FLOATS * ROW_ALIGN_FLOATS),
+      capacity_(options.max_documents ? std::min<size_t>(options.max_documents, UINT32_MAX) : UINT32_MAX),
+      arena_(options.arena),
+      staging_arena_(std::make_unique<ArenaAllocator>(options.arena)),
+      dot_(kernels::dot_for_dim(dim)),
+      main_(std::make_unique<Segment>()) {
+    for (const std::string& field : options.filter_fields) {
+        if (is_filter_field(field)) continue;  // Listed twice
+        filter_columns_.push_back(std::make_unique<FilterColumn>());
+        filter_columns_.back()->field = field;
+    }
+    if (options.numa.shard) {
+        if (options.numa.nodes.empty()) {
+            for (const numa::Node& node : numa::topology()) numa_nodes_.push_back(&node);
+        }
+        for (int id : options.numa.nodes) {
+            if (const numa::Node* node = numa::find_node(id)) numa_nodes_.push_back(node);
+        }
+    }
+    if (options.query_cache.max_bytes) {
+        query_cache_ = std::make_unique<QueryCache>(options.query_cache.max_bytes, options.query_cache.shards);
+    }
+}
+
+VectorStore::~VectorStore() {
+    if (compact_thread_.joinable()) {
+        compact_thread_.join();
+    }
 }
 
 simdjson::error_code VectorStore::add_document(simdjson::ondemand::document& json_doc) {
     simdjson::ondemand::object obj;
     auto error = json_doc.get_object().get(obj);
     if (error) {
-        return error;
+        return stats_.count_add(error);
     }
     return add_document(obj);
 }
 
+// Parse exactly `dim` numbers from a JSON array into `out`. Each element goes
+// through simdjson's double parser (Eisel-Lemire fast path) and is narrowed
+// once on store.
+static simdjson::error_code parse_embedding(simdjson::ondemand::value value, float* out, size_t dim) {
+    simdjson::ondemand::array array;
+    auto error = value.get_array().get(array);
+    if (error) return error;
+    
+    size_t i = 0;
+    for (auto element : array) {
+        double val;
+        error = element.get_double().get(val);
+        if (error) return error;
+        if (i >= dim) {
+            return simdjson::CAPACITY;  // Too many embedding values
+        }
+        out[i++] = float(val);
+    }
+    
+    // Verify we got the expected number of embedding values
+    return i == dim ? simdjson::SUCCESS : simdjson::INCORRECT_TYPE;
+}
+
 simdjson::error_code VectorStore::add_document(simdjson::ondemand::object& json_doc) {
-    // Cannot add documents after finalization
-    if (is_finalized_.load(std::memory_order_acquire)) {
+    ScopedTimer timer(stats_.add_ns);
+    return stats_.count_add(insert(json_doc, nullptr, false));
+}
+
+simdjson::error_code VectorStore::add_document(simdjson::ondemand::object& json_doc, const float* embedding) {
+    ScopedTimer timer(stats_.add_ns);
+    return stats_.count_add(insert(json_doc, embedding, false));
+}
+
+simdjson::error_code VectorStore::upsert(simdjson::ondemand::document& json_doc) {
+    simdjson::ondemand::object obj;
+    auto error = json_doc.get_object().get(obj);
+    if (error) {
+        return stats_.count_add(error);
+    }
+    return upsert(obj);
+}
+
+simdjson::error_code VectorStore::upsert(simdjson::ondemand::object& json_doc) {
+    // The id map only exists once serving
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return simdjson::INCORRECT_TYPE;
+    }
+    ScopedTimer timer(stats_.add_ns);
+    return stats_.count_add(insert(json_doc, nullptr, true));
+}
+
+simdjson::error_code VectorStore::upsert(simdjson::ondemand::object& json_doc, const float* embedding) {
+    if (!is_finalized_.load(std::memory_order_acquire)) {
         return simdjson::INCORRECT_TYPE;
     }
+    ScopedTimer timer(stats_.add_ns);
+    return stats_.count_add(insert(json_doc, embedding, true));
+}
+
+size_t VectorStore::add_documents(const std::string_view* ids, const std::string_view* texts,
+                                  const float* embeddings, size_t count) {
+    const bool serving = is_finalized_.load(std::memory_order_acquire);
+    static const char empty_metadata[] = "{}";
+    std::atomic<size_t> added{0};
+    
+    #pragma omp parallel
+    {
+        // No metadata: every filter column holds null (code 0)
+        std::vector<uint32_t> filter_codes(filter_columns_.size(), 0);
+        #pragma omp for schedule(dynamic, 256)
+        for (int64_t i = 0; i < static_cast<int64_t>(count); ++i) {
+            ScopedTimer timer(stats_.add_ns);
+            float* emb_ptr = stage_embedding(serving);
+            simdjson::error_code error = simdjson::MEMALLOC;
+            if (emb_ptr) {
+                std::memcpy(emb_ptr, embeddings + size_t(i) * dim_, dim_ * sizeof(float));
+                error = store_document(ids[i], texts[i], empty_metadata, emb_ptr, filter_codes.data(),
+                                       serving, false);
+            }
+            if (!stats_.count_add(error)) {
+                added.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return added.load();
+}
+
+simdjson::error_code VectorStore::insert(simdjson::ondemand::object& json_doc, const float* embedding,
+                                         bool replace) {
+    // After finalization, documents go to the delta segment
+    const bool serving = is_finalized_.load(std::memory_order_acquire);
     
     // Parse with error handling
     std::string_view id, text;
@@ -135,67 +325,119 @@ simdjson::error_code VectorStore::add_document(simdjson::ondemand::object& json_
     error = json_doc["text"].get_string().get(text);
     if (error) return error;
     
-    // Calculate sizes
-    size_t emb_size = dim_ * sizeof(float);
-    size_t id_size = id.size() + 1;
-    size_t text_size = text.size() + 1;
-    
-    // Allocate temporary buffer for embedding
-    std::vector<float> temp_embedding;
-    temp_embedding.reserve(dim_);
-    
     // Process metadata and embedding first
     simdjson::ondemand::object metadata;
     error = json_doc["metadata"].get_object().get(metadata);
-    if (error) return error;
+    bool have_metadata = !error;
+    if (error && !(embedding && error == simdjson::NO_SUCH_FIELD)) return error;
     
-    simdjson::ondemand::array emb_array;
-    error = metadata["embedding"].get_array().get(emb_array);
-    if (error) return error;
+    // Walk the metadata once: parse the embedding and keep every other field
+    // as raw JSON, so results never carry the embedding as text
+    thread_local std::string meta_json;
+    meta_json.assign(1, '{');
+    thread_local std::vector<uint32_t> filter_codes;
+    filter_codes.assign(filter_columns_.size(), 0);
+    bool have_embedding = false;
+    float* emb_ptr = nullptr;
     
-    // Consume the array before touching anything else  
-    size_t i = 0;
-    for (auto value_result : emb_array) {
-        simdjson::ondemand::value v;
-        error = value_result.get(v);
-        if (error) return error;
-        double val;
-        error = v.get_double().get(val);
-        if (error) return error;
+    if (embedding) {
+        // Supplied by the caller: stage a copy, nothing to parse
+        emb_ptr = stage_embedding(serving);
+        if (!emb_ptr) {
+            return simdjson::MEMALLOC;  // Allocation failed
+        }
+        std::memcpy(emb_ptr, embedding, dim_ * sizeof(float));
+        have_embedding = true;
+    }
+    
+    if (have_metadata) {
+        for (auto field_result : metadata) {
+            simdjson::ondemand::field field;
+            error = std::move(field_result).get(field);
+            if (error) return error;
+            std::string_view key = field.escaped_key();
         
-        if (i >= dim_) {
-            return simdjson::CAPACITY; // Too many embedding values
+            if (key == "embedding" && embedding) {
+                continue;  // Superseded by the supplied embedding
+            }
+            if (key == "embedding" && !have_embedding) {
+                // Embeddings are staged separately from the document payload:
+                // finalize() compacts them into the search matrix and releases the
+                // staging arena. The dimension is known, so parse straight into the
+                // slot (a rejected document leaves it unused until then).
+                emb_ptr = stage_embedding(serving);
+                if (!emb_ptr) {
+                    return simdjson::MEMALLOC;  // Allocation failed
+                }
+                error = parse_embedding(field.value(), emb_ptr, dim_);
+                if (error) return error;
+                have_embedding = true;
+                continue;
+            }
+        
+            std::string_view raw_value;
+            error = field.value().raw_json().get(raw_value);
+            if (error) return error;
+            while (!raw_value.empty() && (raw_value.back() == ' ' || raw_value.back() == '\n' ||
+                                          raw_value.back() == '\r' || raw_value.back() == '\t')) {
+                raw_value.remove_suffix(1);  // Drop whitespace before the next ',' or '}'
+            }
+            if (meta_json.size() > 1) meta_json += ',';
+            meta_json += '"';
+            meta_json.append(key.data(), key.size());
+            meta_json += "\":";
+            meta_json.append(raw_value.data(), raw_value.size());
+            
+            for (size_t f = 0; f < filter_columns_.size(); ++f) {
+                if (key == filter_columns_[f]->field) {
+                    filter_codes[f] = encode_filter_value(*filter_columns_[f], raw_value);
+                }
+            }
         }
-        temp_embedding.push_back(float(val));
-        i++;
     }
+    if (!have_embedding) {
+        return simdjson::NO_SUCH_FIELD;
+    }
+    meta_json += '}';
     
-    // Verify we got the expected number of embedding values
-    if (i != dim_) {
-        return simdjson::INCORRECT_TYPE; // Wrong embedding dimension
+    return store_document(id, text, meta_json, emb_ptr, filter_codes.data(), serving, replace);
+}
+
+float* VectorStore::stage_embedding(bool serving) {
+    // The staging arena is gone once serving: stage in scratch, and
+    // append_delta() copies the row into its block
+    if (serving) {
+        thread_local std::vector<float> delta_row;
+        delta_row.resize(dim_);
+        return delta_row.data();
+    }
+    return (float*)staging_arena_->allocate(dim_ * sizeof(float));
+}
+
+simdjson::error_code VectorStore::store_document(std::string_view id, std::string_view text,
+                                                 std::string_view raw_json, float* emb_ptr,
+                                                 const uint32_t* filter_codes, bool serving, bool replace) {
+    if (!serving) {
+        // Normalize while the row is still in this thread's cache, so finalize()
+        // only has to copy it (append_delta() normalizes its own copy)
+        kernels::normalize(emb_ptr, dim_);
     }
     
-    // Now it is safe to take the raw metadata JSON
-    std::string_view raw_json;
-    error = metadata.raw_json().get(raw_json);
-    if (error) return error;
+    size_t id_size = id.size() + 1;
+    size_t text_size = text.size() + 1;
     size_t meta_size = raw_json.size() + 1;
     
-    // Single arena allocation
-    char* base = (char*)arena_.allocate(emb_size + id_size + text_size + meta_size);
+    // Single arena allocation for the cold payload
+    char* base = (char*)arena_.allocate(id_size + text_size + meta_size, 1);
     if (!base) {
         return simdjson::MEMALLOC;  // Allocation failed
     }
     
-    // Layout: [embedding][id][text][metadata_json]
-    float* emb_ptr = (float*)base;
-    char* id_ptr = base + emb_size;
+    // Layout: [id][text][metadata_json]
+    char* id_ptr = base;
     char* text_ptr = id_ptr + id_size;
     char* meta_ptr = text_ptr + text_size;
     
-    // Copy embedding from temporary buffer
-    std::memcpy(emb_ptr, temp_embedding.data(), emb_size);
-    
     // Copy strings (adding null terminator)
     std::memcpy(id_ptr, id.data(), id.size());
     id_ptr[id.size()] = '\0';
@@ -206,139 +448,1452 @@ simdjson::error_code VectorStore::add_document(simdjson::ondemand::object& json_
     std::memcpy(meta_ptr, raw_json.data(), raw_json.size());
     meta_ptr[raw_json.size()] = '\0';
     
-    // Atomic increment for parallel loading
-    size_t idx = count_.fetch_add(1, std::memory_order_relaxed);
-    
-    // Bounds check
-    if (idx >= entries_.size()) {
-        count_.fetch_sub(1, std::memory_order_relaxed);
-        return simdjson::CAPACITY;
-    }
-    
-    // Construct entry directly - no synchronization needed
     // Use traditional initialization for C++17 compatibility
     Document doc;
     doc.id = std::string_view(id_ptr, id.size());
     doc.text = std::string_view(text_ptr, text.size());
     doc.metadata_json = std::string_view(meta_ptr, raw_json.size());
     
+    // Tokenized here, on the loading thread, so finalize() only lays out postings
+    TextIndex::DocTerms terms;
+    if (options_.text_index && !make_doc_terms(doc.text, terms)) {
+        return simdjson::MEMALLOC;
+    }
+    
+    if (serving) {
+        return append_delta(doc, emb_ptr, filter_codes, terms, replace);
+    }
+    
+    // Claim the next slot for parallel loading. Its storage is ensured before
+    // the claim is published, so a failure never has to undo one: taking it
+    // back with fetch_sub would race with the claims of other loaders.
+    size_t idx = count_.load(std::memory_order_relaxed);
+    do {
+        if (idx >= capacity_) {
+            return simdjson::CAPACITY;
+        }
+        if (!ensure_slot(idx)) {
+            return simdjson::MEMALLOC;
+        }
+    } while (!count_.compare_exchange_weak(idx, idx + 1, std::memory_order_relaxed));
+    
+    // Construct entry directly - no synchronization needed
     Entry entry;
     entry.doc = doc;
     entry.embedding = emb_ptr;
     
     entries_[idx] = entry;
+    for (size_t f = 0; f < filter_columns_.size(); ++f) {
+        filter_columns_[f]->codes[idx] = filter_codes[f];
+    }
+    if (options_.text_index) {
+        doc_terms_[idx] = terms;
+    }
     
     return simdjson::SUCCESS;
 }
 
-void VectorStore::finalize() {
+bool VectorStore::make_doc_terms(std::string_view text, TextIndex::DocTerms& terms) {
+    thread_local std::vector<uint64_t> tokens;
+    thread_local std::vector<TermCount> counts;
+    tokens.clear();
+    terms.length = static_cast<uint32_t>(std::min<size_t>(tokenize(text, tokens), UINT32_MAX));
+    count_terms(tokens, counts);
+    
+    // At least one slot, so a document without tokens is still indexed (it counts toward N)
+    auto* stored = static_cast<TermCount*>(
+        arena_.allocate(std::max<size_t>(counts.size(), 1) * sizeof(TermCount), alignof(TermCount)));
+    if (!stored) {
+        return false;
+    }
+    std::copy(counts.begin(), counts.end(), stored);
+    terms.terms = stored;
+    terms.count = static_cast<uint32_t>(counts.size());
+    return true;
+}
+
+simdjson::error_code VectorStore::index_text_terms(size_t n) {
+    if (!options_.text_index) {
+        return simdjson::SUCCESS;
+    }
+    std::atomic<bool> failed{false};
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t i = 0; i < static_cast<int64_t>(n); ++i) {
+        if (!make_doc_terms(entries_[i].doc.text, doc_terms_[i])) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    }
+    return failed.load() ? simdjson::MEMALLOC : simdjson::SUCCESS;
+}
+
+uint32_t VectorStore::encode_filter_value(FilterColumn& column, std::string_view raw) {
+    if (raw.empty() || raw.front() == '{' || raw.front() == '[' || raw == "null") {
+        return 0;
+    }
+    
+    // Same key as SearchFilter::Value: plain strings are used as they are,
+    // escaped strings and numbers are parsed as a scalar document
+    thread_local std::string key;
+    if (raw == "true" || raw == "false") {
+        key = SearchFilter::Value::bool_key(raw == "true");
+    } else if (raw.size() >= 2 && raw.front() == '"' && raw.find('\\') == std::string_view::npos) {
+        key = SearchFilter::Value::string_key(raw.substr(1, raw.size() - 2));
+    } else {
+        thread_local simdjson::ondemand::parser parser;
+        thread_local simdjson::padded_string padded;
+        if (padded.size() < raw.size()) padded = simdjson::padded_string(raw.size() * 2);
+        std::memcpy(padded.data(), raw.data(), raw.size());
+        simdjson::ondemand::document doc;
+        if (parser.iterate(padded.data(), raw.size(), padded.size() + simdjson::SIMDJSON_PADDING).get(doc)) {
+            return 0;
+        }
+        std::string_view decoded;
+        double number;
+        if (raw.front() == '"' ? doc.get_string().get(decoded) : doc.get_double().get(number)) {
+            return 0;
+        }
+        key = raw.front() == '"' ? SearchFilter::Value::string_key(decoded)
+                                 : SearchFilter::Value::number_key(number);
+    }
+    
+    // Most values repeat: look up under the shared lock, add under the exclusive one
+    {
+        std::shared_lock<std::shared_mutex> lock(column.dictionary_mutex);
+        auto it = column.dictionary.find(key);
+        if (it != column.dictionary.end()) return it->second;
+    }
+    std::unique_lock<std::shared_mutex> lock(column.dictionary_mutex);
+    auto it = column.dictionary.try_emplace(key, static_cast<uint32_t>(column.dictionary.size() + 1)).first;
+    return it->second;
+}
+
+simdjson::error_code VectorStore::index_filter_fields(size_t n) {
+    if (filter_columns_.empty()) {
+        return simdjson::SUCCESS;
+    }
+    std::atomic<int> failed{0};
+    #pragma omp parallel
+    {
+        simdjson::ondemand::parser parser;
+        simdjson::padded_string padded;
+        #pragma omp for schedule(dynamic, 1024)
+        for (int64_t i = 0; i < static_cast<int64_t>(n); ++i) {
+            std::string_view meta = entries_[i].doc.metadata_json;
+            if (padded.size() < meta.size()) padded = simdjson::padded_string(meta.size() * 2);
+            std::memcpy(padded.data(), meta.data(), meta.size());
+            
+            simdjson::ondemand::document doc;
+            simdjson::ondemand::object object;
+            if (parser.iterate(padded.data(), meta.size(), padded.size() + simdjson::SIMDJSON_PADDING).get(doc) ||
+                doc.get_object().get(object)) {
+                failed.store(simdjson::TAPE_ERROR, std::memory_order_relaxed);
+                continue;
+            }
+            for (auto field_result : object) {
+                simdjson::ondemand::field field;
+                std::string_view raw_value;
+                if (std::move(field_result).get(field) || field.value().raw_json().get(raw_value)) {
+                    failed.store(simdjson::TAPE_ERROR, std::memory_order_relaxed);
+                    break;
+                }
+                std::string_view key = field.escaped_key();
+                while (!raw_value.empty() && (raw_value.back() == ' ' || raw_value.back() == '\n' ||
+                                              raw_value.back() == '\r' || raw_value.back() == '\t')) {
+                    raw_value.remove_suffix(1);
+                }
+                for (auto& column : filter_columns_) {
+                    if (key == column->field) column->codes[i] = encode_filter_value(*column, raw_value);
+                }
+            }
+        }
+    }
+    return static_cast<simdjson::error_code>(failed.load());
+}
+
+bool VectorStore::is_filter_field(std::string_view field) const {
+    for (const auto& column : filter_columns_) {
+        if (column->field == field) return true;
+    }
+    return false;
+}
+
+VectorStore::CompiledFilter VectorStore::compile_filter(const SearchFilter& filter) const {
+    CompiledFilter compiled;
+    for (const SearchFilter::Clause& clause : filter.clauses) {
+        const FilterColumn* column = nullptr;
+        for (const auto& candidate : filter_columns_) {
+            if (candidate->field == clause.field) column = candidate.get();
+        }
+        std::vector<uint32_t> codes;
+        if (column) {
+            std::shared_lock<std::shared_mutex> lock(column->dictionary_mutex);
+            for (const SearchFilter::Value& value : clause.values) {
+                auto it = column->dictionary.find(value.key());
+                if (it != column->dictionary.end()) codes.push_back(it->second);
+            }
+        }
+        if (codes.empty()) {
+            compiled.never = true;  // Unknown field, or no document has any of the values
+        }
+        std::sort(codes.begin(), codes.end());
+        compiled.clauses.emplace_back(column, std::move(codes));
+    }
+    return compiled;
+}
+
+bool VectorStore::CompiledFilter::matches(size_t idx) const {
+    for (const auto& [column, codes] : clauses) {
+        const uint32_t code = column->codes[idx];
+        if (codes.size() == 1 ? code != codes[0] : !std::binary_search(codes.begin(), codes.end(), code)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+simdjson::error_code VectorStore::finalize(const FinalizeProgress& progress) {
     // If already finalized, do nothing
     if (is_finalized_.load(std::memory_order_acquire)) {
-        return;
+        return simdjson::SUCCESS;
     }
+    ScopedTimer timer(stats_.finalize_ns);
+    stats_.omp_threads.store(omp_get_max_threads(), std::memory_order_relaxed);
     
     // Get final count
     size_t final_count = count_.load(std::memory_order_acquire);
     
-    // Normalize all embeddings (single-threaded, no races)
-    for (size_t i = 0; i < final_count; ++i) {
-        float* emb = entries_[i].embedding;
-        if (!emb) continue;  // Skip uninitialized entries
-        
-        float sum = 0.0f;
-        #pragma omp simd reduction(+:sum)
-        for (size_t j = 0; j < dim_; ++j) {
-            sum += emb[j] * emb[j];
+    // Build into a fresh segment so a failed allocation leaves nothing half-built.
+    // Nothing else runs during finalize(), so every stage may use all cores.
+    auto segment = std::make_unique<Segment>();
+    auto error = build_segment(*segment, final_count, true, progress);
+    if (error) {
+        return error;
+    }
+    main_ = std::move(segment);
+    point_entries(*main_);
+    delta_first_ = final_count;
+    build_id_index(final_count);
+    
+    // Raw embeddings now live in the matrix
+    staging_arena_.reset();
+    // Hand back the payload arena's unused tail; serving-time adds start a fresh chunk
+    arena_.shrink_to_fit();
+    
+    // Mark as finalized - open_snapshot() is the only other place this flag is set.
+    // The OpenMP regions above have joined, and this store publishes their writes.
+    is_finalized_.store(true, std::memory_order_seq_cst);
+    
+    if (progress) {
+        progress(FinalizeStage::Done, final_count, main_->rows);
+    }
+    return simdjson::SUCCESS;
+}
+
+bool VectorStore::allocate_matrix(Segment& segment, size_t rows) const {
+    // A large matrix is 2MB-aligned and backed by huge pages, cutting TLB
+    // misses when a scan streams over it
+    const size_t bytes = rows * stride_ * sizeof(float);
+    const bool huge = options_.arena.huge_pages && bytes >= page_memory::HUGE_PAGE_SIZE;
+    if (!segment.matrix_storage.allocate(rows * stride_, huge ? page_memory::HUGE_PAGE_SIZE : 64)) {
+        return false;
+    }
+    if (huge) {
+        page_memory::advise_huge(segment.matrix_storage.data(), segment.matrix_storage.size() * sizeof(float));
+    }
+    place_shards(segment.matrix_storage.data(), stride_ * sizeof(float), rows);
+    return true;
+}
+
+std::vector<numa::Shard> VectorStore::numa_shards(size_t rows) const {
+    std::vector<numa::Shard> shards;
+    const size_t count = numa_nodes_.size();
+    for (size_t s = 0; s < count; ++s) {
+        numa::Shard shard;
+        shard.begin = s ? shards.back().end : 0;
+        shard.end = s + 1 == count ? rows :
+            std::max(shard.begin, std::min(rows, rows * (s + 1) / count / SHARD_ALIGN_ROWS * SHARD_ALIGN_ROWS));
+        shard.node = numa_nodes_[s];
+        shards.push_back(shard);
+    }
+    return shards;
+}
+
+void VectorStore::place_shards(void* base, size_t row_bytes, size_t rows) const {
+    // Only whole pages can be placed; a page straddling two shards stays
+    // with whichever thread touches it first
+    const size_t page = page_memory::page_size();
+    for (const numa::Shard& shard : numa_shards(rows)) {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(base) + shard.begin * row_bytes;
+        uintptr_t end = reinterpret_cast<uintptr_t>(base) + shard.end * row_bytes;
+        begin = page_memory::round_up(begin, page);
+        end = end / page * page;
+        if (end > begin) {
+            page_memory::prefer_node(reinterpret_cast<void*>(begin), end - begin, shard.node->id);
+        }
+    }
+}
+
+namespace {
+
+// Runs an OpenMP team (of one thread unless `parallel`) split across
+// `shards` as numa::shard_threads() assigns them. Each thread is pinned to
+// its shard's node CPUs while it works (with `pin`) and claims chunks of
+// `chunk_rows` rows of its shard alongside the shard's other threads, calling
+// visit(thread, begin, end) for each.
+template <typename Visit>
+void for_each_shard_chunk(const std::vector<numa::Shard>& shards, size_t chunk_rows, bool parallel,
+                          bool pin, Visit visit) {
+    static const std::vector<int> unpinned;
+    std::vector<std::atomic<size_t>> cursors(shards.size());
+    for (size_t s = 0; s < shards.size(); ++s) cursors[s].store(shards[s].begin, std::memory_order_relaxed);
+    
+    #pragma omp parallel if(parallel)
+    {
+        const size_t thread = omp_get_thread_num();
+        const size_t team = omp_get_num_threads();
+        for (size_t s = 0; s < shards.size(); ++s) {
+            size_t first, last;
+            numa::shard_threads(s, shards.size(), team, first, last);
+            if (thread < first || thread >= last) continue;
+            numa::ThreadPin pinned(pin ? shards[s].node->cpus : unpinned);
+            size_t begin;
+            while ((begin = cursors[s].fetch_add(chunk_rows, std::memory_order_relaxed)) < shards[s].end) {
+                visit(thread, begin, std::min(shards[s].end, begin + chunk_rows));
+            }
+        }
+    }
+}
+
+}  // namespace
+
+simdjson::error_code VectorStore::build_segment(Segment& segment, size_t n, bool parallel,
+                                                const FinalizeProgress& progress) const {
+    // Removed entries get no row: this is where their space is reclaimed
+    std::vector<uint32_t> live;
+    if (removed_count_.load(std::memory_order_acquire) == 0) {
+        live.resize(n);
+        std::iota(live.begin(), live.end(), 0u);
+    } else {
+        live.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (!is_removed(i)) live.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    const size_t rows = live.size();
+    const bool dense = rows == n;
+    
+    // One contiguous, 64-byte aligned rows x stride_ matrix: the scan then streams
+    // over memory that holds nothing but vectors
+    if (!allocate_matrix(segment, rows)) {
+        return simdjson::MEMALLOC;
+    }
+    if (options_.quantization == Quantization::PQ) {
+        if (!segment.pq.allocate(rows, dim_, options_.pq)) {
+            return simdjson::MEMALLOC;
+        }
+    } else if (options_.quantization != Quantization::None) {
+        if (!segment.quantizer.allocate(options_.quantization, rows, dim_, stride_)) {
+            return simdjson::MEMALLOC;
+        }
+        // Freshly allocated, so the codes are still owned and untouched
+        place_shards(const_cast<void*>(segment.quantizer.codes()),
+                     stride_ * ScalarQuantizer::element_size(options_.quantization), rows);
+    }
+    const bool build_index = rows >= std::max<size_t>(options_.min_index_size, 1);
+    const bool build_hnsw = build_index && options_.index == IndexType::HNSW;
+    const bool train_ivf = build_index && options_.index == IndexType::IVF;
+    if ((build_hnsw && !segment.hnsw.allocate(rows, options_.hnsw)) ||
+        (train_ivf && !segment.ivf.allocate(rows, dim_, stride_, options_.ivf)) ||
+        ((train_ivf || !dense) && !segment.row_ids_storage.allocate(rows))) {
+        return simdjson::MEMALLOC;
+    }
+    segment.dead = std::make_unique<std::atomic<uint64_t>[]>(rows / 64 + 1);
+    float* matrix = segment.matrix_storage.data();
+    
+    auto report = [&](FinalizeStage stage, size_t done) {
+        if (progress) progress(stage, done, rows);
+    };
+    
+    // Copy the (already normalized) embeddings in row blocks; each row is
+    // written by exactly one thread. Progress is reported from the calling
+    // thread only, so callbacks need no locking.
+    report(FinalizeStage::Compact, 0);
+    const size_t num_blocks = (rows + COPY_BLOCK_ROWS - 1) / COPY_BLOCK_ROWS;
+    std::atomic<size_t> copied{0};
+    auto copy_rows = [&](size_t begin, size_t end) {
+        for (size_t r = begin; r < end; ++r) {
+            float* row = matrix + r * stride_;
+            const float* emb = entries_[live[r]].embedding;
+            
+            // Zero the row padding so kernels may run over the full stride
+            std::memset(row + dim_, 0, (stride_ - dim_) * sizeof(float));
+            
+            if (!emb) {  // Uninitialized entry
+                std::memset(row, 0, dim_ * sizeof(float));
+                continue;
+            }
+            std::memcpy(row, emb, dim_ * sizeof(float));
+        }
+        size_t done = copied.fetch_add(end - begin, std::memory_order_relaxed) + (end - begin);
+        if (omp_get_thread_num() == 0 && done < rows) {
+            report(FinalizeStage::Compact, done);
+        }
+    };
+    if (!numa_nodes_.empty()) {
+        // Each shard's rows are first touched by threads on its node
+        for_each_shard_chunk(numa_shards(rows), COPY_BLOCK_ROWS, parallel, options_.numa.pin_threads,
+                             [&](size_t, size_t begin, size_t end) { copy_rows(begin, end); });
+    } else {
+        #pragma omp parallel for schedule(dynamic) if(parallel && num_blocks > 1)
+        for (int64_t b = 0; b < static_cast<int64_t>(num_blocks); ++b) {
+            const size_t begin = size_t(b) * COPY_BLOCK_ROWS;
+            copy_rows(begin, std::min(rows, begin + COPY_BLOCK_ROWS));
+        }
+    }
+    report(FinalizeStage::Compact, rows);
+    segment.matrix = matrix;
+    segment.rows = rows;
+    segment.end = n;
+    
+    // Lists become contiguous row ranges; codes and graphs are built on the final order.
+    // build_ivf() composes the list order with the live row mapping.
+    if (!dense) {
+        segment.row_ids = live.data();
+    }
+    if (train_ivf) {
+        report(FinalizeStage::Index, 0);
+        build_ivf(segment, parallel);
+        report(FinalizeStage::Index, rows);
+    } else if (!dense) {
+        std::memcpy(segment.row_ids_storage.data(), live.data(), rows * sizeof(uint32_t));
+        segment.row_ids = segment.row_ids_storage.data();
+    }
+    
+    // Compact codes for the search scan
+    if (options_.quantization != Quantization::None) {
+        report(FinalizeStage::Quantize, 0);
+        if (options_.quantization == Quantization::PQ) {
+            segment.pq.train(segment.matrix, stride_, parallel);
+        } else {
+            segment.quantizer.encode(segment.matrix, parallel);
+        }
+        report(FinalizeStage::Quantize, rows);
+    }
+    
+    // Graph construction reads the final normalized rows
+    if (build_hnsw) {
+        report(FinalizeStage::Index, 0);
+        segment.hnsw.build(segment.matrix, dim_, stride_, dot_, parallel);
+        report(FinalizeStage::Index, rows);
+    }
+    
+    // Postings are keyed by entry index, so they need no row mapping
+    if (options_.text_index) {
+        bool built = segment.text.build(n, [&](size_t idx) {
+            return is_removed(idx) ? TextIndex::DocTerms() : doc_terms_[idx];
+        }, options_.bm25, parallel);
+        if (!built) {
+            return simdjson::MEMALLOC;
+        }
+    }
+    
+    return simdjson::SUCCESS;
+}
+
+void VectorStore::build_ivf(Segment& segment, bool parallel) const {
+    // row_ids_storage is preallocated; it receives the list order first
+    const size_t n = segment.rows;
+    float* matrix = segment.matrix_storage.data();
+    uint32_t* order = segment.row_ids_storage.data();
+    segment.ivf.train(matrix, dot_, order, parallel);
+    
+    // Apply the permutation in place, one cycle at a time: row r <- row order[r]
+    std::vector<bool> placed(n, false);
+    std::vector<float> held(stride_);
+    for (size_t start = 0; start < n; ++start) {
+        if (placed[start] || order[start] == start) continue;
+        std::memcpy(held.data(), matrix + start * stride_, stride_ * sizeof(float));
+        size_t r = start;
+        while (true) {
+            placed[r] = true;
+            size_t src = order[r];
+            if (src == start) {
+                std::memcpy(matrix + r * stride_, held.data(), stride_ * sizeof(float));
+                break;
+            }
+            std::memcpy(matrix + r * stride_, matrix + src * stride_, stride_ * sizeof(float));
+            r = src;
+        }
+    }
+    
+    // Rows are now in list order: compose with any earlier row order
+    if (segment.row_ids) {
+        for (size_t r = 0; r < n; ++r) order[r] = segment.row_ids[order[r]];
+    }
+    segment.row_ids = order;
+}
+
+void VectorStore::point_entries(Segment& segment) {
+    // Entries removed before the segment was built have no row in it
+    if (removed_count_.load(std::memory_order_relaxed)) {
+        for (size_t idx = 0; idx < segment.end; ++idx) {
+            if (is_removed(idx)) entries_[idx].embedding = nullptr;
+        }
+    }
+    for (size_t r = 0; r < segment.rows; ++r) {
+        size_t idx = segment.row_ids ? segment.row_ids[r] : r;
+        entries_[idx].embedding = const_cast<float*>(segment.matrix + r * stride_);
+        if (is_removed(idx)) {  // Removed while the segment was built
+            segment.dead[r >> 6].fetch_or(uint64_t(1) << (r & 63), std::memory_order_relaxed);
+            segment.dead_rows.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void VectorStore::build_id_index(size_t n) {
+    id_index_.clear();
+    id_index_.reserve(n);
+    for (size_t idx = 0; idx < n; ++idx) {
+        if (!is_removed(idx)) id_index_[entries_[idx].doc.id] = static_cast<uint32_t>(idx);
+    }
+}
+
+void VectorStore::mark_removed(size_t idx) {
+    removed_[idx >> 6].fetch_or(uint64_t(1) << (idx & 63), std::memory_order_relaxed);
+    removed_count_.fetch_add(1, std::memory_order_relaxed);
+    
+    // Live entries below the segment end have a row in it
+    Segment& segment = *main_;
+    const float* row = entries_[idx].embedding;
+    if (idx < segment.end && row) {
+        size_t r = (row - segment.matrix) / stride_;
+        segment.dead[r >> 6].fetch_or(uint64_t(1) << (r & 63), std::memory_order_relaxed);
+        segment.dead_rows.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool VectorStore::remove(std::string_view id) {
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    // Shared: keeps main_ and the entry rows in place, searches carry on
+    std::shared_lock<std::shared_mutex> search_lock(search_mutex_);
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto it = id_index_.find(id);
+    if (it == id_index_.end()) {
+        return false;
+    }
+    mark_removed(it->second);
+    id_index_.erase(it);
+    invalidate_query_cache();
+    return true;
+}
+
+void VectorStore::invalidate_query_cache() {
+    if (query_cache_) query_cache_->invalidate();
+}
+
+size_t VectorStore::index_of(std::string_view id) const {
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return SIZE_MAX;
+    }
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    auto it = id_index_.find(id);
+    return it == id_index_.end() ? SIZE_MAX : it->second;
+}
+
+const VectorStore::Entry* VectorStore::get_by_id(std::string_view id) const {
+    size_t idx = index_of(id);
+    return idx == SIZE_MAX ? nullptr : &entries_[idx];
+}
+
+simdjson::error_code VectorStore::append_delta(const Document& doc, const float* embedding,
+                                               const uint32_t* filter_codes, const TextIndex::DocTerms& terms,
+                                               bool replace) {
+    bool start_compaction = false;
+    {
+        // Removing the old version flags its main segment row, which must not be swapped out meanwhile
+        std::shared_lock<std::shared_mutex> search_lock(search_mutex_, std::defer_lock);
+        if (replace) search_lock.lock();
+        std::lock_guard<std::mutex> lock(delta_mutex_);
+        size_t idx = count_.load(std::memory_order_relaxed);
+        if (idx >= capacity_) {
+            return simdjson::CAPACITY;
+        }
+        if (!ensure_slot(idx)) {
+            return simdjson::MEMALLOC;
         }
         
-        if (sum > 1e-10f) {  // Avoid division by zero
-            float inv_norm = 1.0f / std::sqrt(sum);
-            #pragma omp simd
-            for (size_t j = 0; j < dim_; ++j) {
-                emb[j] *= inv_norm;
+        // Rows never move once written, so searches read them without the lock
+        if (delta_blocks_.empty() || idx - delta_blocks_.back().first >= DELTA_BLOCK_ROWS) {
+            DeltaBlock block;
+            if (!block.rows.allocate(DELTA_BLOCK_ROWS * stride_)) {
+                return simdjson::MEMALLOC;
             }
+            block.first = idx;
+            delta_blocks_.push_back(std::move(block));
+        }
+        DeltaBlock& block = delta_blocks_.back();
+        float* row = block.rows.data() + (idx - block.first) * stride_;
+        std::memcpy(row, embedding, dim_ * sizeof(float));
+        std::memset(row + dim_, 0, (stride_ - dim_) * sizeof(float));
+        kernels::normalize(row, dim_);
+        
+        Entry entry;
+        entry.doc = doc;
+        entry.embedding = row;
+        entries_[idx] = entry;
+        for (size_t f = 0; f < filter_columns_.size(); ++f) {
+            filter_columns_[f]->codes[idx] = filter_codes[f];
         }
+        if (options_.text_index) {
+            doc_terms_[idx] = terms;
+        }
+        
+        // Publish: searches cover the entry from here on
+        count_.store(idx + 1, std::memory_order_release);
+        
+        // The new version is visible before the old one disappears
+        auto [it, inserted] = id_index_.try_emplace(doc.id, static_cast<uint32_t>(idx));
+        if (!inserted) {
+            if (replace) mark_removed(it->second);
+            it->second = static_cast<uint32_t>(idx);
+        }
+        invalidate_query_cache();
+        
+        start_compaction = options_.delta_compact_rows &&
+                           idx + 1 - delta_first_ >= std::max<double>(options_.delta_compact_rows,
+                                                                      options_.delta_compact_fraction * delta_first_);
     }
     
-    // Ensure all threads see the normalized data
-    #pragma omp barrier
+    // Merge in the background; inserts and searches carry on meanwhile
+    if (start_compaction && !compacting_.exchange(true, std::memory_order_acq_rel)) {
+        if (compact_thread_.joinable()) {
+            compact_thread_.join();  // Previous run has finished: it cleared the flag
+        }
+        compact_thread_ = std::thread([this]() {
+            compact();
+            compacting_.store(false, std::memory_order_release);
+        });
+    }
+    return simdjson::SUCCESS;
+}
+
+simdjson::error_code VectorStore::compact() {
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return simdjson::INCORRECT_TYPE;
+    }
+    std::lock_guard<std::mutex> compact_lock(compact_mutex_);
     
-    // Mark as finalized - this is the ONLY place this flag is set
-    is_finalized_.store(true, std::memory_order_seq_cst);
+    // Entries published so far; later inserts stay in the delta
+    const size_t n = count_.load(std::memory_order_acquire);
+    if (n == main_->end && main_->dead_rows.load(std::memory_order_relaxed) == 0) {
+        return simdjson::SUCCESS;
+    }
+    
+    // Only compact() replaces main_ once serving, so the rows read here stay
+    // valid while the new segment is built
+    auto segment = std::make_unique<Segment>();
+    // Runs beside live searches (often on the background thread), which keep
+    // the executor's OpenMP team to themselves: every build stage stays on
+    // this thread
+    auto error = build_segment(*segment, n, false);
+    if (error) {
+        return error;
+    }
+    
+    // Searches wait only for the swap and the entry repointing
+    {
+        std::unique_lock<std::shared_mutex> lock(search_mutex_);
+        main_.swap(segment);
+        point_entries(*main_);
+        invalidate_query_cache();  // Indexes were rebuilt: approximate results may change
+    }
+    
+    // Release blocks whose rows all live in the new matrix
+    {
+        std::lock_guard<std::mutex> lock(delta_mutex_);
+        delta_first_ = n;
+        delta_blocks_.erase(std::remove_if(delta_blocks_.begin(), delta_blocks_.end(),
+                                           [n](const DeltaBlock& block) {
+                                               return block.first + DELTA_BLOCK_ROWS <= n;
+                                           }),
+                            delta_blocks_.end());
+    }
+    
+    return simdjson::SUCCESS;  // The old segment is freed outside both locks
 }
 
+size_t VectorStore::removed_size() const {
+    return removed_count_.load(std::memory_order_relaxed);
+}
+
+size_t VectorStore::delta_size() const {
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(delta_mutex_);
+    return count_.load(std::memory_order_relaxed) - delta_first_;
+}
+
+
 void VectorStore::normalize_all() {
     finalize();
 }
 
+namespace {
+
+// Contiguous run of matrix rows to score
+struct RowRange {
+    size_t begin;
+    size_t end;
+};
+
+// Rows per unit of parallel work
+constexpr size_t SCAN_CHUNK_ROWS = 1024;
+
+// Query bytes kept hot per pass of search_batch() (about half a typical L2)
+constexpr size_t BATCH_QUERY_BYTES = 256 * 1024;
+
+// Calls visit(i) for each i in [begin, end) whose bit in `dead` (indexable
+// atomic words) is clear. The bitmap is read one 64-bit word per 64 rows, so
+// rows without removals cost a single test per word, and a word with every
+// bit set (e.g. no row matching a filter) is skipped whole.
+template <typename Words, typename Visit>
+void for_each_live(size_t begin, size_t end, const Words& dead, Visit visit) {
+    size_t i = begin;
+    while (i < end) {
+        const size_t word_end = std::min(end, (i | 63) + 1);
+        const uint64_t bits = dead[i >> 6].load(std::memory_order_relaxed);
+        if (!bits) {
+            for (; i < word_end; ++i) visit(i);
+        } else if (bits == ~uint64_t(0)) {
+            i = word_end;
+        } else {
+            for (; i < word_end; ++i) {
+                if (!((bits >> (i & 63)) & 1)) visit(i);
+            }
+        }
+    }
+}
+
+// Rows scored per kernels::select_above() call
+constexpr size_t SCORE_BLOCK_ROWS = 256;
+
+// Top-k selection for scans, keyed by 32-bit row numbers (the store holds at
+// most UINT32_MAX entries). Candidates above the current threshold are
+// appended to a buffer; once it holds 2k of them, nth_element() cuts it back
+// to the best k and the k-th best score becomes the new threshold. After the
+// first few blocks almost every score fails the threshold compare, so the
+// per-row cost is a vector compare rather than a heap update. The threshold
+// starts just under `min_score`, so lower scores are never buffered; with k
+// as large as the store this collects every hit without ever cutting.
+class TopKSelect {
+public:
+    explicit TopKSelect(size_t k, float min_score = -std::numeric_limits<float>::infinity())
+        : k_(k), capacity_(k + std::max(k, SCORE_BLOCK_ROWS)),
+          threshold_(k ? std::nextafter(min_score, -std::numeric_limits<float>::infinity())
+                       : std::numeric_limits<float>::infinity()) {}
+    
+    void push(float score, uint32_t row) {
+        if (score > threshold_) {
+            buffer_.emplace_back(score, row);
+            if (buffer_.size() >= capacity_) shrink();
+        }
+    }
+    
+    // Offers scores[j] for rows[j], j < n <= SCORE_BLOCK_ROWS
+    void push_block(const float* scores, const uint32_t* rows, size_t n) {
+        uint32_t survivors[SCORE_BLOCK_ROWS];
+        const size_t count = kernels::select_above(scores, n, threshold_, survivors);
+        for (size_t j = 0; j < count; ++j) {
+            buffer_.emplace_back(scores[survivors[j]], rows[survivors[j]]);
+        }
+        if (buffer_.size() >= capacity_) shrink();
+    }
+    
+    void merge(const TopKSelect& other) {
+        for (const auto& [score, row] : other.buffer_) push(score, row);
+    }
+    
+    // The best k candidates, unsorted
+    std::vector<std::pair<float, size_t>> take() {
+        if (buffer_.size() > k_) shrink();
+        return std::vector<std::pair<float, size_t>>(buffer_.begin(), buffer_.end());
+    }
+    
+private:
+    void shrink() {
+        std::nth_element(buffer_.begin(), buffer_.begin() + (k_ - 1), buffer_.end(),
+                         [](const auto& a, const auto& b) { return a.first > b.first; });
+        buffer_.resize(k_);
+        threshold_ = buffer_[k_ - 1].first;
+    }
+    
+    size_t k_;
+    size_t capacity_;
+    float threshold_;
+    std::vector<std::pair<float, uint32_t>> buffer_;
+};
+
+// Scores the live rows of [begin, end) into `top`, a block of rows at a time
+template <typename ScoreFn>
+void select_live(TopKSelect& top, size_t begin, size_t end, const std::atomic<uint64_t>* dead, ScoreFn score) {
+    float scores[SCORE_BLOCK_ROWS];
+    uint32_t rows[SCORE_BLOCK_ROWS];
+    for (size_t block = begin; block < end; block += SCORE_BLOCK_ROWS) {
+        const size_t block_end = std::min(end, block + SCORE_BLOCK_ROWS);
+        size_t count = 0;
+        if constexpr (std::is_invocable_v<ScoreFn&, size_t, size_t, float*>) {
+            // Block scorers (PQ fast-scan) score the whole run, then the live rows are kept
+            for_each_live(block, block_end, dead, [&](size_t i) {
+                rows[count++] = static_cast<uint32_t>(i);
+            });
+            if (count == 0) continue;
+            float run[SCORE_BLOCK_ROWS];
+            score(block, block_end, run);
+            for (size_t c = 0; c < count; ++c) scores[c] = run[rows[c] - block];
+        } else {
+            for_each_live(block, block_end, dead, [&](size_t i) {
+                rows[count] = static_cast<uint32_t>(i);
+                scores[count++] = score(i);
+            });
+        }
+        top.push_block(scores, rows, count);
+    }
+}
+
+// Merges parts[t + step] into parts[t] in log2(parts) rounds, leaving the
+// result in parts[0]. Called inside a parallel region, the team shares each
+// round (the implicit barrier orders the rounds); outside one it runs serially.
+void merge_tree(std::vector<TopKSelect>& parts) {
+    for (size_t step = 1; step < parts.size(); step *= 2) {
+        const int64_t pairs = static_cast<int64_t>((parts.size() - step + 2 * step - 1) / (2 * step));
+        #pragma omp for schedule(static)
+        for (int64_t p = 0; p < pairs; ++p) {
+            parts[p * 2 * step].merge(parts[p * 2 * step + step]);
+        }
+    }
+}
+
+// Top-k over the live rows of `ranges` on the calling thread. Returns the heap, unsorted.
+template <typename ScoreFn>
+std::vector<std::pair<float, size_t>> sequential_top_k(const std::vector<RowRange>& ranges, size_t k,
+                                                       float min_score, const std::atomic<uint64_t>* dead,
+                                                       ScoreFn score) {
+    TopKSelect top(k, min_score);
+    for (const RowRange& range : ranges) {
+        select_live(top, range.begin, range.end, dead, score);
+    }
+    return top.take();
+}
+
+// Parallel top-k over the rows of `ranges` with per-thread selections merged
+// by the team at the end. Ranges are split into fixed-size chunks, so one
+// large range (flat scan) and many small ones (IVF lists) balance the same way.
+// Returns the merged candidates, unsorted.
+template <typename ScoreFn>
+std::vector<std::pair<float, size_t>> parallel_top_k(const std::vector<RowRange>& ranges, size_t k,
+                                                     float min_score, const std::atomic<uint64_t>* dead,
+                                                     ScoreFn score) {
+    std::vector<RowRange> chunks;
+    for (const RowRange& range : ranges) {
+        for (size_t begin = range.begin; begin < range.end; begin += SCAN_CHUNK_ROWS) {
+            chunks.push_back({begin, std::min(range.end, begin + SCAN_CHUNK_ROWS)});
+        }
+    }
+    
+    // Always use per-thread selections to avoid any shared memory races
+    const int num_threads = omp_get_max_threads();
+    std::vector<TopKSelect> thread_tops(num_threads, TopKSelect(k, min_score));
+    
+    #pragma omp parallel
+    {
+        TopKSelect& local_top = thread_tops[omp_get_thread_num()];
+        
+        #pragma omp for schedule(dynamic)  // default barrier kept - ensures all threads finish before merge
+        for (int c = 0; c < static_cast<int>(chunks.size()); ++c) {
+            select_live(local_top, chunks[c].begin, chunks[c].end, dead, score);
+        }
+        
+        merge_tree(thread_tops);
+    }
+    
+    return thread_tops[0].take();
+}
+
+// parallel_top_k() over NUMA shards: each shard is scanned by its own share
+// of the team (see for_each_shard_chunk()), and the per-thread selections of
+// all shards are merged at the end. Returns the merged candidates, unsorted.
+template <typename ScoreFn>
+std::vector<std::pair<float, size_t>> sharded_top_k(const std::vector<numa::Shard>& shards, size_t k,
+                                                    float min_score, bool pin,
+                                                    const std::atomic<uint64_t>* dead, ScoreFn score) {
+    std::vector<TopKSelect> thread_tops(omp_get_max_threads(), TopKSelect(k, min_score));
+    
+    for_each_shard_chunk(shards, SCAN_CHUNK_ROWS, true, pin, [&](size_t thread, size_t begin, size_t end) {
+        select_live(thread_tops[thread], begin, end, dead, score);
+    });
+    
+    #pragma omp parallel
+    merge_tree(thread_tops);
+    return thread_tops[0].take();
+}
+
+// Counts in-flight searches for the executor's strategy choice
+struct ActiveSearch {
+    std::atomic<size_t>& count;
+    explicit ActiveSearch(std::atomic<size_t>& c) : count(c) { count.fetch_add(1, std::memory_order_relaxed); }
+    ~ActiveSearch() { count.fetch_sub(1, std::memory_order_relaxed); }
+};
+
+void sort_by_score(std::vector<std::pair<float, size_t>>& results) {
+    std::sort(results.begin(), results.end(), 
+              [](const auto& a, const auto& b) { return a.first > b.first; });
+}
+
+// The search knobs that can change results, as bytes for a QueryCache key
+// (mode only picks the threads, so it is left out)
+std::string cache_params(size_t k, const SearchOptions& search_options, bool range) {
+    std::string params;
+    auto append = [&](const auto& value) {
+        params.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    append(k);
+    append(search_options.ef);
+    append(search_options.nprobe);
+    append(search_options.min_score);
+    params.push_back(static_cast<char>(search_options.exact | (range << 1)));
+    for (const SearchFilter::Clause& clause : search_options.filter.clauses) {
+        append(clause.field.size());
+        params += clause.field;
+        append(clause.values.size());
+        for (const SearchFilter::Value& value : clause.values) {
+            append(value.key().size());
+            params += value.key();
+        }
+    }
+    return params;
+}
+
+// Adds `more` to `results` and keeps the best k, sorted
+void merge_results(std::vector<std::pair<float, size_t>>& results,
+                   const std::vector<std::pair<float, size_t>>& more, size_t k) {
+    results.insert(results.end(), more.begin(), more.end());
+    sort_by_score(results);
+    if (results.size() > k) results.resize(k);
+}
+
+}  // namespace
+
+std::vector<std::pair<float, size_t>>
+VectorStore::delta_top_k(const float* query, size_t k, size_t begin, size_t end,
+                         const CompiledFilter* filter, float min_score) const {
+    TopKSelect top(k, min_score);
+    StatsCounters::add(stats_.rows_scanned, end - begin);
+    for_each_live(begin, end, removed_, [&](size_t idx) {
+        if (filter && !filter->matches(idx)) return;
+        top.push(dot_(entries_[idx].embedding, query, dim_), static_cast<uint32_t>(idx));
+    });
+    return top.take();
+}
+
+bool VectorStore::acquire_parallel_scan(size_t scan_rows, SearchMode mode) const {
+    // Executor: intra-query parallelism only pays off for large scans, and
+    // only while no other search competes for the cores. Concurrent queries
+    // each scan on their own thread instead of queueing for one team.
+    bool parallel = false;
+    switch (mode) {
+        case SearchMode::Sequential:
+            break;
+        case SearchMode::Parallel:
+            parallel = true;
+            break;
+        case SearchMode::Auto:
+            parallel = scan_rows >= options_.parallel_scan_min_rows &&
+                       omp_get_max_threads() > 1 &&
+                       active_searches_.load(std::memory_order_relaxed) == 1;
+            break;
+    }
+    if (parallel && parallel_scan_busy_.exchange(true, std::memory_order_acquire)) {
+        parallel = false;  // Another team is running: don't oversubscribe
+    }
+    return parallel;
+}
+
+void VectorStore::release_parallel_scan() const {
+    parallel_scan_busy_.store(false, std::memory_order_release);
+}
+
 std::vector<std::pair<float, size_t>> 
-VectorStore::search(const float* query, size_t k) const {
-    // Exclusive lock: prevent overlapping OpenMP teams
-    // Since each search uses all threads via OpenMP, concurrent searches provide no benefit
-    std::unique_lock<std::shared_mutex> lock(search_mutex_);
+VectorStore::search(const float* query, size_t k, const SearchOptions& search_options) const {
+    return cached_search(query, k, search_options, false);
+}
+
+std::vector<std::pair<float, size_t>>
+VectorStore::search_range(const float* query, float min_score, size_t max_results,
+                          const SearchOptions& search_options) const {
+    SearchOptions range_options = search_options;
+    range_options.min_score = min_score;
+    return cached_search(query, max_results, range_options, true);
+}
+
+std::vector<std::pair<float, size_t>>
+VectorStore::cached_search(const float* query, size_t k, const SearchOptions& search_options, bool range) const {
+    SearchTimer timer(stats_);
+    // Nothing is cached before finalize(), so no entry predates the documents it covers
+    if (!query_cache_ || !is_finalized_.load(std::memory_order_acquire)) {
+        return search_rows(query, k, search_options, range);
+    }
+    
+    QueryCache::Key key = QueryCache::make_key(query, dim_, cache_params(k, search_options, range));
+    std::vector<std::pair<float, size_t>> result;
+    if (query_cache_->lookup(key, result)) {
+        StatsCounters::add(stats_.cache_hits, 1);
+        return result;
+    }
+    StatsCounters::add(stats_.cache_misses, 1);
+    
+    // Read before the search: a change made meanwhile leaves the entry stale
+    const uint64_t generation = query_cache_->generation();
+    result = search_rows(query, k, search_options, range);
+    query_cache_->insert(std::move(key), generation, result);
+    return result;
+}
+
+std::vector<std::pair<float, size_t>>
+VectorStore::search_rows(const float* query, size_t k, const SearchOptions& search_options, bool range) const {
+    // Served segments are immutable, so searches only exclude compact()'s swap
+    std::shared_lock<std::shared_mutex> lock = lock_for_search();
+    ActiveSearch active(active_searches_);
 
     // Search can ONLY run if finalized
     if (!is_finalized_.load(std::memory_order_acquire)) {
         return {};
     }
     
-    size_t n = count_.load(std::memory_order_acquire);
-    if (n == 0 || k == 0) return {};
+    // Main segment rows [0, n) serve entries [0, segment.end); later entries
+    // are in the delta segment
+    const Segment& segment = *main_;
+    const size_t n = segment.rows;
+    const std::atomic<uint64_t>* dead = segment.dead.get();
+    const size_t total = count_.load(std::memory_order_acquire);
+    if (total == 0 || (k == 0 && !range)) return {};
     
-    k = std::min(k, n);  // Ensure k doesn't exceed count
+    // Ensure k doesn't exceed count; an uncapped range search may return everything
+    k = k ? std::min(k, total) : total;
+    const float min_score = search_options.min_score;
     
+    // Metadata filter: resolved to codes once, then turned into a row bitmap of
+    // rows to skip (removed or not matching), so scans drop whole 64-row words
+    const bool filtered = !search_options.filter.clauses.empty();
+    CompiledFilter filter;
+    if (filtered) {
+        filter = compile_filter(search_options.filter);
+        if (filter.never) return {};
+    }
+    std::unique_ptr<std::atomic<uint64_t>[]> skip;
+    size_t matches = 0;
+    auto mark_skipped = [&](const std::vector<RowRange>& ranges) {
+        skip = std::make_unique<std::atomic<uint64_t>[]>(n / 64 + 1);
+        for (const RowRange& range : ranges) {
+            for (size_t i = range.begin; i < range.end;) {
+                const size_t word_end = std::min(range.end, (i | 63) + 1);
+                uint64_t bits = dead[i >> 6].load(std::memory_order_relaxed);
+                for (; i < word_end; ++i) {
+                    const uint64_t bit = uint64_t(1) << (i & 63);
+                    if (bits & bit) continue;
+                    if (filter.matches(segment.row_ids ? segment.row_ids[i] : i)) {
+                        ++matches;
+                    } else {
+                        bits |= bit;
+                    }
+                }
+                skip[(word_end - 1) >> 6].fetch_or(bits, std::memory_order_relaxed);
+            }
+        }
+    };
     
-    // Always use per-thread heaps to avoid any shared memory races
-    const int num_threads = omp_get_max_threads();
-    std::vector<TopK> thread_heaps;
-    thread_heaps.reserve(num_threads);
-    for (int i = 0; i < num_threads; ++i) {
-        thread_heaps.emplace_back(k);  // in-place construction, no copies
+    std::vector<std::pair<float, size_t>> result;
+    
+    const size_t ef = search_options.ef ? search_options.ef : options_.hnsw.ef_search;
+    bool use_graph = !range && !segment.hnsw.empty() && !search_options.exact;
+    if (use_graph && filtered) {
+        // A walk that may only return matching rows visits about
+        // ef * 2M / selectivity nodes; past that, scan the matching rows instead
+        mark_skipped({{0, n}});
+        use_graph = matches * matches > n * std::max(ef, k) * 2 * segment.hnsw.M();
     }
-
-     std::vector<std::pair<float,std::size_t>> result;  
     
-    #pragma omp parallel
-    {
-        const int tid = omp_get_thread_num();
-        TopK& local_heap = thread_heaps[tid];
+    if (use_graph) {
+        StatsCounters::add(stats_.graph_searches, 1);
+    }
+    if (use_graph) {
+        // Graph search is single-threaded and returns exact float scores, already sorted.
+        // Removed rows stay linked until compact(), and filtered-out rows are
+        // never unlinked: both are walked through but never returned.
+        result = segment.hnsw.search(query, k, ef, filtered ? skip.get() : dead);
+    } else {
+        // Rows to scan: everything, or the probed inverted lists
+        std::vector<RowRange> ranges;
+        const bool list_scan = !segment.ivf.empty() && !search_options.exact;
+        if (list_scan) {
+            size_t nprobe = search_options.nprobe ? search_options.nprobe : options_.ivf.nprobe;
+            for (uint32_t list : segment.ivf.probe(query, nprobe)) {
+                ranges.push_back({segment.ivf.list_begin(list), segment.ivf.list_end(list)});
+            }
+        } else {
+            ranges.push_back({0, n});
+        }
+        if (filtered && !skip) {
+            mark_skipped(ranges);
+        }
+        const std::atomic<uint64_t>* rows_skipped = filtered ? skip.get() : dead;
+        
+        size_t scan_rows = 0;
+        for (const RowRange& range : ranges) scan_rows += range.end - range.begin;
+        const bool parallel = acquire_parallel_scan(filtered ? matches : scan_rows, search_options.mode);
+        StatsCounters::add(stats_.rows_scanned, filtered ? matches : scan_rows);
+        if (parallel) {
+            StatsCounters::add(stats_.parallel_scans, 1);
+            stats_.omp_threads.store(omp_get_max_threads(), std::memory_order_relaxed);
+        }
         
-        #pragma omp for  // default barrier kept - ensures all threads finish before merge
-        for (int i = 0; i < static_cast<int>(n); ++i) {
-            float score = 0.0f;
-            const float* emb = entries_[i].embedding;
+        // A full scan of a NUMA-sharded matrix keeps each thread on its shard's node
+        const std::vector<numa::Shard> shards = parallel && !list_scan ? numa_shards(n) : std::vector<numa::Shard>();
+        auto top_k = [&](size_t count, float floor, auto score) {
+            if (!shards.empty()) {
+                return sharded_top_k(shards, count, floor, options_.numa.pin_threads, rows_skipped, score);
+            }
+            return parallel ? parallel_top_k(ranges, count, floor, rows_skipped, score)
+                            : sequential_top_k(ranges, count, floor, rows_skipped, score);
+        };
+        
+        if (range || (segment.quantizer.type() == Quantization::None && segment.pq.empty())) {
+            result = top_k(k, min_score, [&](size_t i) {
+                return dot_(segment.matrix + i * stride_, query, dim_);
+            });
+        } else {
+            size_t oversample = options_.rerank_oversample;
+            size_t candidates = oversample ? std::min(n, k * oversample) : k;
+            // Approximate scores can fall under min_score where exact ones
+            // don't, so only prune by it when they are returned as they are
+            const float floor = oversample ? -std::numeric_limits<float>::infinity() : min_score;
             
-            #pragma omp simd reduction(+:score)
-            for (size_t j = 0; j < dim_; ++j) {
-                score += emb[j] * query[j];
+            // Approximate scan over the compact codes
+            if (!segment.pq.empty()) {
+                ProductQuantizer::Table table;
+                segment.pq.prepare_query(query, table);
+                result = top_k(candidates, floor, [&](size_t begin, size_t end, float* out) {
+                    segment.pq.score_rows(table, begin, end, out);
+                });
+            } else {
+                std::vector<float> prepared(dim_);
+                segment.quantizer.prepare_query(query, prepared.data());
+                result = top_k(candidates, floor, [&](size_t i) {
+                    return segment.quantizer.score(prepared.data(), i);
+                });
             }
             
-            local_heap.push(score, i);
+            // Exact re-rank of the candidates against the float rows
+            if (oversample) {
+                TopK exact(k);
+                for (const auto& candidate : result) {
+                    size_t idx = candidate.second;
+                    exact.push(dot_(segment.matrix + idx * stride_, query, dim_), idx);
+                }
+                result = std::move(exact.heap);
+            }
+        }
+        
+        if (parallel) {
+            release_parallel_scan();
         }
+        
+        sort_by_score(result);
+    }
+    
+    // Matrix rows may have been reordered into IVF lists
+    if (segment.row_ids) {
+        for (auto& r : result) r.second = segment.row_ids[r.second];
+    }
+    
+    // Merge in documents added since the last compaction
+    if (total > segment.end) {
+        merge_results(result, delta_top_k(query, k, segment.end, total, filtered ? &filter : nullptr, min_score), k);
+    }
+    
+    // Graph walks and exact re-ranks are not pruned by min_score
+    result.erase(std::find_if(result.begin(), result.end(), [min_score](const auto& r) {
+        return r.first < min_score;
+    }), result.end());
+    return result;
+}
 
-        #pragma omp barrier
-        #pragma omp single
+std::vector<std::vector<std::pair<float, size_t>>>
+VectorStore::search_batch(const float* queries, size_t nq, size_t k,
+                          const SearchOptions& search_options) const {
+    std::vector<std::vector<std::pair<float, size_t>>> results(nq);
+    
+    std::shared_lock<std::shared_mutex> lock = lock_for_search();
+    if (!is_finalized_.load(std::memory_order_acquire)) {
+        return results;
+    }
+    const Segment& segment = *main_;
+    
+    // Only the exact float scan benefits from sharing rows between queries;
+    // graph, list, quantized and filtered searches run query by query
+    const bool flat_scan = search_options.filter.clauses.empty() &&
+                           (search_options.exact ||
+                            (segment.hnsw.empty() && segment.ivf.empty() &&
+                             segment.quantizer.type() == Quantization::None && segment.pq.empty()));
+    if (!flat_scan) {
+        lock.unlock();  // search() takes its own
+        for (size_t q = 0; q < nq; ++q) {
+            results[q] = search(queries + q * dim_, k, search_options);
+        }
+        return results;
+    }
+    
+    ActiveSearch active(active_searches_);
+    SearchTimer timer(stats_);  // One sample for the whole batch
+    
+    // Main segment rows [0, n) serve entries [0, segment.end); later entries
+    // are in the delta segment
+    const size_t n = segment.rows;
+    const std::atomic<uint64_t>* dead = segment.dead.get();
+    const size_t total = count_.load(std::memory_order_acquire);
+    if (total == 0 || k == 0 || nq == 0) return results;
+    k = std::min(k, total);
+    
+    // Copy queries into padded rows so every kernel call sees aligned, stride-spaced data
+    AlignedArray<float> padded;
+    if (!padded.allocate(nq * stride_)) return results;
+    for (size_t q = 0; q < nq; ++q) {
+        std::memcpy(padded.data() + q * stride_, queries + q * dim_, dim_ * sizeof(float));
+        std::memset(padded.data() + q * stride_ + dim_, 0, (stride_ - dim_) * sizeof(float));
+    }
+    
+    // Blocked scan: each database row is loaded once and scored against a
+    // group of queries that stays resident in L2, instead of streaming the
+    // whole matrix from DRAM once per query
+    const size_t query_group = std::max<size_t>(1, BATCH_QUERY_BYTES / (stride_ * sizeof(float)));
+    const size_t num_chunks = (n + SCAN_CHUNK_ROWS - 1) / SCAN_CHUNK_ROWS;
+    const kernels::Dot4Fn dot4 = kernels::dot4_for(kernels::active_isa());
+    const bool parallel = acquire_parallel_scan(n * nq, search_options.mode);
+    const int num_threads = parallel ? omp_get_max_threads() : 1;
+    StatsCounters::add(stats_.rows_scanned, n * nq);
+    if (parallel) {
+        StatsCounters::add(stats_.parallel_scans, 1);
+        stats_.omp_threads.store(num_threads, std::memory_order_relaxed);
+    }
+    
+    // One selection per (thread, query)
+    std::vector<std::vector<TopKSelect>> thread_tops(
+        num_threads, std::vector<TopKSelect>(nq, TopKSelect(k, search_options.min_score)));
+    
+    auto scan_chunk = [&](std::vector<TopKSelect>& tops, size_t begin, size_t end) {
+        for (size_t q0 = 0; q0 < nq; q0 += query_group) {
+            size_t q1 = std::min(nq, q0 + query_group);
+            for_each_live(begin, end, dead, [&](size_t i) {
+                const float* row = segment.matrix + i * stride_;
+                size_t q = q0;
+                for (; q + 4 <= q1; q += 4) {
+                    float scores[4];
+                    dot4(row, padded.data() + q * stride_, stride_, dim_, scores);
+                    for (size_t j = 0; j < 4; ++j) tops[q + j].push(scores[j], static_cast<uint32_t>(i));
+                }
+                for (; q < q1; ++q) {
+                    tops[q].push(dot_(row, padded.data() + q * stride_, dim_), static_cast<uint32_t>(i));
+                }
+            });
+        }
+    };
+    
+    if (parallel && !numa_nodes_.empty()) {
+        // Each NUMA shard is scanned by threads on its own node
+        for_each_shard_chunk(numa_shards(n), SCAN_CHUNK_ROWS, true, options_.numa.pin_threads,
+                             [&](size_t thread, size_t begin, size_t end) {
+                                 scan_chunk(thread_tops[thread], begin, end);
+                             });
+    } else {
+        #pragma omp parallel num_threads(num_threads) if(parallel)
         {
-            TopK final_heap(k);
-            for (auto& th : thread_heaps) final_heap.merge(th);
-            result = std::move(final_heap.heap);
+            std::vector<TopKSelect>& tops = thread_tops[omp_get_thread_num()];
+            
+            #pragma omp for schedule(dynamic)
+            for (int c = 0; c < static_cast<int>(num_chunks); ++c) {
+                size_t begin = size_t(c) * SCAN_CHUNK_ROWS;
+                scan_chunk(tops, begin, std::min(n, begin + SCAN_CHUNK_ROWS));
+            }
         }
     }
     
-    std::sort(result.begin(), result.end(), 
-              [](const auto& a, const auto& b) { return a.first > b.first; });
+    // Queries are merged independently, so the team splits them rather than
+    // tree-merging each one
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads) if(parallel && nq > 1)
+    for (int64_t qi = 0; qi < static_cast<int64_t>(nq); ++qi) {
+        const size_t q = static_cast<size_t>(qi);
+        for (int t = 1; t < num_threads; ++t) thread_tops[0][q].merge(thread_tops[t][q]);
+        results[q] = thread_tops[0][q].take();
+        sort_by_score(results[q]);
+        if (segment.row_ids) {
+            for (auto& r : results[q]) r.second = segment.row_ids[r.second];
+        }
+        if (total > segment.end) {
+            merge_results(results[q], delta_top_k(padded.data() + q * stride_, k, segment.end, total, nullptr,
+                                                  search_options.min_score), k);
+        }
+    }
+    
+    if (parallel) {
+        release_parallel_scan();
+    }
+    return results;
+}
+
+std::vector<std::pair<float, size_t>>
+VectorStore::text_search(std::string_view text, size_t k, const SearchOptions& search_options) const {
+    SearchTimer timer(stats_);
+    std::shared_lock<std::shared_mutex> lock = lock_for_search();
+    ActiveSearch active(active_searches_);
+    if (!options_.text_index || !is_finalized_.load(std::memory_order_acquire) || k == 0) {
+        return {};
+    }
+    const Segment& segment = *main_;
+    const size_t total = count_.load(std::memory_order_acquire);
+    
+    const bool filtered = !search_options.filter.clauses.empty();
+    CompiledFilter filter;
+    if (filtered) {
+        filter = compile_filter(search_options.filter);
+        if (filter.never) return {};
+    }
     
+    // Distinct query terms; repeating a word does not weigh it more
+    std::vector<uint64_t> terms;
+    tokenize(text, terms);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    if (terms.empty()) return {};
+    
+    TopK heap(k);
+    heap.heap = segment.text.search(terms, k, [&](uint32_t idx) {
+        return !is_removed(idx) && (!filtered || filter.matches(idx));
+    });
+    std::make_heap(heap.heap.begin(), heap.heap.end(), TopK::cmp);
+    
+    // Documents added since the last compaction: scored against the main
+    // index's statistics, by looking each query term up in their sorted terms
+    for_each_live(segment.end, total, removed_, [&](size_t idx) {
+        if (filtered && !filter.matches(idx)) return;
+        const TextIndex::DocTerms& doc = doc_terms_[idx];
+        float score = 0;
+        for (uint64_t term : terms) {
+            const TermCount* end = doc.terms + doc.count;
+            const TermCount* it = std::lower_bound(doc.terms, end, term, [](const TermCount& t, uint64_t h) {
+                return t.term < h;
+            });
+            if (it != end && it->term == term) score += segment.text.term_score(term, it->count, doc.length);
+        }
+        if (score > 0) heap.push(score, idx);
+    });
+    
+    std::vector<std::pair<float, size_t>> result = std::move(heap.heap);
+    sort_by_score(result);
     return result;
 }
 
+std::vector<std::pair<float, size_t>>
+VectorStore::hybrid_search(const float* query, std::string_view text, size_t k, float alpha,
+                           const SearchOptions& search_options) const {
+    if (k == 0) return {};
+    
+    // Reciprocal rank fusion: ranks are comparable where BM25 and cosine scores are not
+    constexpr float RRF_K = 60.0f;
+    const size_t depth = std::max<size_t>(4 * k, 100);
+    alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+    
+    std::unordered_map<size_t, float> fused;
+    auto add_ranks = [&](const std::vector<std::pair<float, size_t>>& ranked, float weight) {
+        if (weight == 0) return;
+        for (size_t rank = 0; rank < ranked.size(); ++rank) {
+            fused[ranked[rank].second] += weight / (RRF_K + float(rank + 1));
+        }
+    };
+    add_ranks(search(query, depth, search_options), alpha);
+    add_ranks(text_search(text, depth, search_options), 1.0f - alpha);
+    
+    TopK heap(k);
+    for (const auto& [idx, score] : fused) heap.push(score, idx);
+    std::vector<std::pair<float, size_t>> result = std::move(heap.heap);
+    sort_by_score(result);
+    return result;
+}
+
+std::shared_lock<std::shared_mutex> VectorStore::lock_for_search() const {
+    std::shared_lock<std::shared_mutex> lock(search_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        const uint64_t start = stats_now_ns();
+        lock.lock();
+        StatsCounters::add(stats_.lock_waits, 1);
+        StatsCounters::add(stats_.lock_wait_ns, stats_now_ns() - start);
+    }
+    return lock;
+}
+
+StoreStats VectorStore::stats() const {
+    StoreStats out;
+    if constexpr (STATS_ENABLED) {
+        stats_.copy_to(out);
+        out.arena_reserved_bytes = arena_.reserved_bytes();
+        out.arena_used_bytes = arena_.used_bytes();
+        if (query_cache_) {
+            out.query_cache_bytes = query_cache_->bytes();
+            out.query_cache_entries = query_cache_->entries();
+        }
+    }
+    return out;
+}
+
 const VectorStore::Entry& VectorStore::get_entry(size_t idx) const {
     return entries_[idx];
 }
 
+size_t VectorStore::dim() const {
+    return dim_;
+}
+
+size_t VectorStore::stride() const {
+    return stride_;
+}
+
 size_t VectorStore::size() const {
     return count_.load(std::memory_order_acquire);
 }
 
 bool VectorStore::is_finalized() const {
     return is_finalized_.load(std::memory_order_acquire);
+}
+
+const VectorStoreOptions& VectorStore::options() const {
+    return options_;
+}
+
+Quantization VectorStore::quantization() const {
+    std::shared_lock<std::shared_mutex> lock(search_mutex_);
+    return main_->pq.empty() ? main_->quantizer.type() : Quantization::PQ;
+}
+
+std::vector<int> VectorStore::numa_nodes() const {
+    std::vector<int> nodes;
+    for (const numa::Node* node : numa_nodes_) nodes.push_back(node->id);
+    return nodes;
+}
+
+IndexType VectorStore::index_type() const {
+    std::shared_lock<std::shared_mutex> lock(search_mutex_);
+    if (!main_->hnsw.empty()) return IndexType::HNSW;
+    if (!main_->ivf.empty()) return IndexType::IVF;
+    return IndexType::Flat;
 }
\ No newline at end of file
@@ -12,29 +12,80 @@
 #include <cassert>
 #include <algorithm>
 #include <functional>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <limits>
+#include "mmap_file.h"
+#include "aligned_array.h"
+#include "page_memory.h"
+#include "segmented_array.h"
+#include "simd_kernels.h"
+#include "scalar_quantizer.h"
+#include "product_quantizer.h"
+#include "hnsw_index.h"
+#include "ivf_index.h"
+#include "text_index.h"
+#include "store_stats.h"
+#include "numa.h"
+#include "query_cache.h"
 
+// Arena tuning knobs
+struct ArenaOptions {
+    size_t first_chunk = 64 * 1024;         // Bytes in the first chunk
+    size_t max_chunk = 64 * 1024 * 1024;    // Chunks double up to this size
+    bool huge_pages = true;                 // Back chunks of 2MB and up with transparent huge pages
+    int numa_node = -1;                     // Preferred NUMA node for chunk pages (Linux); -1 = none
+};
+
+// Bump allocator over page-mapped chunks. Chunks start small and double up
+// to max_chunk, so a small store stays small; an allocation that does not fit
+// in max_chunk gets a dedicated chunk of its own. Memory is released only by
+// the destructor, or by shrink_to_fit() for the unused tail.
 class ArenaAllocator {
-    static constexpr size_t CHUNK_SIZE = 1 << 26;  // 64MB chunks
     struct Chunk {
-        alignas(64) char data[CHUNK_SIZE];
+        char* data = nullptr;
+        size_t capacity = 0;   // Usable bytes; lowered by shrink_to_fit()
+        size_t mapped = 0;     // Bytes mapped at data
         std::atomic<size_t> offset{0};
-        std::atomic<Chunk*> next{nullptr};
+        Chunk* next = nullptr;  // Older chunk, for the destructor
     };
     
-    std::unique_ptr<Chunk> head_;
-    std::atomic<Chunk*> current_;
-    std::mutex chunk_creation_mutex_;
+    Chunk* map_chunk(size_t bytes);
+    Chunk* add_chunk(Chunk* full, size_t min_bytes);
+    
+    ArenaOptions options_;
+    std::atomic<Chunk*> current_{nullptr};  // Newest bump chunk; also the list head
+    Chunk* oversized_ = nullptr;            // Dedicated chunks, guarded by chunk_creation_mutex_
+    size_t next_chunk_ = 0;                 // Size of the next bump chunk
+    std::atomic<size_t> reserved_{0};
+    mutable std::mutex chunk_creation_mutex_;
     
 public:
-    ArenaAllocator();
+    explicit ArenaAllocator(const ArenaOptions& options = {});
     void* allocate(size_t size, size_t align = 64);
     ~ArenaAllocator();
+    
+    // Disable copy and move: allocations point into the chunks
+    ArenaAllocator(const ArenaAllocator&) = delete;
+    ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+    
+    // Unmap the unused tail of the current chunk; later allocations start a new
+    // one. Not safe against concurrent allocate().
+    void shrink_to_fit();
+    
+    // Bytes currently mapped for chunks
+    size_t reserved_bytes() const { return reserved_.load(std::memory_order_relaxed); }
+    
+    // Bytes handed out of those chunks, alignment padding included
+    size_t used_bytes() const;
 };
 
 struct Document {
     std::string_view id;
     std::string_view text;
-    std::string_view metadata_json;  // Full JSON including embedding
+    std::string_view metadata_json;  // Metadata object without the embedding
 };
 
 // Per-thread top-k tracker for thread-safe parallel search
@@ -58,42 +109,522 @@ struct TopK {
     void merge(const TopK& other);
 };
 
+// Approximate index built by finalize()
+enum class IndexType {
+    Flat,  // Brute-force scan only
+    HNSW,  // Hierarchical navigable small world graph
+    IVF    // Inverted lists over k-means centroids (IVF-SQ8 with Int8, IVF-PQ with PQ)
+};
+
+// Placement of the main segment on multi-socket machines (Linux)
+struct NumaOptions {
+    // Split the matrix rows into one shard per node: a shard's pages are
+    // bound to its node and first touched there, and parallel scans give
+    // each shard its own share of the OpenMP team, merged at the end
+    bool shard = false;
+    
+    // Nodes to shard across, one shard per entry (a node listed twice gets
+    // two shards); empty uses every node with CPUs. Unknown nodes are ignored.
+    std::vector<int> nodes;
+    
+    // Pin each shard's threads to its node's CPUs while they copy or scan;
+    // false leaves placement to the OpenMP runtime (e.g. OMP_PROC_BIND)
+    bool pin_threads = true;
+};
+
+// Result cache for repeated query vectors (see query_cache.h)
+struct QueryCacheOptions {
+    // Budget for cached queries and results; 0 disables the cache
+    size_t max_bytes = 0;
+    
+    // Independently locked parts of the cache, each with max_bytes / shards
+    size_t shards = 16;
+};
+
+// Construction-time configuration for VectorStore
+struct VectorStoreOptions {
+    // add_document() returns CAPACITY beyond this many documents; 0 allows
+    // up to 2^32 - 1. The entry table grows on demand either way.
+    size_t max_documents = 0;
+    
+    IndexType index = IndexType::Flat;
+    HnswParams hnsw;
+    IvfParams ivf;
+    
+    // Stores smaller than this are always scanned; no index is built
+    size_t min_index_size = 1000;
+    
+    // Scans touching fewer rows run on the calling thread; larger scans use
+    // an OpenMP team when no other search is in flight
+    size_t parallel_scan_min_rows = 32768;
+    
+    // Compact code type scanned by search(), built by finalize()
+    Quantization quantization = Quantization::None;
+    PqParams pq;  // Used when quantization is PQ
+    
+    // Quantized searches re-rank the best k * rerank_oversample candidates
+    // against the float matrix; 0 returns approximate scores directly
+    size_t rerank_oversample = 4;
+    
+    // Documents added after finalize() are merged into the main segment (and
+    // its index) on a background thread once this many are pending, or
+    // delta_compact_fraction of the entries already in the main segment if
+    // that is more; 0 leaves merging to compact(). Every compaction rebuilds
+    // the whole segment (matrix, codes, IVF training, HNSW graph), so the
+    // fraction keeps the rebuild cost per insert bounded as the store grows,
+    // at the price of a larger delta scanned exactly by every search.
+    size_t delta_compact_rows = 10000;
+    double delta_compact_fraction = 0.1;
+    
+    // Chunking and page backing for the document payload and staging arenas
+    ArenaOptions arena;
+    
+    NumaOptions numa;
+    
+    QueryCacheOptions query_cache;
+    
+    // Metadata fields extracted into dictionary-encoded columns as documents
+    // are added, so SearchFilter can test them inside the scan
+    std::vector<std::string> filter_fields;
+    
+    // Tokenize Document::text as documents are added and build a BM25
+    // inverted index beside the vector index, for text_search() and
+    // hybrid_search()
+    bool text_index = false;
+    Bm25Params bm25;
+};
+
+// finalize() stages, in the order they run. IVF lists are built before the
+// codes (they reorder the rows), an HNSW graph after them.
+enum class FinalizeStage {
+    Compact,   // Copy embeddings into the matrix
+    Quantize,  // Encode compact codes
+    Index,     // Build the HNSW graph or IVF lists
+    Done       // Serving; done = documents, total = matrix rows
+};
+
+// Called on the thread that runs finalize(): Compact reports every few
+// thousand rows, the other stages once when they start (done = 0) and once
+// when they end (done = total)
+using FinalizeProgress = std::function<void(FinalizeStage stage, size_t done, size_t total)>;
+
+// How a scan is executed
+enum class SearchMode {
+    Auto,        // Parallel for large scans on an otherwise idle store, else sequential
+    Sequential,  // Calling thread only; concurrent searches run side by side
+    Parallel     // OpenMP team (falls back to sequential while another team is scanning)
+};
+
+// Metadata predicate for search(): a document matches when, for every
+// clause, its value of `field` is one of `values`. Only fields listed in
+// VectorStoreOptions::filter_fields can be tested; a clause on any other
+// field matches nothing. Strings compare by their decoded contents, numbers
+// by value (1, 1.0 and 1e0 are equal), and a value only matches its own
+// type: true is not "true".
+struct SearchFilter {
+    // A string, number or boolean, held as its column dictionary key: a type
+    // tag followed by the decoded string, the double's bytes, or 't' / 'f'
+    class Value {
+    public:
+        Value(const char* s) : key_(string_key(s)) {}
+        Value(const std::string& s) : key_(string_key(s)) {}
+        Value(double v) : key_(number_key(v)) {}
+        Value(int v) : Value(static_cast<double>(v)) {}
+        Value(bool b) : key_(bool_key(b)) {}
+        
+        const std::string& key() const { return key_; }
+        
+        static std::string string_key(std::string_view s) {
+            std::string key(1, 's');
+            key.append(s.data(), s.size());
+            return key;
+        }
+        static std::string number_key(double v) {
+            if (v == 0) v = 0;  // -0 and 0 are equal
+            std::string key(1 + sizeof(v), 'n');
+            std::memcpy(&key[1], &v, sizeof(v));
+            return key;
+        }
+        static std::string bool_key(bool b) { return b ? "bt" : "bf"; }
+        
+    private:
+        std::string key_;
+    };
+    
+    struct Clause {
+        std::string field;
+        std::vector<Value> values;
+    };
+    std::vector<Clause> clauses;  // Empty: every document matches
+};
+
+// Per-query knobs for VectorStore::search()
+struct SearchOptions {
+    SearchMode mode = SearchMode::Auto;
+    size_t ef = 0;       // HNSW candidate list size; 0 uses HnswParams::ef_search
+    size_t nprobe = 0;   // IVF lists to scan; 0 uses IvfParams::nprobe
+    bool exact = false;  // Force the brute-force scan (ground truth)
+    SearchFilter filter;  // Only matching documents are scored
+    
+    // Drop hits scoring below this. Scans start their top-k threshold here,
+    // so rows under it never enter a candidate buffer.
+    float min_score = -std::numeric_limits<float>::infinity();
+};
+
 class VectorStore {
 public:
     struct Entry {
         Document doc;
-        float* embedding;  // Extracted pointer for fast access
+        float* embedding;  // Matrix row once finalized (moved by compact()), or a delta block row
     };
+    
+    // Matrix rows are padded to a multiple of 16 floats (64 bytes, one AVX-512 register)
+    static constexpr size_t ROW_ALIGN_FLOATS = 16;
+    
+    // NUMA shard boundaries fall on multiples of this many rows (whole pages)
+    static constexpr size_t SHARD_ALIGN_ROWS = 1024;
 
 private:
+    const VectorStoreOptions options_;
     const size_t dim_;
-    ArenaAllocator arena_;
+    const size_t stride_;  // Floats per matrix row (dim_ rounded up to ROW_ALIGN_FLOATS)
+    const size_t capacity_;  // Maximum number of documents
+    ArenaAllocator arena_;  // Document payloads (id/text/metadata) - cold data
+    std::unique_ptr<ArenaAllocator> staging_arena_;  // Raw embeddings, released by finalize()
+    const kernels::DotFn dot_;  // Dot product kernel specialized for dim_
+    std::vector<const numa::Node*> numa_nodes_;  // Node of each shard; empty unless NumaOptions::shard
+    
+    // Immutable rows served by search(): the matrix plus the codes and index
+    // built over it. finalize() builds the first one, compact() replaces it.
+    struct Segment {
+        AlignedArray<float> matrix_storage;  // Owned matrix when built here
+        const float* matrix = nullptr;  // rows x stride_ normalized embeddings (owned or mapped)
+        size_t rows = 0;
+        size_t end = 0;  // Serves the live entries of [0, end); later ones are in the delta
+        std::unique_ptr<std::atomic<uint64_t>[]> dead;  // Removed rows, one bit per row
+        std::atomic<size_t> dead_rows{0};
+        ScalarQuantizer quantizer;  // Compact codes scanned when options_.quantization is Int8/Fp16
+        ProductQuantizer pq;  // Codebooks and codes scanned when options_.quantization is PQ
+        HnswIndex hnsw;  // Graph over matrix rows when options_.index is HNSW
+        IvfIndex ivf;  // Inverted lists over matrix rows when options_.index is IVF
+        TextIndex text;  // BM25 postings over entries [0, end) when options_.text_index is set
+        AlignedArray<uint32_t> row_ids_storage;
+        const uint32_t* row_ids = nullptr;  // Matrix row -> entry index; null when rows are in entry order
+    };
+    std::unique_ptr<Segment> main_;  // Swapped under an exclusive search_mutex_
+    
+    // Delta segment: documents added after finalize(). Entries [main_->rows, count_)
+    // point into append-only blocks of normalized rows, scanned exactly by search().
+    static constexpr size_t DELTA_BLOCK_ROWS = 1024;
+    static constexpr size_t COPY_BLOCK_ROWS = 16384;  // Rows per build_segment() copy task
+    struct DeltaBlock {
+        AlignedArray<float> rows;  // DELTA_BLOCK_ROWS x stride_
+        size_t first;  // Entry index of the first row
+    };
+    mutable std::mutex delta_mutex_;  // Serializes inserts and block bookkeeping
+    std::vector<DeltaBlock> delta_blocks_;
+    size_t delta_first_ = 0;  // First entry not yet merged into main_
+    std::mutex compact_mutex_;  // One compaction at a time
+    std::thread compact_thread_;  // Background compaction started by inserts
+    std::atomic<bool> compacting_{false};
+    
+    // Removed entries, one bit per entry. Rows of removed entries stay in the
+    // main segment (flagged in Segment::dead) until compact() drops them.
+    SegmentedArray<std::atomic<uint64_t>> removed_;
+    std::atomic<size_t> removed_count_{0};
+    std::unordered_map<std::string_view, uint32_t> id_index_;  // Built by finalize(); guarded by delta_mutex_
+    
+    // One column per VectorStoreOptions::filter_fields entry. Codes are
+    // written before their entry is published and never change.
+    struct FilterColumn {
+        std::string field;
+        SegmentedArray<uint32_t> codes;  // Per entry; 0 = field missing, null or not a scalar
+        mutable std::shared_mutex dictionary_mutex;
+        std::unordered_map<std::string, uint32_t> dictionary;  // Value -> code, from 1
+    };
+    std::vector<std::unique_ptr<FilterColumn>> filter_columns_;
+    
+    // Distinct terms of each entry's text (arena-allocated, sorted by hash)
+    // when options_.text_index is set; written before the entry is published
+    SegmentedArray<TextIndex::DocTerms> doc_terms_;
+    
+    // A SearchFilter resolved to column codes for one search
+    struct CompiledFilter {
+        std::vector<std::pair<const FilterColumn*, std::vector<uint32_t>>> clauses;  // Sorted codes
+        bool never = false;  // Some clause can match no document
+        bool matches(size_t idx) const;
+    };
     
-    std::vector<Entry> entries_;
-    std::atomic<size_t> count_{0};  // Atomic for parallel loading
+    SegmentedArray<Entry> entries_;  // Slots are claimed with count_ and filled in parallel
+    std::atomic<size_t> count_{0};  // Atomic for parallel loading; published under delta_mutex_ once serving
     std::atomic<bool> is_finalized_{false};  // Simple flag: false = loading, true = serving
-    mutable std::shared_mutex search_mutex_;  // Protects against overlapping OpenMP teams
+    mutable std::shared_mutex search_mutex_;  // Shared by searches; exclusive while compact() swaps main_
+    mutable std::atomic<size_t> active_searches_{0};  // Searches currently in flight
+    mutable std::atomic<bool> parallel_scan_busy_{false};  // One OpenMP team at a time
+    std::unique_ptr<MMapFile> snapshot_;  // Backing mapping when opened from a snapshot
+    mutable StatsCounters stats_;
+    
+    // Results of search()/search_range() by query and options; null unless
+    // QueryCacheOptions::max_bytes is set. Every change to the searchable
+    // documents (finalize, inserts, removals, compaction) invalidates it.
+    std::unique_ptr<QueryCache> query_cache_;
+    void invalidate_query_cache();
+    
+    // Shared search_mutex_ lock; time spent waiting for compact()'s swap is recorded
+    std::shared_lock<std::shared_mutex> lock_for_search() const;
+    
+    // Fill `segment` from the first n entries and build its codes and index,
+    // on an OpenMP team if `parallel`. Entries are only read, so inserts and
+    // searches may run meanwhile.
+    simdjson::error_code build_segment(Segment& segment, size_t n, bool parallel,
+                                       const FinalizeProgress& progress = nullptr) const;
+    
+    // Train IVF over the segment's owned matrix and reorder its rows into list order
+    void build_ivf(Segment& segment, bool parallel = true) const;
+    bool allocate_matrix(Segment& segment, size_t rows) const;
+    
+    // Row ranges of the NUMA shards of a `rows`-row matrix (empty without sharding)
+    std::vector<numa::Shard> numa_shards(size_t rows) const;
+    
+    // Prefer each shard's node for its rows of `base` (row_bytes per row)
+    void place_shards(void* base, size_t row_bytes, size_t rows) const;
+    
+    // Point every entry served by `segment` at its matrix row and flag rows
+    // of entries removed since it was built
+    void point_entries(Segment& segment);
+    
+    // Map every live entry id to its index
+    void build_id_index(size_t n);
+    
+    bool is_removed(size_t idx) const {
+        return (removed_[idx >> 6].load(std::memory_order_relaxed) >> (idx & 63)) & 1;
+    }
+    
+    // Allocate the entry slot, removal word and filter codes for `idx`; false on allocation failure
+    bool ensure_slot(size_t idx) {
+        if (!entries_.ensure(idx) || !removed_.ensure(idx >> 6)) return false;
+        for (auto& column : filter_columns_) {
+            if (!column->codes.ensure(idx)) return false;
+        }
+        return !options_.text_index || doc_terms_.ensure(idx);
+    }
+    
+    // Dictionary code of a raw JSON metadata value, keyed as SearchFilter::Value
+    // keys it (0 for null, objects, arrays and malformed values)
+    uint32_t encode_filter_value(FilterColumn& column, std::string_view raw);
+    
+    // Fill the filter columns of entries [0, n) from their metadata_json (open_snapshot())
+    simdjson::error_code index_filter_fields(size_t n);
+    
+    // open_snapshot() and attach(); with `shared`, sections the options need
+    // but the snapshot lacks are an error instead of being rebuilt here
+    simdjson::error_code map_snapshot(const std::string& path, bool shared);
+    
+    CompiledFilter compile_filter(const SearchFilter& filter) const;
+    
+    // Tokenize `text` into arena-allocated term counts; false on allocation failure
+    bool make_doc_terms(std::string_view text, TextIndex::DocTerms& terms);
+    
+    // Fill doc_terms_ for entries [0, n) from their text (open_snapshot())
+    simdjson::error_code index_text_terms(size_t n);
+    
+    // Flag entry `idx` and its main segment row; requires the search and delta locks
+    void mark_removed(size_t idx);
+    
+    simdjson::error_code insert(simdjson::ondemand::object& json_doc, const float* embedding, bool replace);
+    
+    // Room for one embedding row: the staging arena while loading, thread-local
+    // scratch once serving (append_delta() copies it); nullptr on allocation failure
+    float* stage_embedding(bool serving);
+    
+    // Second half of insert(): copy the strings into the arena, then publish
+    // the document with its staged embedding (normalized here while loading)
+    simdjson::error_code store_document(std::string_view id, std::string_view text, std::string_view metadata_json,
+                                        float* embedding, const uint32_t* filter_codes, bool serving,
+                                        bool replace);
+    
+    // Append a document to the delta segment (serving phase); `replace`
+    // removes an earlier document with the same id
+    simdjson::error_code append_delta(const Document& doc, const float* embedding,
+                                      const uint32_t* filter_codes, const TextIndex::DocTerms& terms,
+                                      bool replace);
+    
+    // Exact top-k over delta entries [begin, end) matching `filter` (if any)
+    // and scoring at least `min_score`; unsorted, in entry indices
+    std::vector<std::pair<float, size_t>> delta_top_k(const float* query, size_t k, size_t begin, size_t end,
+                                                      const CompiledFilter* filter, float min_score) const;
+    
+    // search() and search_range(): `range` never walks the graph and scores
+    // the float rows even in quantized stores, so every returned score is exact
+    std::vector<std::pair<float, size_t>>
+    search_rows(const float* query, size_t k, const SearchOptions& search_options, bool range) const;
+    
+    // search_rows() answered from query_cache_ when possible
+    std::vector<std::pair<float, size_t>>
+    cached_search(const float* query, size_t k, const SearchOptions& search_options, bool range) const;
+    
+    // Search executor: decide whether a scan over `scan_rows` rows gets the
+    // OpenMP team. A true result must be paired with release_parallel_scan().
+    bool acquire_parallel_scan(size_t scan_rows, SearchMode mode) const;
+    void release_parallel_scan() const;
     
 public:
-    explicit VectorStore(size_t dim);
+    explicit VectorStore(size_t dim, const VectorStoreOptions& options = VectorStoreOptions());
+    ~VectorStore();
+    
+    // Documents added after finalize() go to the delta segment: they are
+    // searchable as soon as add_document() returns.
     
     // Overload for document type (used in test_main.cpp)
     simdjson::error_code add_document(simdjson::ondemand::document& json_doc);
     
     simdjson::error_code add_document(simdjson::ondemand::object& json_doc);
     
-    // Finalize the store: normalize and switch to serving phase
-    void finalize();
+    // Add a document whose embedding (dim floats) comes from elsewhere, e.g. a
+    // binary sidecar file. `metadata` is optional and any embedding field in it
+    // is dropped unparsed.
+    simdjson::error_code add_document(simdjson::ondemand::object& json_doc, const float* embedding);
+    
+    // Serving phase only (INCORRECT_TYPE before finalize()): add the document,
+    // removing any earlier document with the same id
+    simdjson::error_code upsert(simdjson::ondemand::document& json_doc);
+    simdjson::error_code upsert(simdjson::ondemand::object& json_doc);
+    simdjson::error_code upsert(simdjson::ondemand::object& json_doc, const float* embedding);
+    
+    // Add `count` documents without metadata straight from memory, in parallel
+    // and without going through JSON: document i is ids[i], texts[i] and row i
+    // of `embeddings` (count x dim floats). Works in both phases. Returns how
+    // many were added; the rest are counted as rejected in stats().
+    size_t add_documents(const std::string_view* ids, const std::string_view* texts,
+                         const float* embeddings, size_t count);
+    
+    // Remove a document by id (serving phase). Searches skip it from now on;
+    // its row is dropped by the next compact() and its strings by save().
+    // Returns false if no live document has this id.
+    bool remove(std::string_view id);
+    
+    // Live document with this id, or nullptr (serving phase). With duplicate
+    // ids from loading, one of them.
+    const Entry* get_by_id(std::string_view id) const;
+    
+    // Index of the live document with this id, or SIZE_MAX
+    size_t index_of(std::string_view id) const;
+    
+    // Finalize the store: compact the embeddings (normalized as they were
+    // added) into one contiguous matrix, quantize and build the index if
+    // configured and switch to serving phase. Every stage uses all OpenMP
+    // threads. Returns MEMALLOC if storage cannot be allocated (the store
+    // stays in loading phase).
+    simdjson::error_code finalize(const FinalizeProgress& progress = nullptr);
+    
+    // Merge the delta segment into the main segment and rebuild its codes and
+    // index. Searches keep running on the old segment until a brief swap at
+    // the end. Returns INCORRECT_TYPE before finalize(), MEMALLOC if storage
+    // cannot be allocated (the delta is then still served as is).
+    simdjson::error_code compact();
+    
+    // Documents added after finalize() and not yet compacted
+    size_t delta_size() const;
     
     // Deprecated: use finalize() instead
     void normalize_all();
     
+    // Top-k by cosine similarity (query must be normalized). Uses the HNSW
+    // graph or IVF lists when built, otherwise scans every row; quantized stores
+    // scan the compact codes, then re-rank candidates with exact float scores.
+    // Safe to call from many threads at once, and alongside add_document() and
+    // compact(): rows in the delta segment are scanned exactly and merged in.
     std::vector<std::pair<float, size_t>> 
-    search(const float* query, size_t k) const;
+    search(const float* query, size_t k, const SearchOptions& search_options = SearchOptions()) const;
+    
+    // Every document scoring at least `min_score` against `query`, best
+    // first, capped at `max_results` (0: no cap). Scores the float rows of
+    // every row (or of the probed IVF lists, unless `exact`) with per-thread
+    // buffers that only grow with hits; HNSW graphs are not used.
+    std::vector<std::pair<float, size_t>>
+    search_range(const float* query, float min_score, size_t max_results = 0,
+                 const SearchOptions& search_options = SearchOptions()) const;
+    
+    // Top-k for `nq` queries stored back to back (nq x dim, normalized). The
+    // exact scan shares each database row across all queries; indexed and
+    // quantized stores answer query by query.
+    std::vector<std::vector<std::pair<float, size_t>>>
+    search_batch(const float* queries, size_t nq, size_t k,
+                 const SearchOptions& search_options = SearchOptions()) const;
+    
+    // Top-k by BM25 score of `text` against the documents' text (requires
+    // VectorStoreOptions::text_index; empty otherwise). Honors the filter in
+    // `search_options`; the other knobs only apply to vector search.
+    std::vector<std::pair<float, size_t>>
+    text_search(std::string_view text, size_t k, const SearchOptions& search_options = SearchOptions()) const;
+    
+    // Top-k fusing search(query) and text_search(text) by reciprocal rank:
+    // score = alpha / (60 + vector rank) + (1 - alpha) / (60 + text rank),
+    // over the best max(4k, 100) hits of each. alpha = 1 is pure vector
+    // search, 0 pure BM25.
+    std::vector<std::pair<float, size_t>>
+    hybrid_search(const float* query, std::string_view text, size_t k, float alpha = 0.5f,
+                  const SearchOptions& search_options = SearchOptions()) const;
+    
+    // Write the finalized store to a binary snapshot (see snapshot_format.h)
+    simdjson::error_code save(const std::string& path) const;
+    
+    // Map a snapshot written by save() and switch directly to serving phase.
+    // Embeddings and document strings point into the mapping; only filter
+    // fields and the text index, if configured, are rebuilt from the strings.
+    simdjson::error_code open_snapshot(const std::string& path);
     
+    // Shared stores for multi-process servers: one process publishes a
+    // finalized store under `name` (a snapshot in /dev/shm, or the temp
+    // directory where there is none) and any number of processes attach to
+    // it. Attached stores map the matrix, codes and index MAP_SHARED, so they
+    // cost one copy in total however many processes serve them. The snapshot
+    // is renamed into place, so attach() sees either nothing or a whole store.
+    // Publish after compact() if documents were added or removed since
+    // finalize(): save() leaves the index out otherwise, and attach() fails
+    // with INCORRECT_TYPE rather than building a private copy in each process.
+    simdjson::error_code publish(const std::string& name) const;
+    simdjson::error_code attach(const std::string& name);
+    
+    // Delete a published store. Stores already attached keep their mapping.
+    static simdjson::error_code unpublish(const std::string& name);
+    
+    // Backing file of a published store; empty if `name` is not a plain file name
+    static std::string shared_path(const std::string& name);
+    
+    // idx < size()
     const Entry& get_entry(size_t idx) const;
     
+    size_t dim() const;
+    
+    // Distance in floats between consecutive embedding rows
+    size_t stride() const;
+    
+    // Document slots, removed documents included (valid get_entry() indices)
     size_t size() const;
     
+    // Documents removed since the store was loaded or opened
+    size_t removed_size() const;
+    
     bool is_finalized() const;
+    
+    const VectorStoreOptions& options() const;
+    
+    // Counters and histograms gathered so far (zeros when built with NVS_NO_STATS)
+    StoreStats stats() const;
+    
+    // Live counters, for loaders that record their own phases
+    StatsCounters& stats_counters() const { return stats_; }
+    
+    // True if `field` is one of VectorStoreOptions::filter_fields
+    bool is_filter_field(std::string_view field) const;
+    
+    // Code type actually used by search() (None until finalized)
+    Quantization quantization() const;
+    
+    // Index actually used by search() (Flat until finalized, or for small stores)
+    IndexType index_type() const;
+    
+    // NUMA node of each main segment shard (empty without NumaOptions::shard)
+    std::vector<int> numa_nodes() const;
 };
\ No newline at end of file
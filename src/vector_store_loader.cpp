@@ -1,176 +1,639 @@
 #include "vector_store_loader.h"
-#include "atomic_queue.h"
+#include "embedding_file.h"
+#include "json_chunks.h"
+#include "mmap_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <thread>
 #include <vector>
-#include <atomic>
-#include <cctype>
 
-void VectorStoreLoader::loadDirectory(VectorStore* store, const std::string& path) {
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Arrays at least this large are split so every parser thread can help
+constexpr size_t SPLIT_MIN_BYTES = 16 * 1024 * 1024;
+constexpr size_t MIN_CHUNK_BYTES = 1024 * 1024;
+
+// addBuffer() chunks: enough of them to balance the threads, each small
+// enough for its iterate_many stream to index in one batch
+constexpr size_t BUFFER_CHUNK_MIN = 64 * 1024;
+constexpr size_t BUFFER_CHUNK_MAX = 4 * 1024 * 1024;
+
+// Buffers are allocated in these steps so they can be reused for other files
+constexpr size_t BUFFER_GRANULE = 64 * 1024;
+
+// File bytes followed by simdjson's required padding
+struct LoadBuffer {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;      // File bytes
+    size_t capacity = 0;  // Allocated bytes, at least size + SIMDJSON_PADDING
+};
+
+// Recycles parse buffers and bounds the bytes they hold (idle or in use) by
+// a budget. Readers block in acquire() until enough is released; a file
+// larger than the whole budget is admitted once nothing else is held.
+class BufferPool {
+public:
+    explicit BufferPool(size_t budget) : budget_(budget) {}
+
+    // Returns a buffer with `size` bytes of room plus padding; data is null on
+    // allocation failure
+    LoadBuffer acquire(size_t size) {
+        const size_t needed = size + simdjson::SIMDJSON_PADDING;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            // Reuse the smallest idle buffer that is big enough
+            auto best = idle_.end();
+            for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+                if (it->capacity >= needed && (best == idle_.end() || it->capacity < best->capacity)) {
+                    best = it;
+                }
+            }
+            if (best != idle_.end()) {
+                LoadBuffer buffer = std::move(*best);
+                idle_.erase(best);
+                return prepare(std::move(buffer), size);
+            }
+
+            // None fits: make room by dropping idle buffers
+            while (!idle_.empty() && held_ + needed > budget_) {
+                held_ -= idle_.back().capacity;
+                idle_.pop_back();
+            }
+            if (held_ + needed <= budget_ || held_ == 0) {
+                LoadBuffer buffer;
+                buffer.capacity = (needed + BUFFER_GRANULE - 1) / BUFFER_GRANULE * BUFFER_GRANULE;
+                buffer.data.reset(new (std::nothrow) char[buffer.capacity]);
+                if (!buffer.data) {
+                    return {};
+                }
+                held_ += buffer.capacity;
+                return prepare(std::move(buffer), size);
+            }
+            released_.wait(lock);
+        }
+    }
+
+    void release(LoadBuffer buffer) {
+        if (!buffer.data) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back(std::move(buffer));
+        }
+        released_.notify_all();
+    }
+
+private:
+    static LoadBuffer prepare(LoadBuffer buffer, size_t size) {
+        buffer.size = size;
+        std::memset(buffer.data.get() + size, 0, simdjson::SIMDJSON_PADDING);
+        return buffer;
+    }
+
+    const size_t budget_;
+    size_t held_ = 0;  // Capacity of every buffer handed out or idle
+    std::vector<LoadBuffer> idle_;
+    std::mutex mutex_;
+    std::condition_variable released_;
+};
+
+// A file read into a pooled buffer. Once the last parser drops it the buffer
+// goes back to the pool.
+struct LoadedFile {
+    BufferPool* pool = nullptr;
+    std::string filename;
+    LoadBuffer buffer;
+    std::unique_ptr<EmbeddingFile> embeddings;       // Row i pairs with document i
+    std::vector<std::pair<size_t, size_t>> elements; // Set when split into chunks
+
+    LoadedFile(BufferPool* pool, std::string filename, LoadBuffer buffer, std::unique_ptr<EmbeddingFile> embeddings)
+        : pool(pool), filename(std::move(filename)), buffer(std::move(buffer)), embeddings(std::move(embeddings)) {}
+    ~LoadedFile() { pool->release(std::move(buffer)); }
+};
+
+// A whole file, or elements [begin, end) of a split one
+struct Work {
+    std::shared_ptr<LoadedFile> file;
+    bool chunk = false;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+// Blocking work queue between readers and parsers. Chunks of split files go
+// first so a file's buffer is released as early as possible.
+class WorkQueue {
+public:
+    explicit WorkQueue(size_t producers) : producers_(producers) {}
+
+    void push_file(std::shared_ptr<LoadedFile> file) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            files_.push_back({std::move(file)});
+        }
+        ready_.notify_one();
+    }
+
+    // Cut a split file's elements into chunks of about `chunk_bytes`
+    void push_chunks(const std::shared_ptr<LoadedFile>& file, size_t chunk_bytes) {
+        const auto& elements = file->elements;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (size_t begin = 0; begin < elements.size();) {
+                size_t end = begin + 1;
+                while (end < elements.size() && elements[end].second - elements[begin].first < chunk_bytes) ++end;
+                chunks_.push_back({file, true, begin, end});
+                begin = end;
+            }
+        }
+        ready_.notify_all();
+    }
+
+    void producer_done() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --producers_;
+        }
+        ready_.notify_all();
+    }
+
+    // Blocks for the next item; false once readers are done and nothing is
+    // queued or being parsed (a parser may still add chunks)
+    bool pop(Work& work) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [&] {
+            return !chunks_.empty() || !files_.empty() || (producers_ == 0 && busy_ == 0);
+        });
+        std::deque<Work>& source = !chunks_.empty() ? chunks_ : files_;
+        if (source.empty()) {
+            return false;
+        }
+        work = std::move(source.front());
+        source.pop_front();
+        ++busy_;
+        return true;
+    }
+
+    // Call once a popped item is fully parsed
+    void finish(Work& work) {
+        work.file.reset();
+        bool drained;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            drained = --busy_ == 0 && producers_ == 0 && chunks_.empty() && files_.empty();
+        }
+        if (drained) ready_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<Work> files_;
+    std::deque<Work> chunks_;
+    size_t producers_;
+    size_t busy_ = 0;
+};
+
+// Map the sidecar of `json_path` if it has one. `ok` is false when a sidecar
+// exists but is unusable (the error has been reported).
+std::unique_ptr<EmbeddingFile> openSidecar(const std::filesystem::path& json_path, size_t dim, bool& ok) {
+    ok = true;
+    std::filesystem::path sidecar = EmbeddingFile::find_sidecar(json_path);
+    if (sidecar.empty()) {
+        return nullptr;
+    }
+
+    auto embeddings = std::make_unique<EmbeddingFile>();
+    if (!embeddings->open(sidecar, dim)) {
+        fprintf(stderr, "Error opening embeddings %s: %s\n", sidecar.c_str(), embeddings->error());
+        ok = false;
+        return nullptr;
+    }
+    return embeddings;
+}
+
+// Read `size` bytes of `path` into `out`
+bool readFile(const std::filesystem::path& path, size_t size, bool use_mmap, char* out) {
+    if (use_mmap) {
+        MMapFile mmap;
+        if (!mmap.open(path.string()) || mmap.size() != size) {
+            return false;
+        }
+        std::memcpy(out, mmap.data(), size);
+        return true;
+    }
+
+    #ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    return file && file.read(out, size);
+    #else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(fd, out + done, size - done, static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    return done == size;
+    #endif
+}
+
+// Add one parsed document; `index` is its position in the file, which picks
+// its sidecar row
+void addOne(VectorStore* store, simdjson::ondemand::object& obj, const EmbeddingFile* embeddings,
+            size_t index, const std::string& filename) {
+    simdjson::error_code add_error;
+    if (!embeddings) {
+        add_error = store->add_document(obj);
+    } else if (index < embeddings->rows()) {
+        add_error = store->add_document(obj, embeddings->row(index));
+    } else {
+        add_error = simdjson::CAPACITY;  // More documents than embedding rows
+        store->stats_counters().reject(add_error);
+    }
+    if (add_error) {
+        fprintf(stderr, "Error adding document from %s: %s\n",
+               filename.c_str(), simdjson::error_message(add_error));
+    }
+}
+
+void checkSidecarRows(const EmbeddingFile* embeddings, size_t documents, const std::string& filename) {
+    if (embeddings && documents != embeddings->rows()) {
+        fprintf(stderr, "Warning: %s has %zu documents but %zu embedding rows\n",
+                filename.c_str(), documents, embeddings->rows());
+    }
+}
+
+// Parse one file (a document or an array of documents) into the store, or
+// split a large array into chunks for every parser thread
+void addDocuments(VectorStore* store, simdjson::ondemand::parser& parser,
+                  const std::shared_ptr<LoadedFile>& file, WorkQueue& queue, size_t parse_threads) {
+    const LoadBuffer& buffer = file->buffer;
+
+    if (buffer.size >= SPLIT_MIN_BYTES &&
+        split_json_array(buffer.data.get(), buffer.size, file->elements) && !file->elements.empty()) {
+        checkSidecarRows(file->embeddings.get(), file->elements.size(), file->filename);
+        // Several chunks per thread so a slow chunk does not hold up the file
+        queue.push_chunks(file, std::max(MIN_CHUNK_BYTES, buffer.size / (parse_threads * 8)));
+        return;
+    }
+
+    // Check if it's an array or object
+    const char* json_start = buffer.data.get();
+    const char* json_end = json_start + buffer.size;
+    while (json_start < json_end && std::isspace(static_cast<unsigned char>(*json_start))) {
+        json_start++;
+    }
+    bool is_array = (json_start < json_end && *json_start == '[');
+
+    simdjson::ondemand::document doc;
+    auto error = parser.iterate(buffer.data.get(), buffer.size, buffer.capacity).get(doc);
+    if (error) {
+        fprintf(stderr, "Error parsing %s: %s\n", file->filename.c_str(), simdjson::error_message(error));
+        store->stats_counters().reject(error);
+        return;
+    }
+
+    // Document i pairs with sidecar row i, whether or not it parses
+    const EmbeddingFile* embeddings = file->embeddings.get();
+    size_t index = 0;
+    if (is_array) {
+        // Process as array
+        simdjson::ondemand::array arr;
+        error = doc.get_array().get(arr);
+        if (error) {
+            fprintf(stderr, "Error getting array from %s: %s\n", file->filename.c_str(), simdjson::error_message(error));
+            store->stats_counters().reject(error);
+            return;
+        }
+
+        for (auto doc_element : arr) {
+            simdjson::ondemand::object obj;
+            error = doc_element.get_object().get(obj);
+            if (!error) {
+                addOne(store, obj, embeddings, index, file->filename);
+            } else {
+                store->stats_counters().reject(error);
+            }
+            ++index;
+        }
+    } else {
+        // Process as single document
+        simdjson::ondemand::object obj;
+        error = doc.get_object().get(obj);
+        if (!error) {
+            addOne(store, obj, embeddings, index, file->filename);
+        } else {
+            store->stats_counters().reject(error);
+        }
+        ++index;
+    }
+
+    checkSidecarRows(embeddings, index, file->filename);
+}
+
+// Parse elements [begin, end) of a split array file
+void addChunk(VectorStore* store, simdjson::ondemand::parser& parser, const Work& work) {
+    const LoadedFile& file = *work.file;
+    const char* base = file.buffer.data.get();
+
+    // Each element is parsed as its own document; the bytes after it (the
+    // rest of the file, then the padding) satisfy simdjson's padding rule
+    for (size_t e = work.begin; e < work.end; ++e) {
+        auto [begin, end] = file.elements[e];
+        simdjson::ondemand::document doc;
+        simdjson::ondemand::object obj;
+        auto error = parser.iterate(base + begin, end - begin, file.buffer.capacity - begin).get(doc);
+        if (!error) {
+            error = doc.get_object().get(obj);
+        }
+        if (error) {
+            fprintf(stderr, "Error parsing element %zu of %s: %s\n",
+                    e, file.filename.c_str(), simdjson::error_message(error));
+            store->stats_counters().reject(error);
+            continue;
+        }
+        addOne(store, obj, file.embeddings.get(), e, file.filename);
+    }
+}
+
+// Add documents [begin, end) of an addBuffer() buffer through one
+// iterate_many stream over their bytes (`commas` for array elements). A
+// stream stops at a malformed document; the rest are then parsed one by one.
+void addStream(VectorStore* store, simdjson::ondemand::parser& parser, const char* base, size_t capacity,
+               const std::vector<std::pair<size_t, size_t>>& docs, size_t begin, size_t end, bool commas,
+               std::atomic<size_t>& added, std::atomic<size_t>& rejected) {
+    StatsCounters& stats = store->stats_counters();
+    size_t ok = 0;
+    size_t failed = 0;
+    auto add = [&](simdjson::ondemand::object& obj) {
+        // add_document() counts its own rejections
+        if (store->add_document(obj)) {
+            ++failed;
+        } else {
+            ++ok;
+        }
+    };
+
+    const size_t first = docs[begin].first;
+    const size_t bytes = docs[end - 1].second - first;
+    size_t done = 0;
+    bool broken = true;
+    simdjson::ondemand::document_stream stream;
+    if (!parser.iterate_many(base + first, bytes, std::max<size_t>(bytes, 4096), commas).get(stream)) {
+        auto it = stream.begin();
+        for (; it != stream.end() && !it.error(); ++it, ++done) {
+            auto doc = *it;
+            simdjson::ondemand::object obj;
+            auto error = doc.get_object().get(obj);
+            if (error) {
+                stats.reject(error);
+                ++failed;
+                continue;
+            }
+            add(obj);
+        }
+        broken = it != stream.end();
+    }
+
+    if (broken) {
+        for (size_t e = begin + std::min(done, end - begin); e < end; ++e) {
+            auto [doc_begin, doc_end] = docs[e];
+            simdjson::ondemand::document doc;
+            simdjson::ondemand::object obj;
+            auto error = parser.iterate(base + doc_begin, doc_end - doc_begin, capacity - doc_begin).get(doc);
+            if (!error) {
+                error = doc.get_object().get(obj);
+            }
+            if (error) {
+                stats.reject(error);
+                ++failed;
+                continue;
+            }
+            add(obj);
+        }
+    }
+
+    added.fetch_add(ok, std::memory_order_relaxed);
+    rejected.fetch_add(failed, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void VectorStoreLoader::load(VectorStore* store, const std::string& path, const LoaderOptions& options) {
     // Cannot load if already finalized
     if (store->is_finalized()) {
         return;
     }
-    
+
     // Collect all JSON files
-    std::vector<std::filesystem::path> json_files;
+    struct FileInfo {
+        std::filesystem::path path;
+        size_t size;
+    };
+    std::vector<FileInfo> files;
     for (const auto& entry : std::filesystem::directory_iterator(path)) {
         if (entry.path().extension() == ".json") {
-            json_files.push_back(entry.path());
+            std::error_code ec;
+            auto size = std::filesystem::file_size(entry.path(), ec);
+            if (ec) {
+                fprintf(stderr, "Error getting size of %s: %s\n",
+                        entry.path().c_str(), ec.message().c_str());
+                continue;
+            }
+            files.push_back({entry.path(), static_cast<size_t>(size)});
         }
     }
-    
-    if (json_files.empty()) {
+
+    if (files.empty()) {
         store->finalize();
         return;
     }
-    
-    // Producer-consumer queue for file data
-    struct FileData {
-        std::string filename;
-        std::string content;
-    };
-    
-    // Queue with bounded capacity (max ~100MB of buffered data)
-    atomic_queue::AtomicQueue<FileData*, 1024> queue;
-    
-    // Atomic flags for coordination
-    std::atomic<bool> producer_done{false};
-    std::atomic<size_t> files_processed{0};
-    
-    // Producer thread - sequential file reading with optimizations
-    std::thread producer([&]() {
-        // Reusable buffer to avoid repeated allocations
-        std::vector<char> buffer;
-        // Start with reasonable capacity, will grow as needed
-        buffer.reserve(1024 * 1024); // 1MB initial capacity
-        
-        for (const auto& filepath : json_files) {
-            // Get file size without opening (one syscall)
-            std::error_code ec;
-            auto size = std::filesystem::file_size(filepath, ec);
-            if (ec) {
-                fprintf(stderr, "Error getting size of %s: %s\n", 
-                        filepath.c_str(), ec.message().c_str());
-                continue;
-            }
-            
-            // Open file for reading
-            std::ifstream file(filepath, std::ios::binary);
-            if (!file) {
-                fprintf(stderr, "Error opening %s\n", filepath.c_str());
-                continue;
-            }
-            
-            // Ensure buffer has enough capacity
-            if (size > buffer.capacity()) {
-                buffer.reserve(size);
-            }
-            // Resize buffer to exact size needed
-            buffer.resize(size);
-            
-            // Read directly into buffer
-            if (!file.read(buffer.data(), size)) {
-                fprintf(stderr, "Error reading %s\n", filepath.c_str());
-                continue;
+
+    const size_t parse_threads = options.parse_threads ? options.parse_threads
+                                                       : std::max(1u, std::thread::hardware_concurrency());
+    const size_t io_threads = std::max<size_t>(1, std::min(options.io_threads, files.size()));
+
+    StatsCounters& stats = store->stats_counters();
+    BufferPool pool(options.buffer_budget);
+    WorkQueue queue(io_threads);
+    std::atomic<size_t> next_file{0};
+
+    // Readers: each keeps one read outstanding, so io_threads reads are in flight
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < io_threads; ++r) {
+        readers.emplace_back([&]() {
+            for (size_t i; (i = next_file.fetch_add(1)) < files.size();) {
+                const FileInfo& info = files[i];
+                bool sidecar_ok;
+                auto embeddings = openSidecar(info.path, store->dim(), sidecar_ok);
+                if (!sidecar_ok) {
+                    continue;
+                }
+
+                LoadBuffer buffer = pool.acquire(info.size);
+                if (!buffer.data) {
+                    fprintf(stderr, "Error allocating %zu bytes for %s\n", info.size, info.path.c_str());
+                    continue;
+                }
+                bool use_mmap = options.io == LoaderOptions::Io::MMap ||
+                                (options.io == LoaderOptions::Io::Adaptive && info.size < options.mmap_max_bytes);
+                const uint64_t read_start = stats_now_ns();
+                bool read_ok = readFile(info.path, info.size, use_mmap, buffer.data.get());
+                StatsCounters::add(stats.read_ns, stats_now_ns() - read_start);
+                if (!read_ok) {
+                    fprintf(stderr, "Error reading %s\n", info.path.c_str());
+                    pool.release(std::move(buffer));
+                    continue;
+                }
+                StatsCounters::add(stats.bytes_read, info.size);
+                StatsCounters::add(stats.files_read, 1);
+
+                queue.push_file(std::make_shared<LoadedFile>(&pool, info.path.string(), std::move(buffer),
+                                                             std::move(embeddings)));
             }
-            
-            // Create file data with string move-constructed from buffer
-            auto* data = new FileData{
-                filepath.string(), 
-                std::string(buffer.begin(), buffer.end())
-            };
-            queue.push(data);
-        }
-        producer_done = true;
-    });
-    
-    // Consumer threads - parallel JSON parsing
-    size_t num_workers = std::thread::hardware_concurrency();
-    std::vector<std::thread> consumers;
-    
-    for (size_t w = 0; w < num_workers; ++w) {
-        consumers.emplace_back([&]() {
+            queue.producer_done();
+        });
+    }
+
+    // Parsers: whole files, or chunks of split ones
+    std::vector<std::thread> parsers;
+    for (size_t w = 0; w < parse_threads; ++w) {
+        parsers.emplace_back([&]() {
             // Each thread needs its own parser
             simdjson::ondemand::parser doc_parser;
-            FileData* data = nullptr;
-            
-            while (true) {
-                // Try to get work from queue
-                if (queue.try_pop(data)) {
-                    // Process the file
-                    simdjson::padded_string json(data->content);
-                    
-                    // Check if it's an array or object
-                    const char* json_start = json.data();
-                    while (json_start && *json_start && std::isspace(*json_start)) {
-                        json_start++;
-                    }
-                    bool is_array = (json_start && *json_start == '[');
-                    
-                    simdjson::ondemand::document doc;
-                    auto error = doc_parser.iterate(json).get(doc);
-                    if (error) {
-                        fprintf(stderr, "Error parsing %s: %s\n", data->filename.c_str(), simdjson::error_message(error));
-                        delete data;
-                        continue;
-                    }
-                    
-                    if (is_array) {
-                        // Process as array
-                        simdjson::ondemand::array arr;
-                        error = doc.get_array().get(arr);
-                        if (error) {
-                            fprintf(stderr, "Error getting array from %s: %s\n", data->filename.c_str(), simdjson::error_message(error));
-                            delete data;
-                            continue;
-                        }
-                        
-                        for (auto doc_element : arr) {
-                            simdjson::ondemand::object obj;
-                            error = doc_element.get_object().get(obj);
-                            if (!error) {
-                                auto add_error = store->add_document(obj);
-                                if (add_error) {
-                                    fprintf(stderr, "Error adding document from %s: %s\n", 
-                                           data->filename.c_str(), simdjson::error_message(add_error));
-                                }
-                            }
-                        }
-                    } else {
-                        // Process as single document
-                        simdjson::ondemand::object obj;
-                        error = doc.get_object().get(obj);
-                        if (!error) {
-                            auto add_error = store->add_document(obj);
-                            if (add_error) {
-                                fprintf(stderr, "Error adding document from %s: %s\n", 
-                                       data->filename.c_str(), simdjson::error_message(add_error));
-                            }
-                        }
-                    }
-                    
-                    delete data;
-                    files_processed++;
-                    
-                } else if (producer_done.load()) {
-                    // No more work and producer is done
-                    break;
+            Work work;
+            while (queue.pop(work)) {
+                ScopedTimer timer(stats.parse_ns);
+                if (work.chunk) {
+                    addChunk(store, doc_parser, work);
                 } else {
-                    // Queue is empty but producer might add more
-                    std::this_thread::yield();
+                    addDocuments(store, doc_parser, work.file, queue, parse_threads);
                 }
+                queue.finish(work);
             }
         });
     }
-    
+
     // Wait for all threads to complete
-    producer.join();
-    for (auto& consumer : consumers) {
-        consumer.join();
+    for (auto& reader : readers) {
+        reader.join();
     }
-    
+    for (auto& parser : parsers) {
+        parser.join();
+    }
+
     // Finalize after batch load - normalize and switch to serving phase
-    store->finalize();
-}
\ No newline at end of file
+    auto error = store->finalize();
+    if (error) {
+        fprintf(stderr, "Error finalizing store: %s\n", simdjson::error_message(error));
+    }
+}
+
+void VectorStoreLoader::loadDirectory(VectorStore* store, const std::string& path) {
+    LoaderOptions options;
+    options.io = LoaderOptions::Io::Read;
+    load(store, path, options);
+}
+
+void VectorStoreLoader::loadDirectoryMMap(VectorStore* store, const std::string& path) {
+    LoaderOptions options;
+    options.io = LoaderOptions::Io::MMap;
+    load(store, path, options);
+}
+
+void VectorStoreLoader::loadDirectoryAdaptive(VectorStore* store, const std::string& path) {
+    load(store, path, LoaderOptions());
+}
+
+BufferLoadResult VectorStoreLoader::addBuffer(VectorStore* store, const char* data, size_t size,
+                                              const LoaderOptions& options) {
+    BufferLoadResult result;
+    StatsCounters& stats = store->stats_counters();
+
+    // simdjson reads up to SIMDJSON_PADDING bytes past the last document
+    simdjson::padded_string padded(data, size);
+    if (size && !padded.data()) {
+        stats.reject(simdjson::MEMALLOC);
+        result.rejected = 1;
+        return result;
+    }
+    const char* base = padded.data();
+    const size_t capacity = size + simdjson::SIMDJSON_PADDING;
+
+    size_t start = 0;
+    while (start < size && std::isspace(static_cast<unsigned char>(base[start]))) {
+        start++;
+    }
+    const bool is_array = start < size && base[start] == '[';
+
+    std::vector<std::pair<size_t, size_t>> docs;
+    if (is_array) {
+        if (!split_json_array(base, size, docs)) {
+            stats.reject(simdjson::TAPE_ERROR);  // Not a well-nested array
+            result.rejected = 1;
+            return result;
+        }
+    } else {
+        split_json_lines(base, size, docs);
+    }
+    if (docs.empty()) {
+        return result;
+    }
+
+    // Several chunks per thread so a slow chunk does not hold up the rest
+    const size_t parse_threads = options.parse_threads ? options.parse_threads
+                                                       : std::max(1u, std::thread::hardware_concurrency());
+    const size_t target = std::clamp(size / (parse_threads * 8), BUFFER_CHUNK_MIN, BUFFER_CHUNK_MAX);
+    std::vector<size_t> bounds = {0};
+    for (size_t d = 0; d < docs.size(); ++d) {
+        if (d + 1 == docs.size() || docs[d].second - docs[bounds.back()].first >= target) {
+            bounds.push_back(d + 1);
+        }
+    }
+
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<size_t> added{0};
+    std::atomic<size_t> rejected{0};
+    auto parse = [&]() {
+        // Each thread needs its own parser
+        simdjson::ondemand::parser doc_parser;
+        for (size_t c; (c = next_chunk.fetch_add(1)) + 1 < bounds.size();) {
+            ScopedTimer timer(stats.parse_ns);
+            addStream(store, doc_parser, base, capacity, docs, bounds[c], bounds[c + 1], is_array,
+                      added, rejected);
+        }
+    };
+
+    std::vector<std::thread> parsers;
+    const size_t threads = std::min(parse_threads, bounds.size() - 1);
+    for (size_t w = 1; w < threads; ++w) {
+        parsers.emplace_back(parse);
+    }
+    parse();
+    for (auto& parser : parsers) {
+        parser.join();
+    }
+
+    result.added = added.load();
+    result.rejected = rejected.load();
+    return result;
+}
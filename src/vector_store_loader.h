@@ -2,18 +2,56 @@
 #include "vector_store.h"
 #include <string>
 
-// Clean interface for loading documents from a directory
+// Loader tuning knobs
+struct LoaderOptions {
+    enum class Io {
+        Read,      // pread straight into padded parse buffers
+        MMap,      // Map each file and copy it into a padded parse buffer
+        Adaptive   // Map files up to mmap_max_bytes, read larger ones
+    };
+    Io io = Io::Adaptive;
+    size_t io_threads = 4;                      // Files read concurrently
+    size_t parse_threads = 0;                   // 0 = hardware concurrency
+    size_t buffer_budget = 256 * 1024 * 1024;   // Bytes read ahead of the parsers
+    size_t mmap_max_bytes = 5 * 1024 * 1024;    // Adaptive cutoff
+};
+
+// Outcome of VectorStoreLoader::addBuffer()
+struct BufferLoadResult {
+    size_t added = 0;
+    size_t rejected = 0;  // Documents that did not parse or were refused by the store
+};
+
+// Clean interface for loading documents from a directory.
+//
+// All entry points share one pipeline: `io_threads` readers fill recycled,
+// padded buffers (at most `buffer_budget` bytes in flight) and parser threads
+// turn them into documents. Array files over 16MB are split at element
+// boundaries so every parser thread can work on them.
+//
+// A JSON file may have a binary embedding sidecar (docs.json + docs.npy or
+// docs.f32, see embedding_file.h); its documents then carry no
+// metadata.embedding.
 class VectorStoreLoader {
 public:
     // Load all JSON files from a directory into the vector store
     // Automatically calls finalize() when complete
+    static void load(VectorStore* store, const std::string& path, const LoaderOptions& options = {});
+
+    // load() with Io::Read
     static void loadDirectory(VectorStore* store, const std::string& path);
-    
-    // Memory-mapped version for better performance with large files
-    // Uses zero-copy I/O via mmap/MapViewOfFile
+
+    // load() with Io::MMap
     static void loadDirectoryMMap(VectorStore* store, const std::string& path);
-    
-    // Adaptive loader that chooses the best method per file
-    // Uses mmap for files <5MB, standard loading for larger files
+
+    // load() with Io::Adaptive
     static void loadDirectoryAdaptive(VectorStore* store, const std::string& path);
-};
\ No newline at end of file
+
+    // Add the documents in a buffer: a JSON array of documents, or NDJSON (one
+    // document per line). The documents are cut into chunks that
+    // `parse_threads` threads (the caller's included) each parse with one
+    // simdjson iterate_many stream. Works in both phases and, unlike load(),
+    // does not finalize. Only parse_threads is read from `options`.
+    static BufferLoadResult addBuffer(VectorStore* store, const char* data, size_t size,
+                                      const LoaderOptions& options = {});
+};
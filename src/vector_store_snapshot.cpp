@@ -0,0 +1,565 @@
+#include "vector_store.h"
+#include "snapshot_format.h"
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Upper bound on a saved graph's M, so the section size checks cannot overflow
+constexpr uint64_t HNSW_MAX_M = uint64_t(1) << 16;
+
+// Write zero bytes until the file position reaches `offset`
+bool pad_to(std::FILE* file, size_t& pos, size_t offset) {
+    static const char zeros[snapshot::ALIGNMENT] = {};
+    while (pos < offset) {
+        size_t chunk = std::min(offset - pos, sizeof(zeros));
+        if (std::fwrite(zeros, 1, chunk, file) != chunk) return false;
+        pos += chunk;
+    }
+    return true;
+}
+
+bool write_bytes(std::FILE* file, size_t& pos, const void* data, size_t size) {
+    if (size && std::fwrite(data, 1, size, file) != size) return false;
+    pos += size;
+    return true;
+}
+
+// Create a temporary file next to `path` that no other writer can share:
+// named after this process and a per-process counter, and opened exclusively,
+// so concurrent saves to one path (e.g. every cluster worker publishing the
+// same name) never interleave their writes
+std::FILE* create_temp_file(const std::string& path, std::string& tmp_path) {
+    static std::atomic<uint64_t> counter{0};
+    #ifdef _WIN32
+    const long pid = _getpid();
+    #else
+    const long pid = static_cast<long>(getpid());
+    #endif
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        tmp_path = path + ".tmp." + std::to_string(pid) + "." + std::to_string(counter.fetch_add(1));
+        if (std::FILE* file = std::fopen(tmp_path.c_str(), "wbx")) return file;
+        if (errno != EEXIST) break;  // Left over by a crashed writer with a recycled pid: try the next name
+    }
+    return nullptr;
+}
+
+const snapshot::Section* find_section(const snapshot::Section* sections, uint32_t count,
+                                      uint32_t type) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (sections[i].type == type) return &sections[i];
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+simdjson::error_code VectorStore::save(const std::string& path) const {
+    // Only finalized (normalized) data is persisted
+    if (!is_finalized()) {
+        return simdjson::INCORRECT_TYPE;
+    }
+
+    // Keep compact() from swapping the segment out while it is written
+    std::shared_lock<std::shared_mutex> lock(search_mutex_);
+    const Segment& segment = *main_;
+    const size_t total = size();
+
+    // Removed documents are dropped and the rest renumbered densely:
+    // document j of the snapshot is entry saved[j]
+    std::vector<uint32_t> saved;
+    saved.reserve(total);
+    for (size_t i = 0; i < total; ++i) {
+        if (!is_removed(i)) saved.push_back(static_cast<uint32_t>(i));
+    }
+    const size_t n = saved.size();
+    const size_t emb_size = n * stride_ * sizeof(float);
+
+    // When the main segment holds exactly the saved documents, its matrix,
+    // codes and index are written as they are. With a pending delta or
+    // removed rows, embeddings are streamed in document order instead and
+    // open_snapshot() rebuilds the rest.
+    const bool whole = total == segment.end && segment.rows == n;
+    std::vector<uint32_t> row_ids;
+    if (whole && segment.row_ids && n != total) {
+        std::vector<uint32_t> rank(total);
+        for (size_t j = 0; j < n; ++j) rank[saved[j]] = static_cast<uint32_t>(j);
+        row_ids.resize(n);
+        for (size_t r = 0; r < n; ++r) row_ids[r] = rank[segment.row_ids[r]];
+    }
+
+    // Build the document table and lay out the string section
+    std::vector<snapshot::DocRecord> records(n);
+    size_t strings_size = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const Document& doc = entries_[saved[i]].doc;
+        records[i].id_offset = strings_size;
+        records[i].id_size = doc.id.size();
+        strings_size += doc.id.size() + 1;
+        records[i].text_offset = strings_size;
+        records[i].text_size = doc.text.size();
+        strings_size += doc.text.size() + 1;
+        records[i].meta_offset = strings_size;
+        records[i].meta_size = doc.metadata_json.size();
+        strings_size += doc.metadata_json.size() + 1;
+    }
+
+    // Section payloads in file order. The string section (and the embeddings,
+    // unless `whole`) has no contiguous source buffer and is streamed.
+    struct Payload {
+        uint32_t type;
+        const void* data;
+        size_t size;
+    };
+    std::vector<Payload> payloads = {
+        {snapshot::SECTION_EMBEDDINGS, whole ? segment.matrix : nullptr, emb_size},
+        {snapshot::SECTION_DOCUMENTS, records.data(), n * sizeof(snapshot::DocRecord)},
+        {snapshot::SECTION_STRINGS, nullptr, strings_size},
+    };
+    switch (whole ? segment.quantizer.type() : Quantization::None) {
+        case Quantization::Int8:
+            payloads.push_back({snapshot::SECTION_INT8_CODES, segment.quantizer.codes(),
+                                segment.quantizer.code_bytes()});
+            payloads.push_back({snapshot::SECTION_INT8_SCALES, segment.quantizer.scales(),
+                                dim_ * sizeof(float)});
+            break;
+        case Quantization::Fp16:
+            payloads.push_back({snapshot::SECTION_FP16_CODES, segment.quantizer.codes(),
+                                segment.quantizer.code_bytes()});
+            break;
+        case Quantization::None:
+        case Quantization::PQ:  // Not a scalar quantizer type; PQ sections follow
+            break;
+    }
+    snapshot::PqRecord pq_record = {};
+    if (whole && !segment.pq.empty()) {
+        pq_record.m = segment.pq.m();
+        pq_record.bits = segment.pq.bits();
+        payloads.push_back({snapshot::SECTION_PQ_META, &pq_record, sizeof(pq_record)});
+        payloads.push_back({snapshot::SECTION_PQ_CODEBOOKS, segment.pq.codebooks(), segment.pq.codebook_bytes()});
+        payloads.push_back({snapshot::SECTION_PQ_CODES, segment.pq.codes(), segment.pq.code_bytes()});
+    }
+    if (whole && segment.row_ids) {
+        payloads.push_back({snapshot::SECTION_ROW_IDS, row_ids.empty() ? segment.row_ids : row_ids.data(),
+                            n * sizeof(uint32_t)});
+    }
+    if (whole && !segment.ivf.empty()) {
+        payloads.push_back({snapshot::SECTION_IVF_CENTROIDS, segment.ivf.centroids(),
+                            segment.ivf.nlist() * stride_ * sizeof(float)});
+        payloads.push_back({snapshot::SECTION_IVF_LISTS, segment.ivf.list_offsets(),
+                            (segment.ivf.nlist() + 1) * sizeof(uint64_t)});
+    }
+    snapshot::HnswRecord hnsw_record = {};
+    if (whole && !segment.hnsw.empty()) {
+        hnsw_record.M = segment.hnsw.M();
+        hnsw_record.entry_point = segment.hnsw.entry_point();
+        hnsw_record.max_level = segment.hnsw.max_level();
+        payloads.push_back({snapshot::SECTION_HNSW_META, &hnsw_record, sizeof(hnsw_record)});
+        payloads.push_back({snapshot::SECTION_HNSW_LEVEL0, segment.hnsw.level0(),
+                            segment.hnsw.level0_size() * sizeof(uint32_t)});
+        payloads.push_back({snapshot::SECTION_HNSW_UPPER_OFFSETS, segment.hnsw.upper_offsets(),
+                            (n + 1) * sizeof(uint64_t)});
+        payloads.push_back({snapshot::SECTION_HNSW_UPPER, segment.hnsw.upper(),
+                            segment.hnsw.upper_size() * sizeof(uint32_t)});
+    }
+
+    const uint32_t section_count = static_cast<uint32_t>(payloads.size());
+    std::vector<snapshot::Section> sections(section_count);
+    size_t offset = sizeof(snapshot::Header) + section_count * sizeof(snapshot::Section);
+    for (uint32_t i = 0; i < section_count; ++i) {
+        sections[i] = {payloads[i].type, 0, snapshot::align_up(offset), payloads[i].size};
+        offset = sections[i].offset + sections[i].size;
+    }
+
+    snapshot::Header header;
+    std::memcpy(header.magic, snapshot::MAGIC, sizeof(header.magic));
+    header.version = snapshot::VERSION;
+    header.section_count = section_count;
+    header.dim = dim_;
+    header.stride = stride_;
+    header.count = n;
+    header.file_size = offset;
+
+    // Write to a temporary file and rename, so readers never map a partial snapshot
+    std::string tmp_path;
+    std::FILE* file = create_temp_file(path, tmp_path);
+    if (!file) {
+        return simdjson::IO_ERROR;
+    }
+
+    size_t pos = 0;
+    bool ok = write_bytes(file, pos, &header, sizeof(header)) &&
+              write_bytes(file, pos, sections.data(), section_count * sizeof(snapshot::Section));
+
+    // The matrix and code arrays are already contiguous and padded: one write each
+    for (uint32_t s = 0; ok && s < section_count; ++s) {
+        ok = pad_to(file, pos, sections[s].offset);
+        if (payloads[s].data) {
+            ok = ok && write_bytes(file, pos, payloads[s].data, payloads[s].size);
+            continue;
+        }
+
+        if (payloads[s].type == snapshot::SECTION_EMBEDDINGS) {
+            for (size_t i = 0; ok && i < n; ++i) {
+                ok = write_bytes(file, pos, entries_[saved[i]].embedding, stride_ * sizeof(float));
+            }
+            continue;
+        }
+
+        // Arena strings are null-terminated, so the terminator is written with them
+        for (size_t i = 0; ok && i < n; ++i) {
+            const Document& doc = entries_[saved[i]].doc;
+            ok = write_bytes(file, pos, doc.id.data(), doc.id.size() + 1) &&
+                 write_bytes(file, pos, doc.text.data(), doc.text.size() + 1) &&
+                 write_bytes(file, pos, doc.metadata_json.data(), doc.metadata_json.size() + 1);
+        }
+    }
+
+    ok = (std::fclose(file) == 0) && ok;
+
+    std::error_code ec;
+    if (ok) {
+        std::filesystem::rename(tmp_path, path, ec);
+    }
+    if (!ok || ec) {
+        std::filesystem::remove(tmp_path, ec);
+        return simdjson::IO_ERROR;
+    }
+
+    return simdjson::SUCCESS;
+}
+
+simdjson::error_code VectorStore::open_snapshot(const std::string& path) {
+    return map_snapshot(path, false);
+}
+
+std::string VectorStore::shared_path(const std::string& name) {
+    if (name.empty() || name == "." || name == ".." ||
+        name.find_first_of("/\\:") != std::string::npos) {
+        return std::string();
+    }
+    std::error_code ec;
+    std::filesystem::path dir = "/dev/shm";
+    if (!std::filesystem::is_directory(dir, ec)) {
+        dir = std::filesystem::temp_directory_path(ec);
+        if (ec) return std::string();
+    }
+    return (dir / ("nvs-" + name + ".nvs")).string();
+}
+
+simdjson::error_code VectorStore::publish(const std::string& name) const {
+    std::string path = shared_path(name);
+    if (path.empty()) {
+        return simdjson::INCORRECT_TYPE;
+    }
+    return save(path);
+}
+
+simdjson::error_code VectorStore::attach(const std::string& name) {
+    std::string path = shared_path(name);
+    if (path.empty()) {
+        return simdjson::INCORRECT_TYPE;
+    }
+    return map_snapshot(path, true);
+}
+
+simdjson::error_code VectorStore::unpublish(const std::string& name) {
+    std::string path = shared_path(name);
+    if (path.empty()) {
+        return simdjson::INCORRECT_TYPE;
+    }
+    std::error_code ec;
+    if (!std::filesystem::remove(path, ec) || ec) {
+        return simdjson::IO_ERROR;
+    }
+    return simdjson::SUCCESS;
+}
+
+simdjson::error_code VectorStore::map_snapshot(const std::string& path, bool shared) {
+    // Snapshots can only be opened into an empty store
+    if (is_finalized() || size() != 0) {
+        return simdjson::INCORRECT_TYPE;
+    }
+
+    auto file = std::make_unique<MMapFile>();
+    if (!file->open(path, shared)) {
+        return simdjson::IO_ERROR;
+    }
+
+    const char* base = file->data();
+    const size_t file_size = file->size();
+    if (!base || file_size < sizeof(snapshot::Header)) {
+        return simdjson::IO_ERROR;
+    }
+
+    snapshot::Header header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, snapshot::MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != snapshot::VERSION ||
+        header.file_size != file_size) {
+        return simdjson::IO_ERROR;
+    }
+
+    if (header.dim != dim_) {
+        return simdjson::INCORRECT_TYPE;  // Dimension mismatch
+    }
+    if (header.stride != stride_) {
+        return simdjson::IO_ERROR;  // Written with a different row padding
+    }
+
+    const size_t n = header.count;
+    if (n > capacity_) {
+        return simdjson::CAPACITY;
+    }
+
+    // Validate the section table before trusting any offsets
+    size_t table_end = sizeof(snapshot::Header) +
+                       size_t(header.section_count) * sizeof(snapshot::Section);
+    if (table_end > file_size) {
+        return simdjson::IO_ERROR;
+    }
+    auto* sections = reinterpret_cast<const snapshot::Section*>(base + sizeof(snapshot::Header));
+    for (uint32_t i = 0; i < header.section_count; ++i) {
+        if (sections[i].offset % snapshot::ALIGNMENT != 0 ||
+            sections[i].offset > file_size ||
+            sections[i].size > file_size - sections[i].offset) {
+            return simdjson::IO_ERROR;
+        }
+    }
+
+    auto* emb = find_section(sections, header.section_count, snapshot::SECTION_EMBEDDINGS);
+    auto* docs = find_section(sections, header.section_count, snapshot::SECTION_DOCUMENTS);
+    auto* strings = find_section(sections, header.section_count, snapshot::SECTION_STRINGS);
+    if (!emb || !docs || !strings ||
+        emb->size != n * stride_ * sizeof(float) ||
+        docs->size != n * sizeof(snapshot::DocRecord)) {
+        return simdjson::IO_ERROR;
+    }
+
+    // Rows and strings are used in place. The mapping is read-only, which is
+    // fine: embeddings are never written once the store is finalized.
+    float* emb_base = reinterpret_cast<float*>(const_cast<char*>(base + emb->offset));
+    auto* records = reinterpret_cast<const snapshot::DocRecord*>(base + docs->offset);
+    const char* str_base = base + strings->offset;
+
+    auto in_strings = [&](uint64_t off, uint64_t len) {
+        return off < strings->size && len < strings->size - off;  // +1 for terminator
+    };
+
+    for (size_t i = 0; i < n; ++i) {
+        const snapshot::DocRecord& rec = records[i];
+        if (!in_strings(rec.id_offset, rec.id_size) ||
+            !in_strings(rec.text_offset, rec.text_size) ||
+            !in_strings(rec.meta_offset, rec.meta_size)) {
+            return simdjson::IO_ERROR;
+        }
+    }
+
+    // Everything below points into `file`, which is unmapped on any failed
+    // return: the segment is built aside and only replaces main_ on success
+    auto built = std::make_unique<Segment>();
+    Segment& segment = *built;
+    segment.rows = n;
+    segment.end = n;
+    segment.dead = std::make_unique<std::atomic<uint64_t>[]>(n / 64 + 1);
+
+    // Rows saved in IVF list order carry their entry mapping
+    if (auto* row_ids = find_section(sections, header.section_count, snapshot::SECTION_ROW_IDS)) {
+        if (row_ids->size != n * sizeof(uint32_t)) return simdjson::IO_ERROR;
+        auto* ids = reinterpret_cast<const uint32_t*>(base + row_ids->offset);
+        std::vector<bool> seen(n, false);
+        for (size_t r = 0; r < n; ++r) {
+            if (ids[r] >= n || seen[ids[r]]) return simdjson::IO_ERROR;  // Not a permutation
+            seen[ids[r]] = true;
+        }
+        segment.row_ids = ids;
+    }
+
+    // Rows the search structures are built on; replaced by an owned copy if
+    // IVF has to be trained here (the mapping is read-only)
+    const float* rows = emb_base;
+    bool reordered = false;
+
+    if (options_.index == IndexType::IVF && n >= std::max<size_t>(options_.min_index_size, 1)) {
+        auto* centroids = find_section(sections, header.section_count, snapshot::SECTION_IVF_CENTROIDS);
+        auto* lists = find_section(sections, header.section_count, snapshot::SECTION_IVF_LISTS);
+
+        if (centroids && lists && segment.row_ids) {
+            size_t nlist = lists->size / sizeof(uint64_t) - 1;
+            auto* offsets = reinterpret_cast<const uint64_t*>(base + lists->offset);
+            if (lists->size < 2 * sizeof(uint64_t) ||
+                lists->size != (nlist + 1) * sizeof(uint64_t) ||
+                centroids->size != nlist * stride_ * sizeof(float) ||
+                offsets[0] != 0 || offsets[nlist] != n) {
+                return simdjson::IO_ERROR;
+            }
+            for (size_t l = 0; l < nlist; ++l) {
+                if (offsets[l] > offsets[l + 1]) return simdjson::IO_ERROR;
+            }
+            segment.ivf.attach(reinterpret_cast<const float*>(base + centroids->offset), offsets, nlist,
+                        dim_, stride_, dot_);
+        } else if (shared) {
+            return simdjson::INCORRECT_TYPE;  // Published without its IVF lists
+        } else {
+            if (!allocate_matrix(segment, n) ||
+                !segment.row_ids_storage.allocate(n) ||
+                !segment.ivf.allocate(n, dim_, stride_, options_.ivf)) {
+                return simdjson::MEMALLOC;
+            }
+            std::memcpy(segment.matrix_storage.data(), emb_base, n * stride_ * sizeof(float));
+            build_ivf(segment);
+            rows = segment.matrix_storage.data();
+            reordered = true;
+        }
+    }
+
+    // Codes are only trusted when they match the configured quantization
+    if (options_.quantization == Quantization::PQ) {
+        auto* meta = find_section(sections, header.section_count, snapshot::SECTION_PQ_META);
+        auto* codebooks = find_section(sections, header.section_count, snapshot::SECTION_PQ_CODEBOOKS);
+        auto* codes = find_section(sections, header.section_count, snapshot::SECTION_PQ_CODES);
+        snapshot::PqRecord record = {};
+        if (meta) {
+            if (meta->size != sizeof(record)) return simdjson::IO_ERROR;
+            std::memcpy(&record, base + meta->offset, sizeof(record));
+        }
+        const size_t m = ProductQuantizer::resolve_m(dim_, options_.pq);
+        const size_t bits = ProductQuantizer::resolve_bits(options_.pq);
+
+        if (meta && codebooks && codes && !reordered && record.m == m && record.bits == bits) {
+            if (codebooks->size != ProductQuantizer::codebook_bytes(m, bits, dim_) ||
+                codes->size != ProductQuantizer::code_bytes(m, bits, n)) {
+                return simdjson::IO_ERROR;
+            }
+            segment.pq.attach(m, bits, reinterpret_cast<const float*>(base + codebooks->offset),
+                              reinterpret_cast<const uint8_t*>(base + codes->offset), n, dim_);
+        } else if (shared) {
+            return simdjson::INCORRECT_TYPE;  // Published without these codes
+        } else {
+            // Saved without PQ codes, with other parameters, or rows reordered: train now
+            if (!segment.pq.allocate(n, dim_, options_.pq)) {
+                return simdjson::MEMALLOC;
+            }
+            segment.pq.train(rows, stride_);
+        }
+    } else if (options_.quantization != Quantization::None) {
+        const size_t code_size = n * stride_ * ScalarQuantizer::element_size(options_.quantization);
+        const snapshot::Section* codes = nullptr;
+        const snapshot::Section* scales = nullptr;
+        if (options_.quantization == Quantization::Int8) {
+            codes = find_section(sections, header.section_count, snapshot::SECTION_INT8_CODES);
+            scales = find_section(sections, header.section_count, snapshot::SECTION_INT8_SCALES);
+            if (scales && scales->size != dim_ * sizeof(float)) return simdjson::IO_ERROR;
+        } else {
+            codes = find_section(sections, header.section_count, snapshot::SECTION_FP16_CODES);
+        }
+        if (codes && codes->size != code_size) return simdjson::IO_ERROR;
+
+        if (codes && !reordered && (scales || options_.quantization == Quantization::Fp16)) {
+            segment.quantizer.attach(options_.quantization, base + codes->offset,
+                              scales ? reinterpret_cast<const float*>(base + scales->offset) : nullptr,
+                              n, dim_, stride_);
+        } else if (shared) {
+            return simdjson::INCORRECT_TYPE;  // Published without these codes
+        } else {
+            // Snapshot saved without these codes (or rows reordered): encode now
+            if (!segment.quantizer.allocate(options_.quantization, n, dim_, stride_)) {
+                return simdjson::MEMALLOC;
+            }
+            segment.quantizer.encode(rows);
+        }
+    }
+
+    // Map the saved graph when present, otherwise build one if configured
+    if (options_.index == IndexType::HNSW && n >= std::max<size_t>(options_.min_index_size, 1)) {
+        auto* meta = find_section(sections, header.section_count, snapshot::SECTION_HNSW_META);
+        auto* level0 = find_section(sections, header.section_count, snapshot::SECTION_HNSW_LEVEL0);
+        auto* offsets = find_section(sections, header.section_count, snapshot::SECTION_HNSW_UPPER_OFFSETS);
+        auto* upper = find_section(sections, header.section_count, snapshot::SECTION_HNSW_UPPER);
+
+        if (meta && level0 && offsets && upper && !reordered) {
+            snapshot::HnswRecord record;
+            if (meta->size != sizeof(record)) return simdjson::IO_ERROR;
+            std::memcpy(&record, base + meta->offset, sizeof(record));
+
+            // Links are followed without bounds checks by every search (in
+            // every process attached to a shared store): check them all first
+            auto* upper_offsets = reinterpret_cast<const uint64_t*>(base + offsets->offset);
+            auto* links0 = reinterpret_cast<const uint32_t*>(base + level0->offset);
+            auto* links = reinterpret_cast<const uint32_t*>(base + upper->offset);
+            if (record.M < 2 || record.M > HNSW_MAX_M ||
+                level0->size != n * (1 + 2 * record.M) * sizeof(uint32_t) ||
+                offsets->size != (n + 1) * sizeof(uint64_t) ||
+                upper->size % sizeof(uint32_t) != 0 ||
+                !HnswIndex::validate(n, record.M, record.entry_point, record.max_level, links0,
+                                     upper_offsets, links, upper->size / sizeof(uint32_t))) {
+                return simdjson::IO_ERROR;
+            }
+            segment.hnsw.attach(rows, n, dim_, stride_, dot_, record.M,
+                         static_cast<uint32_t>(record.entry_point),
+                         static_cast<uint32_t>(record.max_level),
+                         links0, upper_offsets, links);
+
+            // Searches hop between link blocks: readahead would only evict scanned rows
+            for (auto* section : {level0, offsets, upper}) {
+                file->advise_random(section->offset, section->size);
+            }
+        } else if (shared) {
+            return simdjson::INCORRECT_TYPE;  // Published without its graph
+        } else {
+            if (!segment.hnsw.allocate(n, options_.hnsw)) {
+                return simdjson::MEMALLOC;
+            }
+            segment.hnsw.build(rows, dim_, stride_, dot_);
+        }
+    }
+
+    // Every section checked out: point entries straight into the mapping.
+    // Entries filled so far are cleared again if indexing them fails.
+    size_t filled = 0;
+    auto fail = [&](simdjson::error_code error) {
+        for (size_t i = 0; i < filled; ++i) entries_[i] = Entry();
+        return error;
+    };
+    for (; filled < n; ++filled) {
+        if (!ensure_slot(filled)) {
+            return fail(simdjson::MEMALLOC);
+        }
+        const snapshot::DocRecord& rec = records[filled];
+        Entry& entry = entries_[filled];
+        entry.doc.id = std::string_view(str_base + rec.id_offset, rec.id_size);
+        entry.doc.text = std::string_view(str_base + rec.text_offset, rec.text_size);
+        entry.doc.metadata_json = std::string_view(str_base + rec.meta_offset, rec.meta_size);
+    }
+
+    // Filter columns are not saved: rebuild them from the metadata strings
+    auto error = index_filter_fields(n);
+    if (error) return fail(error);
+
+    // Neither is the text index: tokenize the saved text again
+    error = index_text_terms(n);
+    if (error) return fail(error);
+    if (options_.text_index &&
+        !segment.text.build(n, [&](size_t i) { return doc_terms_[i]; }, options_.bm25)) {
+        return fail(simdjson::MEMALLOC);
+    }
+
+    segment.matrix = rows;
+    point_entries(segment);
+    main_ = std::move(built);
+    snapshot_ = std::move(file);
+    delta_first_ = n;
+    count_.store(n, std::memory_order_release);
+    build_id_index(n);
+
+    // Snapshot data is already normalized - go straight to serving phase
+    is_finalized_.store(true, std::memory_order_seq_cst);
+
+    return simdjson::SUCCESS;
+}
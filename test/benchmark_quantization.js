@@ -0,0 +1,63 @@
+const { VectorStore } = require('../index');
+
+// Compares quantized scans (with exact re-ranking) against the float baseline:
+// recall@k relative to exact search and average query latency.
+const dim = 768;
+const numDocs = 20000;
+const numQueries = 100;
+const k = 10;
+
+function randomVector(dim) {
+    const v = new Array(dim);
+    for (let i = 0; i < dim; i++) {
+        v[i] = Math.random() * 2 - 1;
+    }
+    return v;
+}
+
+function buildStore(options, embeddings) {
+    const store = new VectorStore(dim, options);
+    embeddings.forEach((embedding, i) => {
+        store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding } });
+    });
+    store.finalize();
+    return store;
+}
+
+function runQueries(store, queries) {
+    const start = process.hrtime.bigint();
+    const results = queries.map(q => store.search(q, k));
+    const elapsed = Number(process.hrtime.bigint() - start) / 1e6;
+    return { results, avgMs: elapsed / queries.length };
+}
+
+console.log('🗜️  Native Vector Store Quantization Benchmark');
+console.log('=============================================\n');
+console.log(`📊 ${numDocs} documents, dim ${dim}, ${numQueries} queries, k=${k}\n`);
+
+const embeddings = Array.from({ length: numDocs }, () => randomVector(dim));
+const queries = Array.from({ length: numQueries }, () => new Float32Array(randomVector(dim)));
+
+const exact = buildStore({ quantization: 'none' }, embeddings);
+const baseline = runQueries(exact, queries);
+console.log(`none:  ${baseline.avgMs.toFixed(2)}ms/query (reference)`);
+
+const configs = [
+    { quantization: 'fp16' },
+    { quantization: 'int8' },
+    { quantization: 'int8', rerankOversample: 0 },
+];
+
+for (const options of configs) {
+    const store = buildStore(options, embeddings);
+    const { results, avgMs } = runQueries(store, queries);
+
+    let hits = 0;
+    results.forEach((approx, q) => {
+        const truth = new Set(baseline.results[q].map(r => r.id));
+        hits += approx.filter(r => truth.has(r.id)).length;
+    });
+
+    const label = options.rerankOversample === 0 ? `${options.quantization} (no re-rank)` : options.quantization;
+    console.log(`${label}:  ${avgMs.toFixed(2)}ms/query, recall@${k} ${(hits / (numQueries * k)).toFixed(3)}`);
+}
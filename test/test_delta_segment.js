@@ -0,0 +1,53 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing inserts after finalize and compaction');
+console.log('===============================================\n');
+
+const dim = 32;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+
+async function main() {
+    const store = new VectorStore(dim, { index: 'hnsw', minIndexSize: 100, deltaCompactRows: 0 });
+    for (let i = 0; i < 500; i++) {
+        store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding: randomEmbedding() } });
+    }
+    store.finalize();
+
+    const late = [];
+    for (let i = 0; i < 200; i++) {
+        const embedding = randomEmbedding();
+        late.push(embedding);
+        store.addDocument({ id: `late-${i}`, text: `Late ${i}`, metadata: { embedding } });
+    }
+    if (store.size() !== 700 || store.deltaSize() !== 200) {
+        throw new Error(`Expected 700 documents with 200 pending, got ${store.size()} / ${store.deltaSize()}`);
+    }
+
+    const check = (label) => {
+        late.forEach((embedding, i) => {
+            const [top] = store.search(new Float32Array(embedding), 1, { exact: true });
+            if (top.id !== `late-${i}`) {
+                throw new Error(`${label}: late-${i} not found, got ${top.id}`);
+            }
+        });
+    };
+    check('delta');
+    console.log('✅ 200 documents searchable before compaction');
+
+    // Searches keep working while the merge runs
+    const pending = store.compact();
+    store.search(new Float32Array(late[0]), 5);
+    await pending;
+    if (store.deltaSize() !== 0) {
+        throw new Error(`Delta not merged: ${store.deltaSize()} pending`);
+    }
+    check('compacted');
+    console.log('✅ Delta merged into the main segment');
+
+    console.log('\n✅ Delta segment tests passed');
+}
+
+main().catch((err) => {
+    console.error('❌', err);
+    process.exit(1);
+});
@@ -0,0 +1,44 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing finalize() progress reporting');
+console.log('=======================================\n');
+
+const dim = 32;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+
+const store = new VectorStore(dim, { index: 'hnsw', quantization: 'int8', minIndexSize: 100 });
+for (let i = 0; i < 2000; i++) {
+    store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding: randomEmbedding() } });
+}
+
+const events = [];
+store.finalize((stage, done, total) => events.push({ stage, done, total }));
+
+const stages = events.map((e) => e.stage).filter((stage, i, all) => i === 0 || all[i - 1] !== stage);
+if (stages.join(',') !== 'compact,quantize,index,done') {
+    throw new Error(`Unexpected stage order: ${stages.join(',')}`);
+}
+const last = events[events.length - 1];
+if (last.done !== 2000 || last.total !== 2000) {
+    throw new Error(`Expected done 2000/2000, got ${last.done}/${last.total}`);
+}
+if (!store.isFinalized()) {
+    throw new Error('Store should be finalized');
+}
+console.log(`✅ ${events.length} progress events: ${stages.join(' → ')}`);
+
+// An exception from the callback propagates out of finalize()
+const failing = new VectorStore(dim);
+failing.addDocument({ id: 'a', text: 'A', metadata: { embedding: randomEmbedding() } });
+let threw = false;
+try {
+    failing.finalize(() => { throw new Error('stop'); });
+} catch (e) {
+    threw = e.message === 'stop';
+}
+if (!threw) {
+    throw new Error('Callback exception was not rethrown');
+}
+console.log('✅ Callback exceptions are rethrown');
+
+console.log('\n✅ All finalize progress tests passed!');
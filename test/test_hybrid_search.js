@@ -0,0 +1,89 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing BM25 text search and hybrid search');
+console.log('============================================\n');
+
+const dim = 32;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+const topics = ['vector', 'parser', 'arena', 'openmp', 'snapshot'];
+
+async function main() {
+    const store = new VectorStore(dim, { textIndex: true, filterFields: ['tenant'], minIndexSize: 100 });
+    const embeddings = [];
+    for (let i = 0; i < 2000; i++) {
+        embeddings.push(randomEmbedding());
+        store.addDocument({
+            id: `doc-${i}`,
+            text: `Notes on ${topics[i % 5]} number ${i}, see add_document and ${topics[(i * 3) % 5]}`,
+            metadata: { tenant: i % 2 ? 'acme' : 'globex', embedding: embeddings[i] }
+        });
+    }
+    store.finalize();
+    store.addDocument({
+        id: 'late',
+        text: 'Zebra crossing: a rare word only this late document has',
+        metadata: { tenant: 'acme', embedding: randomEmbedding() }
+    });
+
+    // Text search: every hit holds a query word, case does not matter
+    const hits = store.textSearch('OpenMP arena', 10);
+    if (hits.length !== 10) {
+        throw new Error(`expected 10 text hits, got ${hits.length}`);
+    }
+    for (const r of hits) {
+        if (!/openmp|arena/.test(r.text)) {
+            throw new Error(`${r.id} holds no query word`);
+        }
+    }
+    for (let i = 1; i < hits.length; i++) {
+        if (hits[i - 1].score < hits[i].score) throw new Error('text hits are not sorted');
+    }
+    if (store.textSearch('zebra', 5)[0]?.id !== 'late') {
+        throw new Error('documents added after finalize() should be text searchable');
+    }
+    if (store.textSearch('add_document', 5).length !== 5) {
+        throw new Error('identifiers should stay one token');
+    }
+    const filtered = store.textSearch('snapshot', 10, { filter: { tenant: 'globex' } });
+    if (filtered.length !== 10 || filtered.some((r) => JSON.parse(r.metadata_json).tenant !== 'globex')) {
+        throw new Error('filtered text search returned a non-matching document');
+    }
+    console.log('✅ textSearch');
+
+    // Hybrid: a document's own embedding and text put it first
+    const query = new Float32Array(embeddings[42]);
+    const own = store.hybridSearch(query, 'parser number 42', 5);
+    if (own[0].id !== 'doc-42') {
+        throw new Error(`expected doc-42 first, got ${own[0].id}`);
+    }
+    const vectorOnly = store.hybridSearch(query, 'parser', 10, 1);
+    const search = store.search(query, 10);
+    if (vectorOnly.map((r) => r.id).join() !== search.map((r) => r.id).join()) {
+        throw new Error('alpha = 1 should rank like search()');
+    }
+    let threw = false;
+    try {
+        store.hybridSearch(query, 'parser', 5, 2);
+    } catch (e) {
+        threw = true;
+    }
+    if (!threw) {
+        throw new Error('alpha outside [0, 1] should throw');
+    }
+    console.log('✅ hybridSearch');
+
+    // Without textIndex there is nothing to search
+    const plain = new VectorStore(dim);
+    plain.addDocument({ id: 'a', text: 'parser', metadata: { embedding: randomEmbedding() } });
+    plain.finalize();
+    if (plain.textSearch('parser', 5).length !== 0) {
+        throw new Error('textSearch without textIndex should return nothing');
+    }
+
+    console.log('\n✅ All hybrid search tests passed');
+}
+
+main().catch((err) => {
+    console.error('❌', err);
+    process.exit(1);
+});
@@ -0,0 +1,57 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing searchLean and lazy accessors');
+console.log('=======================================\n');
+
+const dim = 32;
+const store = new VectorStore(dim);
+for (let i = 0; i < 1000; i++) {
+    const embedding = Array.from({ length: dim }, () => Math.random() * 2 - 1);
+    store.addDocument({
+        id: `doc-${i}`,
+        text: `Document ${i}`,
+        metadata: { embedding, category: `cat-${i % 7}` }
+    });
+}
+store.finalize();
+
+const query = new Float32Array(Array.from({ length: dim }, () => Math.random() * 2 - 1));
+const full = store.search(query, 50);
+const lean = store.searchLean(query, 50);
+
+if (!(lean.scores instanceof Float32Array) || !(lean.indices instanceof Uint32Array)) {
+    throw new Error('searchLean must return typed arrays');
+}
+if (lean.scores.length !== full.length || lean.indices.length !== full.length) {
+    throw new Error(`Expected ${full.length} lean results, got ${lean.scores.length}`);
+}
+
+full.forEach((r, i) => {
+    if (Math.abs(lean.scores[i] - r.score) > 1e-6) {
+        throw new Error(`Score ${i} differs: ${lean.scores[i]} vs ${r.score}`);
+    }
+    const idx = lean.indices[i];
+    if (store.getId(idx) !== r.id || store.getText(idx) !== r.text || store.getMetadata(idx) !== r.metadata_json) {
+        throw new Error(`Accessors for hit ${i} do not match search()`);
+    }
+});
+console.log(`✅ ${lean.scores.length} lean results match search()`);
+
+const metadata = JSON.parse(full[0].metadata_json);
+if ('embedding' in metadata || !metadata.category.startsWith('cat-')) {
+    throw new Error(`Unexpected metadata: ${full[0].metadata_json}`);
+}
+console.log('✅ Metadata keeps its fields without the embedding');
+
+let threw = false;
+try {
+    store.getText(store.size());
+} catch (e) {
+    threw = e instanceof RangeError;
+}
+if (!threw) {
+    throw new Error('Out-of-range index was not rejected');
+}
+console.log('✅ Out-of-range index rejected');
+
+console.log('\n✅ Lean result tests passed');
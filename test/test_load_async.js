@@ -0,0 +1,68 @@
+const { VectorStore } = require('../index');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+console.log('🧪 Testing loadDirAsync');
+console.log('=======================\n');
+
+async function main() {
+    const dim = 16;
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'vector-store-load-'));
+    const docs = Array.from({ length: 500 }, (_, i) => ({
+        id: `doc-${i}`,
+        text: `Document ${i}`,
+        metadata: { embedding: Array.from({ length: dim }, () => Math.random() * 2 - 1) }
+    }));
+    for (let f = 0; f < 5; f++) {
+        fs.writeFileSync(path.join(dir, `docs${f}.json`), JSON.stringify(docs.slice(f * 100, (f + 1) * 100)));
+    }
+
+    try {
+        for (const method of ['adaptive', 'mmap', 'standard']) {
+            const store = new VectorStore(dim);
+            const pending = store.loadDirAsync(dir, { method });
+
+            // Mutating calls are rejected while the load runs in the background
+            let threw = false;
+            try {
+                store.addDocument(docs[0]);
+            } catch (e) {
+                threw = true;
+            }
+            if (!threw) {
+                throw new Error('addDocument was not rejected during loadDirAsync');
+            }
+
+            const count = await pending;
+            if (count !== docs.length || !store.isFinalized()) {
+                throw new Error(`${method}: loaded ${count} documents, expected ${docs.length}`);
+            }
+            const results = store.search(new Float32Array(docs[7].metadata.embedding), 1);
+            if (results[0].id !== 'doc-7') {
+                throw new Error(`${method}: self-search returned ${results[0].id}`);
+            }
+            console.log(`✅ ${method}: ${count} documents loaded`);
+        }
+
+        let threw = false;
+        try {
+            new VectorStore(dim).loadDirAsync(dir, { method: 'bogus' });
+        } catch (e) {
+            threw = true;
+        }
+        if (!threw) {
+            throw new Error('Invalid method was not rejected');
+        }
+        console.log('✅ Invalid method rejected');
+    } finally {
+        fs.rmSync(dir, { recursive: true, force: true });
+    }
+
+    console.log('\n✅ loadDirAsync tests passed');
+}
+
+main().catch(error => {
+    console.error('❌ Error:', error);
+    process.exitCode = 1;
+});
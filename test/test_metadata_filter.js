@@ -0,0 +1,65 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing metadata-filtered search');
+console.log('==================================\n');
+
+const dim = 32;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+const tenants = ['acme', 'globex', 'initech'];
+
+async function main() {
+    for (const index of ['flat', 'hnsw', 'ivf']) {
+        const store = new VectorStore(dim, { index, minIndexSize: 100, filterFields: ['tenant', 'lang', 'year'] });
+        for (let i = 0; i < 1500; i++) {
+            store.addDocument({
+                id: `doc-${i}`,
+                text: `Document ${i}`,
+                metadata: { tenant: tenants[i % 3], lang: i % 2 ? 'en' : 'de', year: 2020 + (i % 4), embedding: randomEmbedding() }
+            });
+        }
+        store.finalize();
+        store.addDocument({ id: 'late', text: 'Late', metadata: { tenant: 'acme', lang: 'en', year: 2023, embedding: randomEmbedding() } });
+
+        const query = new Float32Array(randomEmbedding());
+        const filter = { tenant: 'acme', lang: ['en'], year: [2021, 2023] };
+        const results = store.search(query, 10, { filter });
+        if (results.length !== 10) {
+            throw new Error(`${index}: expected 10 filtered results, got ${results.length}`);
+        }
+        for (const r of results) {
+            const meta = JSON.parse(r.metadata_json);
+            if (meta.tenant !== 'acme' || meta.lang !== 'en' || (meta.year !== 2021 && meta.year !== 2023)) {
+                throw new Error(`${index}: ${r.id} does not match the filter`);
+            }
+        }
+
+        const exact = store.search(query, 10, { filter, exact: true });
+        const viaAsync = await store.searchAsync(query, 10, { filter, exact: true });
+        const batch = store.searchBatch(query, 1, 10, { filter, exact: true })[0];
+        if (batch.map((r) => r.id).join() !== exact.map((r) => r.id).join()) {
+            throw new Error(`${index}: searchBatch and search disagree`);
+        }
+        if (store.search(query, 5, { filter: { tenant: 'nobody' } }).length !== 0) {
+            throw new Error(`${index}: unknown value should match nothing`);
+        }
+        let threw = false;
+        try {
+            store.search(query, 5, { filter: { colour: 'red' } });
+        } catch (e) {
+            threw = true;
+        }
+        if (!threw) {
+            throw new Error(`${index}: filtering on a field outside filterFields should throw`);
+        }
+        if (viaAsync.map((r) => r.id).join() !== exact.map((r) => r.id).join()) {
+            throw new Error(`${index}: searchAsync and search disagree`);
+        }
+        console.log(`✅ ${index}: ${results.length} hits, all matching`);
+    }
+    console.log('\n✅ All metadata filter tests passed');
+}
+
+main().catch((err) => {
+    console.error('❌', err);
+    process.exit(1);
+});
@@ -0,0 +1,46 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing remove, upsert and getById');
+console.log('=====================================\n');
+
+const dim = 32;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+
+const store = new VectorStore(dim);
+const embeddings = [];
+for (let i = 0; i < 300; i++) {
+    embeddings.push(randomEmbedding());
+    store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding: embeddings[i] } });
+}
+store.finalize();
+
+const found = store.getById('doc-7');
+if (!found || found.id !== 'doc-7' || found.text !== 'Document 7' || store.getId(found.index) !== 'doc-7') {
+    throw new Error(`getById returned ${JSON.stringify(found)}`);
+}
+if (store.getById('missing') !== null) {
+    throw new Error('getById should return null for unknown ids');
+}
+console.log('✅ getById finds documents by id');
+
+if (!store.remove('doc-7') || store.remove('doc-7')) {
+    throw new Error('remove() should succeed once');
+}
+const hits = store.search(new Float32Array(embeddings[7]), 300);
+if (hits.some((r) => r.id === 'doc-7') || store.getById('doc-7') !== null) {
+    throw new Error('Removed document is still visible');
+}
+console.log('✅ Removed document no longer returned');
+
+const replacement = randomEmbedding();
+store.upsert({ id: 'doc-8', text: 'Replaced', metadata: { embedding: replacement } });
+const [top] = store.search(new Float32Array(replacement), 1);
+if (top.id !== 'doc-8' || top.text !== 'Replaced' || store.getById('doc-8').text !== 'Replaced') {
+    throw new Error(`Upserted document not found: ${JSON.stringify(top)}`);
+}
+if (store.search(new Float32Array(embeddings[8]), 300).filter((r) => r.id === 'doc-8').length !== 1) {
+    throw new Error('Old version of an upserted document is still visible');
+}
+console.log('✅ Upsert replaces the earlier version');
+
+console.log('\n✅ Remove/upsert tests passed');
@@ -0,0 +1,50 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing Concurrent searchAsync');
+console.log('=================================\n');
+
+async function main() {
+    const dim = 32;
+    const store = new VectorStore(dim);
+    for (let i = 0; i < 2000; i++) {
+        const embedding = Array.from({ length: dim }, () => Math.random() * 2 - 1);
+        store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding } });
+    }
+    store.finalize();
+
+    const queries = Array.from({ length: 64 }, () =>
+        new Float32Array(Array.from({ length: dim }, () => Math.random() * 2 - 1)));
+
+    // Every async result must match the synchronous search
+    const start = Date.now();
+    const results = await Promise.all(queries.map(q => store.searchAsync(q, 5)));
+    console.log(`✅ ${results.length} concurrent searches resolved in ${Date.now() - start}ms`);
+
+    results.forEach((asyncResults, i) => {
+        const syncResults = store.search(queries[i], 5, { mode: 'sequential' });
+        asyncResults.forEach((r, j) => {
+            if (Math.abs(r.score - syncResults[j].score) > 1e-6) {
+                throw new Error(`Query ${i} result ${j} differs: ${r.id} vs ${syncResults[j].id}`);
+            }
+        });
+    });
+    console.log('✅ Async results match synchronous search');
+
+    let threw = false;
+    try {
+        store.search(queries[0], 5, { mode: 'bogus' });
+    } catch (e) {
+        threw = true;
+    }
+    if (!threw) {
+        throw new Error('Invalid mode was not rejected');
+    }
+    console.log('✅ Invalid mode rejected');
+
+    console.log('\n✅ searchAsync tests passed');
+}
+
+main().catch(error => {
+    console.error('❌ Error:', error);
+    process.exitCode = 1;
+});
@@ -0,0 +1,93 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing searchBatch');
+console.log('======================\n');
+
+try {
+    const dim = 64;
+    const nq = 16;
+    const k = 5;
+    const store = new VectorStore(dim);
+    for (let i = 0; i < 3000; i++) {
+        const embedding = Array.from({ length: dim }, () => Math.random() * 2 - 1);
+        store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding } });
+    }
+    store.finalize();
+
+    const queries = new Float32Array(nq * dim).map(() => Math.random() * 2 - 1);
+
+    const batchStart = process.hrtime.bigint();
+    const batched = store.searchBatch(queries, nq, k);
+    const batchMs = Number(process.hrtime.bigint() - batchStart) / 1e6;
+
+    const loopStart = process.hrtime.bigint();
+    const looped = [];
+    for (let q = 0; q < nq; q++) {
+        looped.push(store.search(queries.subarray(q * dim, (q + 1) * dim), k));
+    }
+    const loopMs = Number(process.hrtime.bigint() - loopStart) / 1e6;
+
+    if (batched.length !== nq) {
+        throw new Error(`Expected ${nq} result lists, got ${batched.length}`);
+    }
+    batched.forEach((results, q) => {
+        results.forEach((r, j) => {
+            if (Math.abs(r.score - looped[q][j].score) > 1e-5) {
+                throw new Error(`Query ${q} result ${j} differs`);
+            }
+        });
+    });
+    console.log(`✅ ${nq} batched queries match search(): ${batchMs.toFixed(2)}ms batched, ${loopMs.toFixed(2)}ms looped`);
+
+    let threw = false;
+    try {
+        store.searchBatch(new Float32Array(dim), 2, k);
+    } catch (e) {
+        threw = true;
+    }
+    if (!threw) {
+        throw new Error('Mismatched query buffer was not rejected');
+    }
+    console.log('✅ Mismatched query buffer rejected');
+
+    // Graph batches run query by query with the same options as search()
+    const hnsw = new VectorStore(dim, { index: 'hnsw', minIndexSize: 100 });
+    for (let i = 0; i < 3000; i++) {
+        const embedding = Array.from({ length: dim }, () => Math.random() * 2 - 1);
+        hnsw.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding } });
+    }
+    hnsw.finalize();
+    const options = { ef: 200, mode: 'sequential' };
+    hnsw.searchBatch(queries, nq, k, options).forEach((results, q) => {
+        const single = hnsw.search(queries.subarray(q * dim, (q + 1) * dim), k, options);
+        results.forEach((r, j) => {
+            if (r.id !== single[j].id) {
+                throw new Error(`HNSW query ${q} result ${j} differs from search() with the same options`);
+            }
+        });
+    });
+    console.log('✅ ef and mode reach per-query batches');
+
+    // minScore is checked like search()'s: NaN would silently empty every list
+    const cut = store.searchBatch(queries, nq, k, { minScore: 0.1 });
+    cut.forEach((results) => results.forEach((r) => {
+        if (r.score < 0.1) throw new Error(`Score ${r.score} is under minScore`);
+    }));
+    for (const minScore of [undefined, 'high']) {
+        let rejected = false;
+        try {
+            store.searchBatch(queries, nq, k, { minScore });
+        } catch (e) {
+            rejected = e instanceof TypeError;
+        }
+        if (!rejected) {
+            throw new Error(`minScore ${minScore} was not rejected with a TypeError`);
+        }
+    }
+    console.log('✅ minScore applied, non-numbers rejected');
+
+    console.log('\n✅ searchBatch tests passed');
+} catch (error) {
+    console.error('❌ Error:', error);
+    process.exitCode = 1;
+}
@@ -0,0 +1,52 @@
+const { VectorStore } = require('../index');
+const path = require('path');
+const os = require('os');
+const fs = require('fs');
+
+console.log('🧪 Testing Snapshot Save / Open');
+console.log('===============================\n');
+
+const dim = 3;
+const snapshotPath = path.join(os.tmpdir(), `nvs-snapshot-${process.pid}.bin`);
+
+try {
+    const store = new VectorStore(dim);
+    store.addDocument({ id: 'a', text: 'first', metadata: { embedding: [3, 4, 0] } });
+    store.addDocument({ id: 'b', text: 'second', metadata: { embedding: [0, 0, 1] } });
+    store.finalize();
+
+    store.save(snapshotPath);
+    console.log(`✅ Saved ${store.size()} documents to ${snapshotPath}`);
+
+    const reopened = new VectorStore(dim);
+    reopened.openSnapshot(snapshotPath);
+    console.log(`✅ Opened snapshot: size=${reopened.size()}, finalized=${reopened.isFinalized()}`);
+
+    if (reopened.size() !== store.size() || !reopened.isFinalized()) {
+        throw new Error('Reopened store does not match');
+    }
+
+    const results = reopened.search(new Float32Array([3, 4, 0]), 1);
+    if (results[0].id !== 'a' || Math.abs(results[0].score - 1.0) > 1e-5) {
+        throw new Error(`Unexpected search result: ${JSON.stringify(results[0])}`);
+    }
+    console.log('✅ Search on reopened store:', results[0].id, results[0].score.toFixed(4));
+
+    let threw = false;
+    try {
+        new VectorStore(dim + 1).openSnapshot(snapshotPath);
+    } catch (e) {
+        threw = true;
+    }
+    if (!threw) {
+        throw new Error('Dimension mismatch was not rejected');
+    }
+    console.log('✅ Dimension mismatch rejected');
+
+    console.log('\n✅ Snapshot tests passed');
+} catch (error) {
+    console.error('❌ Error:', error);
+    process.exitCode = 1;
+} finally {
+    fs.rmSync(snapshotPath, { force: true });
+}
@@ -0,0 +1,57 @@
+const { VectorStore } = require('../index');
+
+console.log('🧪 Testing store statistics');
+console.log('==========================\n');
+
+const dim = 16;
+const randomEmbedding = () => Array.from({ length: dim }, () => Math.random() * 2 - 1);
+
+async function main() {
+    const store = new VectorStore(dim);
+    for (let i = 0; i < 500; i++) {
+        store.addDocument({ id: `doc-${i}`, text: `Document ${i}`, metadata: { embedding: randomEmbedding() } });
+    }
+    let threw = false;
+    try {
+        store.addDocument({ id: 'bad', text: 'No embedding', metadata: {} });
+    } catch (e) {
+        threw = true;
+    }
+    if (!threw) {
+        throw new Error('a document without an embedding should be rejected');
+    }
+    store.finalize();
+
+    const query = new Float32Array(randomEmbedding());
+    for (let i = 0; i < 20; i++) store.search(query, 5);
+    await store.searchAsync(query, 5);
+
+    const stats = store.stats();
+    if (!stats.enabled) {
+        console.log('✅ built with nvs_stats=false: nothing to check');
+        return;
+    }
+    if (stats.load.documentsAdded !== 500 || stats.load.documentsRejected !== 1) {
+        throw new Error(`unexpected document counts: ${JSON.stringify(stats.load)}`);
+    }
+    if (Object.values(stats.load.rejectedByError).reduce((a, b) => a + b, 0) !== 1) {
+        throw new Error('rejections should be broken down by error');
+    }
+    if (stats.search.count !== 21 || stats.search.latencyHistogram.reduce((a, b) => a + b, 0) !== 21) {
+        throw new Error(`expected 21 search samples: ${JSON.stringify(stats.search)}`);
+    }
+    if (stats.search.rowsScanned !== 21 * 500) {
+        throw new Error(`expected every row scanned per search, got ${stats.search.rowsScanned}`);
+    }
+    if (stats.memory.arenaUsedBytes <= 0 || stats.memory.arenaUsedBytes > stats.memory.arenaReservedBytes) {
+        throw new Error(`arena accounting is off: ${JSON.stringify(stats.memory)}`);
+    }
+    console.log('✅ stats:', JSON.stringify(stats.load), JSON.stringify(stats.memory));
+
+    console.log('\n✅ All stats tests passed');
+}
+
+main().catch((err) => {
+    console.error('❌', err);
+    process.exit(1);
+});